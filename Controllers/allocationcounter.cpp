@@ -0,0 +1,75 @@
+#include "allocationcounter.h"
+
+/*Replacement global allocation functions that count calls per thread. The array and nothrow
+ * forms of the standard library forward to the two replaced here, so they are counted too.
+ * Compiled to nothing unless CAR_DASHBOARD_COUNT_ALLOCATIONS is defined.
+ */
+
+#ifdef CAR_DASHBOARD_COUNT_ALLOCATIONS
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+thread_local quint64 t_allocations = 0;
+}
+
+quint64 AllocationCounter::threadAllocations()
+{
+    return t_allocations;
+}
+
+void *operator new(std::size_t size)
+{
+    t_allocations++;
+    if (void *memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment)
+{
+    t_allocations++;
+
+    // aligned_alloc() wants a size that is a multiple of the alignment
+    const std::size_t align = std::size_t(alignment);
+    const std::size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+#ifdef _WIN32
+    if (void *memory = _aligned_malloc(rounded, align))
+#else
+    if (void *memory = std::aligned_alloc(align, rounded))
+#endif
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *memory, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+    operator delete(memory, std::align_val_t{});
+}
+
+#endif // CAR_DASHBOARD_COUNT_ALLOCATIONS
@@ -0,0 +1,26 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Per-thread count of global operator new calls, for checking the ingest path stays allocation-free
+ *
+ * Only built into debug builds (CAR_DASHBOARD_COUNT_ALLOCATIONS, set by CMake for the Debug
+ * configuration), where the global operator new and delete are replaced by counting versions.
+ * In other builds threadAllocations() is always 0 and costs nothing.
+ *
+ * Take the difference of two readings on the same thread to count the allocations in between.
+ */
+namespace AllocationCounter
+{
+#ifdef CAR_DASHBOARD_COUNT_ALLOCATIONS
+constexpr bool Enabled = true;
+quint64 threadAllocations();
+#else
+constexpr bool Enabled = false;
+inline quint64 threadAllocations() { return 0; }
+#endif
+} // namespace AllocationCounter
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,165 @@
+#include "batchdatagramreader.h"
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+/*A thin wrapper around recvmmsg(). The payload buffer, the scatter/gather vectors and the
+ * message headers are allocated once, so a batch read touches no allocator at all.
+ *  The receiver worker owns one instance and drives it from a QSocketNotifier.
+ */
+
+struct BatchDatagramReader::Headers
+{
+#ifdef Q_OS_LINUX
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> vectors;
+#endif
+};
+
+BatchDatagramReader::BatchDatagramReader(int batchSize, int slotSize)
+    : m_batchSize(qMax(1, batchSize)),
+      m_slotSize(qMax(1, slotSize)),
+      m_fd(-1),
+      m_truncated(0),
+      m_buffer(size_t(m_batchSize) * size_t(m_slotSize)),
+      m_sizes(m_batchSize, 0),
+      m_headers(new Headers)
+{
+#ifdef Q_OS_LINUX
+    m_headers->messages.resize(m_batchSize);
+    m_headers->vectors.resize(m_batchSize);
+
+    // Point every message header at its own slot once; recvmmsg() only rewrites msg_len and msg_flags
+    for (int i = 0; i < m_batchSize; ++i)
+    {
+        m_headers->vectors[i].iov_base = m_buffer.data() + size_t(i) * size_t(m_slotSize);
+        m_headers->vectors[i].iov_len = size_t(m_slotSize);
+
+        std::memset(&m_headers->messages[i], 0, sizeof(mmsghdr));
+        m_headers->messages[i].msg_hdr.msg_iov = &m_headers->vectors[i];
+        m_headers->messages[i].msg_hdr.msg_iovlen = 1;
+    }
+#endif
+}
+
+BatchDatagramReader::~BatchDatagramReader()
+{
+    close();
+}
+
+bool BatchDatagramReader::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool BatchDatagramReader::open(quint16 port, QString *errorString)
+{
+    close();
+
+#ifdef Q_OS_LINUX
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+    {
+        m_errorString = QString("socket() failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        if (errorString)
+            *errorString = m_errorString;
+        return false;
+    }
+
+    // Match QUdpSocket::bind() defaults closely enough to coexist with other listeners on the bench
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // A larger kernel queue absorbs bursts while a batch is being dispatched
+    int receiveBuffer = 4 * 1024 * 1024;
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+    {
+        m_errorString = QString("bind() failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        ::close(fd);
+        if (errorString)
+            *errorString = m_errorString;
+        return false;
+    }
+
+    m_fd = fd;
+    m_errorString.clear();
+    return true;
+#else
+    Q_UNUSED(port);
+    m_errorString = QStringLiteral("Batched receive is not supported on this platform");
+    if (errorString)
+        *errorString = m_errorString;
+    return false;
+#endif
+}
+
+void BatchDatagramReader::close()
+{
+#ifdef Q_OS_LINUX
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+    }
+#endif
+    m_fd = -1;
+}
+
+int BatchDatagramReader::readBatch()
+{
+    m_truncated = 0;
+
+#ifdef Q_OS_LINUX
+    if (m_fd < 0)
+    {
+        return -1;
+    }
+
+    int count;
+    do
+    {
+        count = ::recvmmsg(m_fd, m_headers->messages.data(), unsigned(m_batchSize), MSG_DONTWAIT, nullptr);
+    } while (count < 0 && errno == EINTR);
+
+    if (count < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return 0;
+        }
+
+        m_errorString = QString("recvmmsg() failed: %1").arg(QString::fromLocal8Bit(std::strerror(errno)));
+        return -1;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        m_sizes[i] = int(qMin<unsigned>(m_headers->messages[i].msg_len, unsigned(m_slotSize)));
+        if (m_headers->messages[i].msg_hdr.msg_flags & MSG_TRUNC)
+        {
+            m_truncated++;
+        }
+    }
+
+    return count;
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,86 @@
+#ifndef BATCHDATAGRAMREADER_H
+#define BATCHDATAGRAMREADER_H
+
+#include <QtGlobal>
+#include <QString>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief The BatchDatagramReader class drains several UDP datagrams per system call
+ *
+ * On Linux this wraps recvmmsg() on a non-blocking socket and reads directly into
+ * preallocated, fixed-size slots, so no datagram object or payload copy is created
+ * by the receive itself. On other platforms isSupported() returns false and the
+ * caller keeps using QUdpSocket.
+ */
+class BatchDatagramReader
+{
+public:
+    static constexpr int DefaultBatchSize = 64;
+    static constexpr int DefaultSlotSize = 2048;
+
+    explicit BatchDatagramReader(int batchSize = DefaultBatchSize, int slotSize = DefaultSlotSize);
+    ~BatchDatagramReader();
+
+    BatchDatagramReader(const BatchDatagramReader &) = delete;
+    BatchDatagramReader &operator=(const BatchDatagramReader &) = delete;
+
+    /**
+     * @brief Whether batched receive is available on this platform
+     */
+    static bool isSupported();
+
+    /**
+     * @brief Open a non-blocking UDP socket bound to the given port on all interfaces
+     * @param port The UDP port to listen on
+     * @param errorString Receives a description of the failure, if any
+     * @return True if the socket is ready for readBatch()
+     */
+    bool open(quint16 port, QString *errorString = nullptr);
+
+    /**
+     * @brief Close the socket. Safe to call when not open.
+     */
+    void close();
+
+    bool isOpen() const { return m_fd >= 0; }
+    qintptr socketDescriptor() const { return m_fd; }
+
+    /**
+     * @brief Receive up to batchSize() datagrams with a single system call
+     * @return The number of datagrams read, 0 if none were pending, -1 on error
+     */
+    int readBatch();
+
+    int batchSize() const { return m_batchSize; }
+    int slotSize() const { return m_slotSize; }
+
+    /**
+     * @brief Access a datagram of the last batch. Valid until the next readBatch().
+     */
+    const char *data(int index) const { return m_buffer.data() + index * m_slotSize; }
+    int size(int index) const { return m_sizes[index]; }
+
+    /**
+     * @brief Number of datagrams in the last batch that did not fit their slot
+     */
+    int truncatedCount() const { return m_truncated; }
+
+    QString errorString() const { return m_errorString; }
+
+private:
+    int m_batchSize;
+    int m_slotSize;
+    int m_fd;
+    int m_truncated;
+    QString m_errorString;
+
+    std::vector<char> m_buffer; // batchSize * slotSize contiguous bytes
+    std::vector<int> m_sizes;
+
+    struct Headers; // Platform message headers, built once in the constructor
+    std::unique_ptr<Headers> m_headers;
+};
+
+#endif // BATCHDATAGRAMREADER_H
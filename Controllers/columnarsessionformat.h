@@ -0,0 +1,252 @@
+#ifndef COLUMNARSESSIONFORMAT_H
+#define COLUMNARSESSIONFORMAT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include <cstring>
+#include <vector>
+
+/**
+ * @brief The ColumnarSessionFormat class describes the chunked, column-oriented session export
+ *
+ * SessionExporter turns a session log into one row per decoded frame and writes the rows in
+ * chunks. Inside a chunk each column is stored on its own, so a tool that needs one channel
+ * reads only that channel's bytes, and the footer keeps every column chunk's minimum and
+ * maximum, so whole chunks can be skipped (e.g. by time range) without touching their data.
+ * All multi-byte fields are little-endian and unaligned. Version 1 file header:
+ *
+ * | Offset | Type  | Field                                           |
+ * |--------|-------|-------------------------------------------------|
+ * | 0      | u8[8] | magic ("CDCOLUMN")                              |
+ * | 8      | u16   | format version                                  |
+ * | 10     | u16   | header size in bytes, including the schema      |
+ * | 12     | u32   | flags (0)                                       |
+ * | 16     | i64   | wall clock at start of the session (ms)         |
+ * | 24     | i64   | host monotonic clock at start of the session    |
+ * | 32     | u16   | column count                                    |
+ * | 34     | u16   | session name length                             |
+ * | 36     | u8[]  | session name (UTF-8)                            |
+ * | ...    |       | per column: u8 ColumnType, u8 name length, name |
+ *
+ * The header is followed by the chunks. A chunk is its columns' data, one column after the
+ * other in schema order. With the Plain encoding a column chunk is a packed array of the
+ * column type; the compressed encodings are described in ColumnCodec, and every column chunk
+ * decodes on its own. The footer holds one entry per chunk:
+ *
+ * | Offset | Type  | Field                                               |
+ * |--------|-------|-----------------------------------------------------|
+ * | 0      | u32   | row count                                           |
+ * | 4      | u32   | reserved (0)                                        |
+ * | 8      |       | per column, ColumnEntrySize bytes:                  |
+ * |        | i64   | file offset of the column chunk                     |
+ * |        | u32   | size in bytes                                       |
+ * |        | u8    | Encoding                                            |
+ * |        | u8[3] | reserved (0)                                        |
+ * |        | 8 B   | minimum, as i64 (integer types), u64 or f64 (float) |
+ * |        | 8 B   | maximum, in the same representation                 |
+ *
+ * The file ends in a TrailerSize trailer: u32 chunk count, u32 reserved, i64 footer offset and
+ * the magic "CDCOLEND". Readers start from the trailer. Floating-point minima and maxima ignore
+ * NaNs; a chunk holding only NaNs reports NaN for both.
+ */
+class ColumnarSessionFormat
+{
+public:
+    static constexpr char Magic[8] = {'C', 'D', 'C', 'O', 'L', 'U', 'M', 'N'};
+    static constexpr char TrailerMagic[8] = {'C', 'D', 'C', 'O', 'L', 'E', 'N', 'D'};
+    static constexpr quint16 Version = 1;
+    static constexpr int FixedHeaderSize = 36;
+    static constexpr int MaximumNameSize = 1024;
+    static constexpr int ChunkEntryHeaderSize = 8;
+    static constexpr int ColumnEntrySize = 32;
+    static constexpr int TrailerSize = 24;
+    static constexpr const char *FileSuffix = ".cdcol";
+
+    enum ColumnType : quint8
+    {
+        Int32 = 1,
+        Int64 = 2,
+        UInt64 = 3,
+        Float32 = 4,
+        Float64 = 5
+    };
+
+    enum Encoding : quint8
+    {
+        Plain = 0,       // Packed little-endian values
+        DeltaVarint = 1, // Integer columns, see ColumnCodec
+        GorillaXor = 2   // Floating-point columns, see ColumnCodec
+    };
+
+    struct Column
+    {
+        QByteArray name;
+        ColumnType type = Int32;
+    };
+
+    struct Header
+    {
+        qint64 startWallClockMs = 0;
+        qint64 startMonotonicUs = 0;
+        QString sessionName;
+        std::vector<Column> columns;
+    };
+
+    struct ColumnChunk
+    {
+        qint64 offset = 0;
+        quint32 size = 0;
+        Encoding encoding = Plain;
+        quint64 minimum = 0; // Bit pattern of the 8-byte minimum
+        quint64 maximum = 0;
+    };
+
+    struct Trailer
+    {
+        quint32 chunkCount = 0;
+        qint64 footerOffset = 0;
+    };
+
+    /**
+     * @brief Bytes per value of a column type; 0 for an unknown type
+     */
+    static int typeSize(ColumnType type)
+    {
+        switch (type)
+        {
+        case Int32:
+        case Float32:
+            return 4;
+        case Int64:
+        case UInt64:
+        case Float64:
+            return 8;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Serialize the file header and schema; names longer than MaximumNameSize bytes are cut
+     */
+    static QByteArray encodeHeader(const Header &header)
+    {
+        const QByteArray name = header.sessionName.toUtf8().left(MaximumNameSize);
+        QByteArray out(FixedHeaderSize, Qt::Uninitialized);
+        char *data = out.data();
+
+        std::memcpy(data, Magic, sizeof(Magic));
+        qToLittleEndian<quint16>(Version, data + 8);
+        qToLittleEndian<quint32>(0, data + 12);
+        qToLittleEndian<qint64>(header.startWallClockMs, data + 16);
+        qToLittleEndian<qint64>(header.startMonotonicUs, data + 24);
+        qToLittleEndian<quint16>(quint16(header.columns.size()), data + 32);
+        qToLittleEndian<quint16>(quint16(name.size()), data + 34);
+        out.append(name);
+
+        for (const Column &column : header.columns)
+        {
+            const QByteArray columnName = column.name.left(255);
+            out.append(char(column.type));
+            out.append(char(columnName.size()));
+            out.append(columnName);
+        }
+
+        qToLittleEndian<quint16>(quint16(out.size()), out.data() + 10);
+        return out;
+    }
+
+    /**
+     * @brief Parse the file header and schema from the start of an export
+     * @param headerSize Receives the offset of the first chunk
+     * @return False if @p data does not start with a complete header of a known version
+     */
+    static bool decodeHeader(const char *data, qsizetype size, Header &header, int &headerSize)
+    {
+        if (size < FixedHeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0
+            || qFromLittleEndian<quint16>(data + 8) != Version)
+        {
+            return false;
+        }
+
+        headerSize = qFromLittleEndian<quint16>(data + 10);
+        const int columnCount = qFromLittleEndian<quint16>(data + 32);
+        const int nameSize = qFromLittleEndian<quint16>(data + 34);
+        if (headerSize < FixedHeaderSize + nameSize || size < headerSize)
+        {
+            return false;
+        }
+
+        header.startWallClockMs = qFromLittleEndian<qint64>(data + 16);
+        header.startMonotonicUs = qFromLittleEndian<qint64>(data + 24);
+        header.sessionName = QString::fromUtf8(data + FixedHeaderSize, nameSize);
+        header.columns.clear();
+
+        int at = FixedHeaderSize + nameSize;
+        for (int i = 0; i < columnCount; ++i)
+        {
+            if (at + 2 > headerSize || at + 2 + quint8(data[at + 1]) > headerSize)
+            {
+                return false;
+            }
+
+            Column column;
+            column.type = ColumnType(quint8(data[at]));
+            column.name = QByteArray(data + at + 2, quint8(data[at + 1]));
+            header.columns.push_back(column);
+            at += 2 + quint8(data[at + 1]);
+        }
+        return true;
+    }
+
+    static void encodeColumnChunk(const ColumnChunk &chunk, char *out)
+    {
+        qToLittleEndian<qint64>(chunk.offset, out);
+        qToLittleEndian<quint32>(chunk.size, out + 8);
+        out[12] = char(chunk.encoding);
+        out[13] = out[14] = out[15] = 0;
+        qToLittleEndian<quint64>(chunk.minimum, out + 16);
+        qToLittleEndian<quint64>(chunk.maximum, out + 24);
+    }
+
+    static ColumnChunk decodeColumnChunk(const char *data)
+    {
+        ColumnChunk chunk;
+        chunk.offset = qFromLittleEndian<qint64>(data);
+        chunk.size = qFromLittleEndian<quint32>(data + 8);
+        chunk.encoding = Encoding(quint8(data[12]));
+        chunk.minimum = qFromLittleEndian<quint64>(data + 16);
+        chunk.maximum = qFromLittleEndian<quint64>(data + 24);
+        return chunk;
+    }
+
+    static QByteArray encodeTrailer(const Trailer &trailer)
+    {
+        QByteArray out(TrailerSize, Qt::Uninitialized);
+        char *data = out.data();
+
+        qToLittleEndian<quint32>(trailer.chunkCount, data);
+        qToLittleEndian<quint32>(0, data + 4);
+        qToLittleEndian<qint64>(trailer.footerOffset, data + 8);
+        std::memcpy(data + 16, TrailerMagic, sizeof(TrailerMagic));
+        return out;
+    }
+
+    /**
+     * @brief Parse the last TrailerSize bytes of an export
+     * @return False if they are not a trailer, e.g. because the export was cut short
+     */
+    static bool decodeTrailer(const char *data, Trailer &trailer)
+    {
+        if (std::memcmp(data + 16, TrailerMagic, sizeof(TrailerMagic)) != 0)
+        {
+            return false;
+        }
+
+        trailer.chunkCount = qFromLittleEndian<quint32>(data);
+        trailer.footerOffset = qFromLittleEndian<qint64>(data + 8);
+        return true;
+    }
+};
+
+#endif // COLUMNARSESSIONFORMAT_H
@@ -0,0 +1,361 @@
+#include "columncodec.h"
+#include <bit>
+#include <cstring>
+
+/*ColumnCodec
+ * Delta/zig-zag/varint and Gorilla XOR coding of column chunks. Encoders write through a raw
+ * pointer into a buffer sized for the worst case and trim it at the end, so the per-value cost
+ * is a few shifts and stores; decoders check every read against the end of the chunk.
+ */
+
+namespace
+{
+template <typename T>
+T readValue(const char *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+// Bit stream, most significant bit first; at most 56 bits per call
+class BitWriter
+{
+public:
+    explicit BitWriter(char *out) : m_out(out), m_buffer(0), m_bits(0) {}
+
+    void write(quint64 value, int count)
+    {
+        m_buffer = (m_buffer << count) | (value & (~quint64(0) >> (64 - count)));
+        m_bits += count;
+        while (m_bits >= 8)
+        {
+            m_bits -= 8;
+            *m_out++ = char(m_buffer >> m_bits);
+        }
+    }
+
+    // Any width up to 64 bits
+    void writeWide(quint64 value, int count)
+    {
+        if (count > 32)
+        {
+            write(value >> 32, count - 32);
+            count = 32;
+        }
+        write(value, count);
+    }
+
+    char *finish()
+    {
+        if (m_bits > 0)
+        {
+            *m_out++ = char(m_buffer << (8 - m_bits));
+            m_bits = 0;
+        }
+        return m_out;
+    }
+
+private:
+    char *m_out;
+    quint64 m_buffer;
+    int m_bits;
+};
+
+class BitReader
+{
+public:
+    BitReader(const char *data, const char *end)
+        : m_in(reinterpret_cast<const uchar *>(data)),
+          m_end(reinterpret_cast<const uchar *>(end)),
+          m_buffer(0),
+          m_bits(0)
+    {
+    }
+
+    bool read(int count, quint64 &value)
+    {
+        while (m_bits < count)
+        {
+            if (m_in == m_end)
+            {
+                return false;
+            }
+            m_buffer = (m_buffer << 8) | *m_in++;
+            m_bits += 8;
+        }
+
+        m_bits -= count;
+        value = (m_buffer >> m_bits) & (~quint64(0) >> (64 - count));
+        return true;
+    }
+
+    bool readWide(int count, quint64 &value)
+    {
+        quint64 high = 0;
+        if (count > 32)
+        {
+            if (!read(count - 32, high))
+            {
+                return false;
+            }
+            count = 32;
+        }
+
+        quint64 low = 0;
+        if (!read(count, low))
+        {
+            return false;
+        }
+        value = (high << count) | low;
+        return true;
+    }
+
+    // Only the padding of the last byte may be left over
+    bool atEnd() const { return m_in == m_end && m_bits < 8; }
+
+private:
+    const uchar *m_in;
+    const uchar *m_end;
+    quint64 m_buffer;
+    int m_bits;
+};
+
+template <typename T>
+char *encodeDeltaVarint(const char *values, int count, char *out)
+{
+    quint64 previous = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        // Signed types are widened with their sign, so the difference is exact in 64 bits
+        const quint64 value = quint64(readValue<T>(values + qsizetype(i) * qsizetype(sizeof(T))));
+        const quint64 delta = value - previous;
+        previous = value;
+
+        quint64 zigzag = (delta << 1) ^ quint64(qint64(delta) >> 63);
+        while (zigzag >= 0x80)
+        {
+            *out++ = char(zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        *out++ = char(zigzag);
+    }
+    return out;
+}
+
+template <typename T>
+bool decodeDeltaVarint(const char *data, qsizetype size, int count, char *values)
+{
+    const uchar *in = reinterpret_cast<const uchar *>(data);
+    const uchar *end = in + size;
+    quint64 previous = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        quint64 zigzag = 0;
+        for (int shift = 0;; shift += 7)
+        {
+            if (in == end || shift > 63)
+            {
+                return false;
+            }
+
+            const uchar byte = *in++;
+            zigzag |= quint64(byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+
+        previous += (zigzag >> 1) ^ (0 - (zigzag & 1));
+        qToLittleEndian<T>(T(previous), values + qsizetype(i) * qsizetype(sizeof(T)));
+    }
+    return in == end;
+}
+
+// Bits and the widths of the leading-zero count and run length fields, per float size
+template <typename Word>
+struct XorLayout
+{
+    static constexpr int Bits = int(sizeof(Word)) * 8;
+    static constexpr int FieldBits = sizeof(Word) == 4 ? 5 : 6;
+};
+
+template <typename Word>
+char *encodeXor(const char *values, int count, char *out)
+{
+    using Layout = XorLayout<Word>;
+    BitWriter writer(out);
+    Word previous = 0;
+    int windowLeading = -1; // No window until the first stored run
+    int windowTrailing = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        const Word value = readValue<Word>(values + qsizetype(i) * qsizetype(sizeof(Word)));
+        const Word x = value ^ previous;
+        previous = value;
+
+        if (x == 0)
+        {
+            writer.write(0, 1);
+            continue;
+        }
+
+        const int leading = std::countl_zero(x);
+        const int trailing = std::countr_zero(x);
+        if (windowLeading >= 0 && leading >= windowLeading && trailing >= windowTrailing)
+        {
+            // '10': the run fits the previous window
+            writer.write(0b10, 2);
+            writer.writeWide(quint64(x >> windowTrailing), Layout::Bits - windowLeading - windowTrailing);
+        }
+        else
+        {
+            // '11': a new window, then the run
+            const int length = Layout::Bits - leading - trailing;
+            writer.write(0b11, 2);
+            writer.write(quint64(leading), Layout::FieldBits);
+            writer.write(quint64(length - 1), Layout::FieldBits);
+            writer.writeWide(quint64(x >> trailing), length);
+            windowLeading = leading;
+            windowTrailing = trailing;
+        }
+    }
+    return writer.finish();
+}
+
+template <typename Word>
+bool decodeXor(const char *data, qsizetype size, int count, char *values)
+{
+    using Layout = XorLayout<Word>;
+    BitReader reader(data, data + size);
+    Word previous = 0;
+    int windowLeading = -1;
+    int windowTrailing = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        quint64 control = 0;
+        if (!reader.read(1, control))
+        {
+            return false;
+        }
+
+        if (control)
+        {
+            if (!reader.read(1, control))
+            {
+                return false;
+            }
+
+            if (control)
+            {
+                quint64 leading = 0;
+                quint64 length = 0;
+                if (!reader.read(Layout::FieldBits, leading) || !reader.read(Layout::FieldBits, length)
+                    || int(leading) + int(length) + 1 > Layout::Bits)
+                {
+                    return false;
+                }
+                windowLeading = int(leading);
+                windowTrailing = Layout::Bits - int(leading) - int(length) - 1;
+            }
+            else if (windowLeading < 0)
+            {
+                return false;
+            }
+
+            quint64 run = 0;
+            if (!reader.readWide(Layout::Bits - windowLeading - windowTrailing, run))
+            {
+                return false;
+            }
+            previous ^= Word(run << windowTrailing);
+        }
+
+        qToLittleEndian<Word>(previous, values + qsizetype(i) * qsizetype(sizeof(Word)));
+    }
+    return reader.atEnd();
+}
+} // namespace
+
+ColumnarSessionFormat::Encoding ColumnCodec::encodingFor(ColumnarSessionFormat::ColumnType type)
+{
+    switch (type)
+    {
+    case ColumnarSessionFormat::Int32:
+    case ColumnarSessionFormat::Int64:
+    case ColumnarSessionFormat::UInt64:
+        return ColumnarSessionFormat::DeltaVarint;
+    case ColumnarSessionFormat::Float32:
+    case ColumnarSessionFormat::Float64:
+        return ColumnarSessionFormat::GorillaXor;
+    }
+    return ColumnarSessionFormat::Plain;
+}
+
+void ColumnCodec::encode(ColumnarSessionFormat::ColumnType type, const char *values, int count, QByteArray &out)
+{
+    out.resize(maximumEncodedSize(count));
+    char *begin = out.data();
+    char *end = begin;
+
+    switch (type)
+    {
+    case ColumnarSessionFormat::Int32:
+        end = encodeDeltaVarint<qint32>(values, count, begin);
+        break;
+    case ColumnarSessionFormat::Int64:
+        end = encodeDeltaVarint<qint64>(values, count, begin);
+        break;
+    case ColumnarSessionFormat::UInt64:
+        end = encodeDeltaVarint<quint64>(values, count, begin);
+        break;
+    case ColumnarSessionFormat::Float32:
+        end = encodeXor<quint32>(values, count, begin);
+        break;
+    case ColumnarSessionFormat::Float64:
+        end = encodeXor<quint64>(values, count, begin);
+        break;
+    }
+
+    out.resize(end - begin);
+}
+
+bool ColumnCodec::decode(ColumnarSessionFormat::ColumnType type, ColumnarSessionFormat::Encoding encoding, const char *data,
+                         qsizetype size, int count, char *values)
+{
+    if (encoding == ColumnarSessionFormat::Plain)
+    {
+        if (size != qsizetype(count) * ColumnarSessionFormat::typeSize(type))
+        {
+            return false;
+        }
+
+        if (size > 0)
+        {
+            std::memcpy(values, data, size_t(size));
+        }
+        return true;
+    }
+
+    if (encoding != encodingFor(type))
+    {
+        return false;
+    }
+
+    switch (type)
+    {
+    case ColumnarSessionFormat::Int32:
+        return decodeDeltaVarint<qint32>(data, size, count, values);
+    case ColumnarSessionFormat::Int64:
+        return decodeDeltaVarint<qint64>(data, size, count, values);
+    case ColumnarSessionFormat::UInt64:
+        return decodeDeltaVarint<quint64>(data, size, count, values);
+    case ColumnarSessionFormat::Float32:
+        return decodeXor<quint32>(data, size, count, values);
+    case ColumnarSessionFormat::Float64:
+        return decodeXor<quint64>(data, size, count, values);
+    }
+    return false;
+}
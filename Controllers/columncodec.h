@@ -0,0 +1,50 @@
+#ifndef COLUMNCODEC_H
+#define COLUMNCODEC_H
+
+#include <QByteArray>
+#include "columnarsessionformat.h"
+
+/**
+ * @brief The ColumnCodec class compresses the column chunks of a columnar session export
+ *
+ * Telemetry channels change little from one frame to the next, and each codec exploits that:
+ *
+ * - Integer columns (DeltaVarint): each value minus the previous one, zig-zag mapped so small
+ *   negative differences stay small, then written as a LEB128 varint. A counter or a channel
+ *   that holds still costs one byte per value.
+ * - Floating-point columns (GorillaXor): each value's bits XORed with the previous value's, as
+ *   in Facebook's Gorilla. An unchanged value costs one bit; otherwise only the run of bits
+ *   between the XOR's leading and trailing zeros is stored, reusing the previous run's window
+ *   when it fits.
+ *
+ * Every column chunk is encoded on its own, starting from a zero previous value, so a chunk can
+ * be decoded without its predecessors and the export stays seekable chunk by chunk. The row
+ * count is not stored; it comes from the chunk's footer entry.
+ */
+class ColumnCodec
+{
+public:
+    /**
+     * @brief Worst-case encoded size of @p count values, for sizing buffers
+     */
+    static qsizetype maximumEncodedSize(int count) { return qsizetype(count) * 10 + 8; }
+
+    /**
+     * @brief The compressed encoding used for columns of @p type
+     */
+    static ColumnarSessionFormat::Encoding encodingFor(ColumnarSessionFormat::ColumnType type);
+
+    /**
+     * @brief Encode @p count packed little-endian values of @p type, replacing the contents of @p out
+     */
+    static void encode(ColumnarSessionFormat::ColumnType type, const char *values, int count, QByteArray &out);
+
+    /**
+     * @brief Decode a column chunk into @p count packed little-endian values at @p values
+     * @return False if @p data is not a complete chunk of that many values in @p encoding
+     */
+    static bool decode(ColumnarSessionFormat::ColumnType type, ColumnarSessionFormat::Encoding encoding, const char *data,
+                       qsizetype size, int count, char *values);
+};
+
+#endif // COLUMNCODEC_H
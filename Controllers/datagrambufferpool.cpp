@@ -0,0 +1,69 @@
+#include "datagrambufferpool.h"
+#include <cstring>
+
+/*Fixed block of payload buffers plus a lock-free free list, the datagram counterpart of the
+ * TelemetryFramePool. The free list has the same capacity as the block, so returning a pooled
+ * buffer can never fail.
+ */
+
+DatagramBufferPool::DatagramBufferPool(int capacity)
+    : m_capacity(qMax(1, capacity)),
+      m_storage(new char[size_t(m_capacity) * BufferSize]),
+      m_buffers(new DatagramBuffer[m_capacity]),
+      m_freeList(size_t(m_capacity)),
+      m_overflowAllocations(0)
+{
+    for (int i = 0; i < m_capacity; ++i)
+    {
+        m_buffers[i].data = m_storage.get() + size_t(i) * BufferSize;
+        m_buffers[i].capacity = BufferSize;
+        m_freeList.tryPush(&m_buffers[i]);
+    }
+}
+
+DatagramBufferPool::~DatagramBufferPool() = default;
+
+DatagramBuffer *DatagramBufferPool::acquire(int minimumSize)
+{
+    DatagramBuffer *buffer = nullptr;
+
+    if (minimumSize <= BufferSize && m_freeList.tryPop(buffer))
+    {
+        buffer->size = 0;
+        return buffer;
+    }
+
+    // Oversized or the pool is exhausted: stay correct and let the counter tell the story
+    m_overflowAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    buffer = new DatagramBuffer();
+    buffer->capacity = qMax(minimumSize, BufferSize);
+    buffer->data = new char[size_t(buffer->capacity)];
+    return buffer;
+}
+
+DatagramBuffer *DatagramBufferPool::acquireCopy(const char *data, int size)
+{
+    DatagramBuffer *buffer = acquire(size);
+    std::memcpy(buffer->data, data, size_t(size));
+    buffer->size = size;
+    return buffer;
+}
+
+void DatagramBufferPool::release(DatagramBuffer *buffer)
+{
+    if (!buffer)
+    {
+        return;
+    }
+
+    if (owns(buffer))
+    {
+        m_freeList.tryPush(buffer);
+    }
+    else
+    {
+        delete[] buffer->data;
+        delete buffer;
+    }
+}
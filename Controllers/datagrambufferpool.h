@@ -0,0 +1,73 @@
+#ifndef DATAGRAMBUFFERPOOL_H
+#define DATAGRAMBUFFERPOOL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include "mpmcqueue.h"
+
+/**
+ * @brief A raw datagram payload travelling from the receiver to a parser
+ */
+struct DatagramBuffer
+{
+    char *data = nullptr;
+    int size = 0;     // Bytes in use
+    int capacity = 0; // Bytes available at data
+};
+
+/**
+ * @brief The DatagramBufferPool class recycles datagram payload buffers between the receiver and the parsers
+ *
+ * Buffers of BufferSize bytes are preallocated in one block and handed out through a lock-free
+ * free list. The receiver fills a buffer, the parser that consumes it releases it, so steady
+ * ingestion performs no heap allocation per packet. A request larger than BufferSize, or one
+ * made while the pool is dry because the parsers fall behind, is served from the heap and
+ * counted in overflowAllocations(); release() frees such buffers again.
+ *
+ * acquire() and release() may be called from any thread.
+ */
+class DatagramBufferPool
+{
+public:
+    static constexpr int DefaultCapacity = 8192; // 16 MiB; ParserStage sizes its queues to fit
+    static constexpr int BufferSize = 2048; // Matches BatchDatagramReader::DefaultSlotSize
+
+    explicit DatagramBufferPool(int capacity = DefaultCapacity);
+    ~DatagramBufferPool();
+
+    DatagramBufferPool(const DatagramBufferPool &) = delete;
+    DatagramBufferPool &operator=(const DatagramBufferPool &) = delete;
+
+    /**
+     * @brief Take an empty buffer of at least @p minimumSize bytes
+     */
+    DatagramBuffer *acquire(int minimumSize = BufferSize);
+
+    /**
+     * @brief Take a buffer holding a copy of @p size bytes at @p data
+     */
+    DatagramBuffer *acquireCopy(const char *data, int size);
+
+    /**
+     * @brief Return a buffer obtained from acquire(). Accepts nullptr.
+     */
+    void release(DatagramBuffer *buffer);
+
+    int capacity() const { return m_capacity; }
+    quint64 overflowAllocations() const { return m_overflowAllocations.load(std::memory_order_relaxed); }
+
+private:
+    bool owns(const DatagramBuffer *buffer) const
+    {
+        return buffer >= m_buffers.get() && buffer < m_buffers.get() + m_capacity;
+    }
+
+    const int m_capacity;
+    std::unique_ptr<char[]> m_storage; // capacity * BufferSize bytes
+    std::unique_ptr<DatagramBuffer[]> m_buffers;
+    BoundedMpmcQueue<DatagramBuffer *> m_freeList;
+    std::atomic<quint64> m_overflowAllocations;
+};
+
+#endif // DATAGRAMBUFFERPOOL_H
@@ -0,0 +1,427 @@
+#include "dialgauge.h"
+#include <QMatrix4x4>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+#include <QSGVertexColorMaterial>
+#include <QVariantMap>
+#include <QtMath>
+#include <cmath>
+
+/*Scene-graph dial. The node tree is built once:
+ *  root
+ *   +- ticks: one geometry node, six vertex-coloured vertices per tick
+ *   +- shadow transform -> needle shadow (the needle offset by ShadowOffset, in faint layers)
+ *   +- needle transform -> needle (a bar along +x plus a hub disc)
+ * The needle geometry points along +x from the origin, so a value change only sets two
+ *  matrices. The Canvas gauges blurred the shadow by 5 px; a blur would need a layer and a
+ *  shader effect, so the shadow instead stacks ShadowLayers copies of the needle, each grown by
+ *  a further step of ShadowBlur, at a low alpha. Where they overlap the alpha adds up, which
+ *  gives a stepped falloff towards the edge at the cost of a few more vertices. Tick colours
+ *  are compared with the last drawn state and rewritten on change.
+ */
+
+namespace
+{
+constexpr double ShadowOffset = 2.0;
+constexpr double ShadowBlur = 5.0;
+constexpr int ShadowLayers = 4;
+constexpr int ShadowLayerAlpha = 22; // Four layers stack to about the Canvas shadow's 0.3
+constexpr int NeedleVertices = 6 + DialGauge::HubSegments * 3;
+
+class DialNode : public QSGNode
+{
+public:
+    DialNode()
+        : ticks(new QSGGeometryNode),
+          shadowTransform(new QSGTransformNode),
+          shadow(new QSGGeometryNode),
+          needleTransform(new QSGTransformNode),
+          needle(new QSGGeometryNode),
+          needleColorSet(false)
+    {
+        auto *tickGeometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        tickGeometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        ticks->setGeometry(tickGeometry);
+        ticks->setMaterial(new QSGVertexColorMaterial);
+        ticks->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        appendChildNode(ticks);
+
+        setUpNeedle(shadow, QColor(0, 0, 0, ShadowLayerAlpha));
+        shadowTransform->appendChildNode(shadow);
+        appendChildNode(shadowTransform);
+
+        setUpNeedle(needle, Qt::white);
+        needleTransform->appendChildNode(needle);
+        appendChildNode(needleTransform);
+    }
+
+    static void setUpNeedle(QSGGeometryNode *node, const QColor &color)
+    {
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        auto *material = new QSGFlatColorMaterial;
+        material->setColor(color);
+        node->setGeometry(geometry);
+        node->setMaterial(material);
+        node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+    }
+
+    QSGGeometryNode *ticks;
+    QSGTransformNode *shadowTransform;
+    QSGGeometryNode *shadow;
+    QSGTransformNode *needleTransform;
+    QSGGeometryNode *needle;
+    std::vector<signed char> active; // Drawn state per tick; -1 until first drawn
+    QColor needleColor;
+    bool needleColorSet;
+};
+
+// Writes NeedleVertices vertices and returns the first one after them
+QSGGeometry::Point2D *writeNeedle(QSGGeometry::Point2D *vertex, double length, double width, double hubRadius)
+{
+    const float halfWidth = float(width / 2.0);
+    const float tip = float(length);
+    vertex[0].set(0.0f, -halfWidth);
+    vertex[1].set(tip, -halfWidth);
+    vertex[2].set(0.0f, halfWidth);
+    vertex[3].set(tip, -halfWidth);
+    vertex[4].set(tip, halfWidth);
+    vertex[5].set(0.0f, halfWidth);
+    vertex += 6;
+
+    for (int i = 0; i < DialGauge::HubSegments; ++i)
+    {
+        const double from = 2.0 * M_PI * i / DialGauge::HubSegments;
+        const double to = 2.0 * M_PI * (i + 1) / DialGauge::HubSegments;
+        vertex[0].set(0.0f, 0.0f);
+        vertex[1].set(float(hubRadius * std::cos(from)), float(hubRadius * std::sin(from)));
+        vertex[2].set(float(hubRadius * std::cos(to)), float(hubRadius * std::sin(to)));
+        vertex += 3;
+    }
+    return vertex;
+}
+
+void buildNeedle(QSGGeometry *geometry, double length, double width, double hubRadius)
+{
+    if (length <= 0.0)
+    {
+        geometry->allocate(0);
+        return;
+    }
+
+    geometry->allocate(NeedleVertices);
+    writeNeedle(geometry->vertexDataAsPoint2D(), length, width, hubRadius);
+}
+
+void buildShadow(QSGGeometry *geometry, double length, double width, double hubRadius)
+{
+    if (length <= 0.0)
+    {
+        geometry->allocate(0);
+        return;
+    }
+
+    geometry->allocate(NeedleVertices * ShadowLayers);
+    QSGGeometry::Point2D *vertex = geometry->vertexDataAsPoint2D();
+    for (int layer = 0; layer < ShadowLayers; ++layer)
+    {
+        const double grow = ShadowBlur * layer / ShadowLayers;
+        vertex = writeNeedle(vertex, length + grow, width + 2.0 * grow, hubRadius + grow);
+    }
+}
+
+void setTickColor(QSGGeometry::ColoredPoint2D *vertex, const QColor &color)
+{
+    // QSGVertexColorMaterial expects premultiplied colours
+    const int alpha = color.alpha();
+    const uchar r = uchar(color.red() * alpha / 255);
+    const uchar g = uchar(color.green() * alpha / 255);
+    const uchar b = uchar(color.blue() * alpha / 255);
+    for (int i = 0; i < 6; ++i)
+    {
+        vertex[i].r = r;
+        vertex[i].g = g;
+        vertex[i].b = b;
+        vertex[i].a = uchar(alpha);
+    }
+}
+} // namespace
+
+DialGauge::DialGauge(QQuickItem *parent)
+    : QQuickItem(parent),
+      m_value(0.0),
+      m_minimumValue(0.0),
+      m_maximumValue(100.0),
+      m_baseline(0.0),
+      m_startAngle(-210.0),
+      m_sweepAngle(240.0),
+      m_hasPivot(false),
+      m_radius(100.0),
+      m_minorTickInterval(2.0),
+      m_majorTickInterval(10.0),
+      m_minorTickLength(9.0),
+      m_majorTickLength(18.0),
+      m_minorTickWidth(2.0),
+      m_majorTickWidth(4.0),
+      m_inactiveColor(QColor(0x80, 0x80, 0x80)),
+      m_needleLength(0.0),
+      m_needleWidth(4.0),
+      m_hubRadius(7.2),
+      m_dialDirty(true)
+{
+    setFlag(ItemHasContents, true);
+    rebuildTicks();
+}
+
+void DialGauge::setValue(double value)
+{
+    if (value == m_value)
+    {
+        return;
+    }
+
+    m_value = value;
+    update();
+    emit valueChanged();
+}
+
+void DialGauge::setDialProperty(double &member, double value)
+{
+    if (value == member)
+    {
+        return;
+    }
+
+    member = value;
+    rebuildTicks();
+    emit dialChanged();
+}
+
+QPointF DialGauge::pivot() const
+{
+    return m_hasPivot ? m_pivot : QPointF(width() / 2.0, height() / 2.0);
+}
+
+void DialGauge::setPivot(const QPointF &pivot)
+{
+    if (m_hasPivot && pivot == m_pivot)
+    {
+        return;
+    }
+
+    m_pivot = pivot;
+    m_hasPivot = true;
+    rebuildTicks();
+    emit dialChanged();
+}
+
+void DialGauge::resetPivot()
+{
+    if (!m_hasPivot)
+    {
+        return;
+    }
+
+    m_hasPivot = false;
+    rebuildTicks();
+    emit dialChanged();
+}
+
+void DialGauge::setInactiveColor(const QColor &color)
+{
+    if (color == m_inactiveColor)
+    {
+        return;
+    }
+
+    m_inactiveColor = color;
+    rebuildTicks();
+    emit dialChanged();
+}
+
+void DialGauge::setZones(const QVariantList &zones)
+{
+    if (zones == m_zones)
+    {
+        return;
+    }
+
+    m_zones = zones;
+    m_zoneColors.clear();
+    for (const QVariant &zone : zones)
+    {
+        const QVariantMap map = zone.toMap();
+        m_zoneColors.push_back(Zone{map.value(QStringLiteral("limit")).toDouble(), map.value(QStringLiteral("color")).value<QColor>()});
+    }
+
+    rebuildTicks();
+    emit dialChanged();
+}
+
+QColor DialGauge::colorAt(double value) const
+{
+    if (m_zoneColors.empty())
+    {
+        return QColor(Qt::white);
+    }
+
+    for (const Zone &zone : m_zoneColors)
+    {
+        if (value <= zone.limit)
+        {
+            return zone.color;
+        }
+    }
+    return m_zoneColors.back().color;
+}
+
+double DialGauge::angleAt(double value) const
+{
+    const double span = m_maximumValue - m_minimumValue;
+    if (span <= 0.0)
+    {
+        return m_startAngle;
+    }
+
+    const double t = (qBound(m_minimumValue, value, m_maximumValue) - m_minimumValue) / span;
+    return m_startAngle + t * m_sweepAngle;
+}
+
+QPointF DialGauge::pointAt(double value, double distance) const
+{
+    const double angle = qDegreesToRadians(angleAt(value));
+    return pivot() + QPointF(distance * std::cos(angle), distance * std::sin(angle));
+}
+
+bool DialGauge::isActive(double tickValue) const
+{
+    // Lit from the baseline towards the value, on either side of it
+    return tickValue >= m_baseline ? tickValue <= m_value : tickValue > m_value;
+}
+
+void DialGauge::rebuildTicks()
+{
+    m_ticks.clear();
+
+    if (m_minorTickInterval > 0.0 && m_maximumValue > m_minimumValue)
+    {
+        const int steps = int(std::floor((m_maximumValue - m_minimumValue) / m_minorTickInterval + 1e-6));
+        m_ticks.reserve(size_t(steps) + 1);
+
+        for (int i = 0; i <= steps; ++i)
+        {
+            const double value = m_minimumValue + i * m_minorTickInterval;
+            const double majorSteps = m_majorTickInterval > 0.0 ? value / m_majorTickInterval : 0.5;
+            const bool major = std::abs(majorSteps - std::round(majorSteps)) < 1e-3;
+            m_ticks.push_back(Tick{value, major, colorAt(value)});
+        }
+    }
+
+    m_dialDirty = true;
+    update();
+}
+
+QSGNode *DialGauge::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto *node = static_cast<DialNode *>(oldNode);
+    if (!node)
+    {
+        node = new DialNode;
+        m_dialDirty = true;
+    }
+
+    const QPointF center = pivot();
+    QSGGeometry *tickGeometry = node->ticks->geometry();
+
+    if (m_dialDirty)
+    {
+        tickGeometry->allocate(int(m_ticks.size()) * 6);
+        QSGGeometry::ColoredPoint2D *vertex = tickGeometry->vertexDataAsColoredPoint2D();
+
+        for (const Tick &tick : m_ticks)
+        {
+            // A quad from the rim inwards, centred on the tick's ray
+            const double angle = qDegreesToRadians(angleAt(tick.value));
+            const QPointF along(std::cos(angle), std::sin(angle));
+            const QPointF across(-along.y(), along.x());
+            const double length = tick.major ? m_majorTickLength : m_minorTickLength;
+            const QPointF halfWidth = across * ((tick.major ? m_majorTickWidth : m_minorTickWidth) / 2.0);
+            const QPointF outer = center + along * m_radius;
+            const QPointF inner = center + along * (m_radius - length);
+
+            const QPointF corners[6] = {outer - halfWidth, outer + halfWidth, inner - halfWidth,
+                                        outer + halfWidth, inner + halfWidth, inner - halfWidth};
+            for (int i = 0; i < 6; ++i)
+            {
+                vertex[i].x = float(corners[i].x());
+                vertex[i].y = float(corners[i].y());
+            }
+            vertex += 6;
+        }
+        node->active.assign(m_ticks.size(), -1);
+
+        buildNeedle(node->needle->geometry(), m_needleLength, m_needleWidth, m_hubRadius);
+        buildShadow(node->shadow->geometry(), m_needleLength, m_needleWidth, m_hubRadius);
+        node->needle->markDirty(QSGNode::DirtyGeometry);
+        node->shadow->markDirty(QSGNode::DirtyGeometry);
+        node->needleColorSet = false;
+        m_dialDirty = false;
+    }
+
+    // Recolour only the ticks the value crossed since the last frame
+    bool recoloured = false;
+    QSGGeometry::ColoredPoint2D *vertices = tickGeometry->vertexDataAsColoredPoint2D();
+    for (size_t i = 0; i < m_ticks.size(); ++i)
+    {
+        const signed char active = isActive(m_ticks[i].value) ? 1 : 0;
+        if (active != node->active[i])
+        {
+            node->active[i] = active;
+            setTickColor(vertices + i * 6, active ? m_ticks[i].activeColor : m_inactiveColor);
+            recoloured = true;
+        }
+    }
+    if (recoloured)
+    {
+        node->ticks->markDirty(QSGNode::DirtyGeometry);
+    }
+
+    if (m_needleLength > 0.0)
+    {
+        const double angle = angleAt(m_value);
+
+        QMatrix4x4 needleMatrix;
+        needleMatrix.translate(float(center.x()), float(center.y()));
+        needleMatrix.rotate(float(angle), 0.0f, 0.0f, 1.0f);
+        node->needleTransform->setMatrix(needleMatrix);
+
+        QMatrix4x4 shadowMatrix;
+        shadowMatrix.translate(float(center.x() + ShadowOffset), float(center.y() + ShadowOffset));
+        shadowMatrix.rotate(float(angle), 0.0f, 0.0f, 1.0f);
+        node->shadowTransform->setMatrix(shadowMatrix);
+
+        const QColor color = colorAt(m_value);
+        if (!node->needleColorSet || color != node->needleColor)
+        {
+            static_cast<QSGFlatColorMaterial *>(node->needle->material())->setColor(color);
+            node->needle->markDirty(QSGNode::DirtyMaterial);
+            node->needleColor = color;
+            node->needleColorSet = true;
+        }
+    }
+
+    return node;
+}
+
+void DialGauge::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (!m_hasPivot && newGeometry.size() != oldGeometry.size())
+    {
+        // The default pivot is the center
+        m_dialDirty = true;
+        update();
+        emit dialChanged();
+    }
+}
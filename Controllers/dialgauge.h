@@ -0,0 +1,165 @@
+#ifndef DIALGAUGE_H
+#define DIALGAUGE_H
+
+#include <QColor>
+#include <QPointF>
+#include <QQuickItem>
+#include <QVariantList>
+#include <vector>
+
+/**
+ * @brief The DialGauge class draws a tick dial with an optional needle in the scene graph
+ *
+ * The tick geometry is built once per layout change: one quad per tick with vertex colours.
+ * Moving the value only replaces the needle's transform; tick colours are rewritten only when
+ * the value crosses a tick, and the needle colour only when it enters another zone, so an
+ * update never rasterizes or uploads a texture the way a Canvas repaint does.
+ *
+ * Angles are in degrees, clockwise from the positive x axis like Canvas arcs; the dial spans
+ * sweepAngle degrees from startAngle around @c pivot (the item center unless set). Ticks
+ * between @c baseline and the value are drawn in the colour of their zone, the others in
+ * inactiveColor. @c zones is a list of { limit, color } maps in ascending order: a value
+ * takes the colour of the first zone whose limit it does not exceed, or of the last zone.
+ * Labels are left to QML; pointAt() and colorAt() place and colour them.
+ */
+class DialGauge : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(double value READ value WRITE setValue NOTIFY valueChanged)
+    Q_PROPERTY(double minimumValue READ minimumValue WRITE setMinimumValue NOTIFY dialChanged)
+    Q_PROPERTY(double maximumValue READ maximumValue WRITE setMaximumValue NOTIFY dialChanged)
+    Q_PROPERTY(double baseline READ baseline WRITE setBaseline NOTIFY dialChanged)
+    Q_PROPERTY(double startAngle READ startAngle WRITE setStartAngle NOTIFY dialChanged)
+    Q_PROPERTY(double sweepAngle READ sweepAngle WRITE setSweepAngle NOTIFY dialChanged)
+    Q_PROPERTY(QPointF pivot READ pivot WRITE setPivot RESET resetPivot NOTIFY dialChanged)
+    Q_PROPERTY(double radius READ radius WRITE setRadius NOTIFY dialChanged)
+    Q_PROPERTY(double minorTickInterval READ minorTickInterval WRITE setMinorTickInterval NOTIFY dialChanged)
+    Q_PROPERTY(double majorTickInterval READ majorTickInterval WRITE setMajorTickInterval NOTIFY dialChanged)
+    Q_PROPERTY(double minorTickLength READ minorTickLength WRITE setMinorTickLength NOTIFY dialChanged)
+    Q_PROPERTY(double majorTickLength READ majorTickLength WRITE setMajorTickLength NOTIFY dialChanged)
+    Q_PROPERTY(double minorTickWidth READ minorTickWidth WRITE setMinorTickWidth NOTIFY dialChanged)
+    Q_PROPERTY(double majorTickWidth READ majorTickWidth WRITE setMajorTickWidth NOTIFY dialChanged)
+    Q_PROPERTY(QColor inactiveColor READ inactiveColor WRITE setInactiveColor NOTIFY dialChanged)
+    Q_PROPERTY(QVariantList zones READ zones WRITE setZones NOTIFY dialChanged)
+    Q_PROPERTY(double needleLength READ needleLength WRITE setNeedleLength NOTIFY dialChanged)
+    Q_PROPERTY(double needleWidth READ needleWidth WRITE setNeedleWidth NOTIFY dialChanged)
+    Q_PROPERTY(double hubRadius READ hubRadius WRITE setHubRadius NOTIFY dialChanged)
+
+public:
+    static constexpr int HubSegments = 24;
+
+    explicit DialGauge(QQuickItem *parent = nullptr);
+
+    double value() const { return m_value; }
+    void setValue(double value);
+
+    double minimumValue() const { return m_minimumValue; }
+    void setMinimumValue(double value) { setDialProperty(m_minimumValue, value); }
+    double maximumValue() const { return m_maximumValue; }
+    void setMaximumValue(double value) { setDialProperty(m_maximumValue, value); }
+    double baseline() const { return m_baseline; }
+    void setBaseline(double value) { setDialProperty(m_baseline, value); }
+    double startAngle() const { return m_startAngle; }
+    void setStartAngle(double degrees) { setDialProperty(m_startAngle, degrees); }
+    double sweepAngle() const { return m_sweepAngle; }
+    void setSweepAngle(double degrees) { setDialProperty(m_sweepAngle, degrees); }
+
+    QPointF pivot() const;
+    void setPivot(const QPointF &pivot);
+    void resetPivot();
+
+    double radius() const { return m_radius; }
+    void setRadius(double radius) { setDialProperty(m_radius, radius); }
+    double minorTickInterval() const { return m_minorTickInterval; }
+    void setMinorTickInterval(double interval) { setDialProperty(m_minorTickInterval, interval); }
+    double majorTickInterval() const { return m_majorTickInterval; }
+    void setMajorTickInterval(double interval) { setDialProperty(m_majorTickInterval, interval); }
+    double minorTickLength() const { return m_minorTickLength; }
+    void setMinorTickLength(double length) { setDialProperty(m_minorTickLength, length); }
+    double majorTickLength() const { return m_majorTickLength; }
+    void setMajorTickLength(double length) { setDialProperty(m_majorTickLength, length); }
+    double minorTickWidth() const { return m_minorTickWidth; }
+    void setMinorTickWidth(double width) { setDialProperty(m_minorTickWidth, width); }
+    double majorTickWidth() const { return m_majorTickWidth; }
+    void setMajorTickWidth(double width) { setDialProperty(m_majorTickWidth, width); }
+
+    QColor inactiveColor() const { return m_inactiveColor; }
+    void setInactiveColor(const QColor &color);
+    QVariantList zones() const { return m_zones; }
+    void setZones(const QVariantList &zones);
+
+    double needleLength() const { return m_needleLength; }
+    void setNeedleLength(double length) { setDialProperty(m_needleLength, length); }
+    double needleWidth() const { return m_needleWidth; }
+    void setNeedleWidth(double width) { setDialProperty(m_needleWidth, width); }
+    double hubRadius() const { return m_hubRadius; }
+    void setHubRadius(double radius) { setDialProperty(m_hubRadius, radius); }
+
+    /**
+     * @brief Colour of the zone @p value falls into
+     */
+    Q_INVOKABLE QColor colorAt(double value) const;
+
+    /**
+     * @brief Point at @p distance from the pivot in the direction of @p value, in item coordinates
+     */
+    Q_INVOKABLE QPointF pointAt(double value, double distance) const;
+
+    /**
+     * @brief Dial angle of @p value in degrees, clamped to the dial
+     */
+    Q_INVOKABLE double angleAt(double value) const;
+
+signals:
+    void valueChanged();
+    void dialChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private:
+    struct Tick
+    {
+        double value;
+        bool major;
+        QColor activeColor;
+    };
+
+    struct Zone
+    {
+        double limit;
+        QColor color;
+    };
+
+    void setDialProperty(double &member, double value);
+    void rebuildTicks();
+    bool isActive(double tickValue) const;
+
+    double m_value;
+    double m_minimumValue;
+    double m_maximumValue;
+    double m_baseline;
+    double m_startAngle;
+    double m_sweepAngle;
+    QPointF m_pivot;
+    bool m_hasPivot;
+    double m_radius;
+    double m_minorTickInterval;
+    double m_majorTickInterval;
+    double m_minorTickLength;
+    double m_majorTickLength;
+    double m_minorTickWidth;
+    double m_majorTickWidth;
+    QColor m_inactiveColor;
+    QVariantList m_zones;
+    std::vector<Zone> m_zoneColors; // Parsed m_zones
+    double m_needleLength;
+    double m_needleWidth;
+    double m_hubRadius;
+
+    std::vector<Tick> m_ticks;
+    bool m_dialDirty; // Tick or needle geometry must be rebuilt
+};
+
+#endif // DIALGAUGE_H
@@ -0,0 +1,89 @@
+#ifndef EVENTCOUNT_H
+#define EVENTCOUNT_H
+
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * @brief The EventCount class lets lock-free consumers sleep until a producer signals new work
+ *
+ * Waiting is built on C++20 std::atomic::wait(), which maps to a futex on Linux and to
+ * WaitOnAddress on Windows, so an idle consumer costs no CPU and no periodic wake-ups.
+ * Producers only pay for a system call when someone is actually asleep.
+ *
+ * Consumer protocol:
+ * @code
+ * const quint32 key = events.prepareWait();
+ * if (queue has work || stopping)
+ *     events.cancelWait();
+ * else
+ *     events.commitWait(key);
+ * @endcode
+ * A producer publishes its work first and then calls notifyOne() or notifyAll().
+ */
+class EventCount
+{
+public:
+    EventCount() = default;
+    EventCount(const EventCount &) = delete;
+    EventCount &operator=(const EventCount &) = delete;
+
+    /**
+     * @brief Announce the intention to sleep; re-check the wait condition afterwards
+     * @return The key to pass to commitWait()
+     */
+    quint32 prepareWait()
+    {
+        m_waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst); // Pairs with the fence in hasWaiters()
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    /**
+     * @brief Abandon a prepared wait because work turned up
+     */
+    void cancelWait()
+    {
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sleep until a notification arrives after prepareWait() returned @p key
+     */
+    void commitWait(quint32 key)
+    {
+        m_epoch.wait(key, std::memory_order_seq_cst);
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notifyOne()
+    {
+        if (hasWaiters())
+        {
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            m_epoch.notify_one();
+        }
+    }
+
+    void notifyAll()
+    {
+        if (hasWaiters())
+        {
+            m_epoch.fetch_add(1, std::memory_order_seq_cst);
+            m_epoch.notify_all();
+        }
+    }
+
+private:
+    bool hasWaiters() const
+    {
+        // Orders the producer's publication before the waiter check
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return m_waiters.load(std::memory_order_seq_cst) > 0;
+    }
+
+    std::atomic<quint32> m_epoch{0};
+    std::atomic<int> m_waiters{0};
+};
+
+#endif // EVENTCOUNT_H
@@ -0,0 +1,52 @@
+#include "framesequencer.h"
+
+/*Latest-wins ordering for frames coming back from the parser threads. Runs on the parser thread
+ * that produced the frame, under TelemetrySource's accept lock; a couple of comparisons per frame.
+ */
+
+FrameSequencer::FrameSequencer()
+{
+    reset();
+}
+
+void FrameSequencer::reset()
+{
+    m_haveSequence = false;
+    m_lastSequence = 0;
+    m_lastArrival = 0;
+}
+
+bool FrameSequencer::accept(const TelemetryFrame &frame)
+{
+    if (frame.sequenced)
+    {
+        if (m_haveSequence)
+        {
+            // Extend to 64 bits: the signed 32-bit distance from the last accepted sequence
+            const qint64 extended = m_lastSequence + qint32(frame.sequence - quint32(m_lastSequence));
+
+            if (extended <= m_lastSequence && m_lastSequence - extended <= RestartThreshold)
+            {
+                return false;
+            }
+
+            // Either newer, or the sender restarted its counter
+            m_lastSequence = extended > m_lastSequence ? extended : qint64(frame.sequence);
+        }
+        else
+        {
+            m_haveSequence = true;
+            m_lastSequence = frame.sequence;
+        }
+    }
+    else if (frame.arrival != 0 && frame.arrival <= m_lastArrival)
+    {
+        return false;
+    }
+
+    if (frame.arrival > m_lastArrival)
+    {
+        m_lastArrival = frame.arrival;
+    }
+    return true;
+}
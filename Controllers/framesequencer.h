@@ -0,0 +1,40 @@
+#ifndef FRAMESEQUENCER_H
+#define FRAMESEQUENCER_H
+
+#include <QtGlobal>
+#include "telemetryframe.h"
+#include "telemetrywireformat.h"
+
+/**
+ * @brief The FrameSequencer class drops frames that are older than the last one published
+ *
+ * Parallel parsers finish out of order, so without this an older frame can overwrite a newer
+ * one. Frames in the binary wire format are ordered by their sender sequence number, which
+ * also undoes reordering on the network; other frames by the arrival stamp the client put on
+ * the datagram when dispatching it. Frames without either are always accepted.
+ *
+ * A sequence number far behind the last one (more than RestartThreshold) is taken as a sender
+ * restart rather than a stale frame.
+ */
+class FrameSequencer
+{
+public:
+    static constexpr qint64 RestartThreshold = TelemetryWireFormat::SequenceRestartThreshold;
+
+    FrameSequencer();
+
+    void reset();
+
+    /**
+     * @brief Decide whether a frame is newer than everything accepted so far
+     * @return True if the frame should be published, false if it is stale
+     */
+    bool accept(const TelemetryFrame &frame);
+
+private:
+    bool m_haveSequence;
+    qint64 m_lastSequence; // Wire sequence extended to 64 bits
+    quint64 m_lastArrival;
+};
+
+#endif // FRAMESEQUENCER_H
@@ -0,0 +1,528 @@
+#include "ggdiagram.h"
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGVertexColorMaterial>
+#include <cmath>
+
+/*Scene-graph G-G diagram. The GUI thread turns new history frames into points in G units;
+ *  updatePaintNode() appends them to the newest trail chunk and refreshes the heatmap cells.
+ *  Each segment of the trail is a quad of four triangle-strip vertices, offset from the segment
+ *  by half the trail width; the strip triangles between two quads fill the joint. Unused
+ *  vertices at the end of the newest chunk repeat its last vertex, so the chunk can keep a fixed
+ *  vertex count and the padding only adds degenerate triangles.
+ */
+
+namespace
+{
+constexpr int VerticesPerSegment = 4;
+
+struct TrailChunk
+{
+    QSGGeometryNode *node;
+    int vertices; // Written vertices, four per segment
+    int points;   // Plotted points it holds
+};
+
+class GgDiagramNode : public QSGNode
+{
+public:
+    GgDiagramNode() : points(0), hasLast(false), heatmap(nullptr) {}
+
+    void clearTrail()
+    {
+        for (const TrailChunk &chunk : chunks)
+        {
+            removeChildNode(chunk.node);
+            delete chunk.node;
+        }
+        chunks.clear();
+        points = 0;
+        hasLast = false;
+    }
+
+    void dropOldChunks(int trailLength)
+    {
+        while (chunks.size() > 1 && points - chunks.front().points >= trailLength)
+        {
+            removeChildNode(chunks.front().node);
+            delete chunks.front().node;
+            points -= chunks.front().points;
+            chunks.pop_front();
+        }
+    }
+
+    void removeHeatmap()
+    {
+        if (heatmap)
+        {
+            removeChildNode(heatmap);
+            delete heatmap;
+            heatmap = nullptr;
+        }
+    }
+
+    std::deque<TrailChunk> chunks;
+    int points;
+    bool hasLast;     // Whether last holds the end of the trail
+    QPointF last;     // Newest trail point in pixels
+    QPointF lastSide; // Half-width offset of the newest segment, reused for zero-length ones
+    QSGGeometryNode *heatmap;
+};
+
+QSGGeometryNode *createChunkNode(const QColor &color)
+{
+    auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_Point2D(), GgDiagram::ChunkSize);
+    // Line widths other than 1 are only honoured by the OpenGL backend, so the trail is made of quads
+    geometry->setDrawingMode(QSGGeometry::DrawTriangleStrip);
+    geometry->setVertexDataPattern(QSGGeometry::DynamicPattern);
+
+    auto *material = new QSGFlatColorMaterial;
+    material->setColor(color);
+
+    auto *node = new QSGGeometryNode;
+    node->setGeometry(geometry);
+    node->setMaterial(material);
+    node->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+    return node;
+}
+
+// Blue through cyan, green and yellow to red
+QColor heatColor(double t)
+{
+    static const QColor stops[] = {QColor(40, 70, 255), QColor(0, 220, 255), QColor(40, 230, 60), QColor(255, 230, 0), QColor(255, 40, 20)};
+    const double scaled = qBound(0.0, t, 1.0) * 4.0;
+    const int index = qMin(3, int(scaled));
+    const double f = scaled - index;
+    const QColor &from = stops[index];
+    const QColor &to = stops[index + 1];
+    return QColor(int(from.red() + (to.red() - from.red()) * f),
+                  int(from.green() + (to.green() - from.green()) * f),
+                  int(from.blue() + (to.blue() - from.blue()) * f));
+}
+} // namespace
+
+GgDiagram::GgDiagram(QQuickItem *parent)
+    : QQuickItem(parent),
+      m_consumed(0),
+      m_mode(Trail),
+      m_trailLength(DefaultTrailLength),
+      m_maxLateralG(3.5),
+      m_maxLongitudinalG(2.0),
+      m_margin(20.0),
+      m_color(Qt::white),
+      m_heatmapResolution(DefaultHeatmapResolution),
+      m_pointCount(0),
+      m_rebuildTrail(true),
+      m_colorChanged(false),
+      m_maxCell(0),
+      m_heatmapDirty(true)
+{
+    setFlag(ItemHasContents, true);
+    resetHeatmap();
+}
+
+void GgDiagram::setHistory(TelemetryHistory *history)
+{
+    if (history == m_history)
+    {
+        return;
+    }
+
+    if (m_history)
+    {
+        disconnect(m_history, nullptr, this, nullptr);
+    }
+
+    m_history = history;
+    m_consumed = 0;
+    clear();
+
+    if (m_history)
+    {
+        connect(m_history, &TelemetryHistory::revisionChanged, this, &GgDiagram::readHistory);
+        readHistory();
+    }
+
+    emit historyChanged();
+}
+
+void GgDiagram::readHistory()
+{
+    if (!m_history)
+    {
+        return;
+    }
+
+    static const int lateralChannel = TelemetryHistory::channelIndex(QStringLiteral("lateralG"));
+    static const int longitudinalChannel = TelemetryHistory::channelIndex(QStringLiteral("longitudinalG"));
+
+    const quint64 appended = m_history->appended();
+    if (appended < m_consumed)
+    {
+        // The history was cleared; so is the diagram
+        clear();
+        m_consumed = 0;
+    }
+
+    if (appended == m_consumed)
+    {
+        return;
+    }
+
+    // Frames the ring already overwrote are skipped
+    const quint64 oldest = appended - quint64(m_history->count());
+
+    for (quint64 frame = qMax(m_consumed, oldest); frame < appended; ++frame)
+    {
+        const int index = int(frame - oldest);
+        addPoint(QPointF(m_history->value(lateralChannel, index), m_history->value(longitudinalChannel, index)));
+    }
+    m_consumed = appended;
+
+    emit pointCountChanged();
+    update();
+}
+
+void GgDiagram::addPoint(const QPointF &g)
+{
+    m_pointCount++;
+
+    m_trail.push_back(g);
+    if (int(m_trail.size()) > m_trailLength)
+    {
+        m_trail.pop_front();
+    }
+
+    if (!m_rebuildTrail)
+    {
+        m_pending.push_back(g);
+        if (int(m_pending.size()) >= m_trailLength)
+        {
+            // Cheaper to rebuild the whole trail than to append and drop a trail's worth
+            m_rebuildTrail = true;
+            m_pending.clear();
+        }
+    }
+
+    // Lateral G picks the column, longitudinal G the row from the top
+    const int resolution = m_heatmapResolution;
+    const int column = qBound(0, int(std::floor((g.x() / m_maxLateralG + 1.0) * 0.5 * resolution)), resolution - 1);
+    const int row = qBound(0, int(std::floor((1.0 - g.y() / m_maxLongitudinalG) * 0.5 * resolution)), resolution - 1);
+    quint32 &cell = m_cells[size_t(row) * size_t(resolution) + size_t(column)];
+    cell++;
+    m_maxCell = qMax(m_maxCell, cell);
+    m_heatmapDirty = true;
+}
+
+void GgDiagram::clear()
+{
+    m_trail.clear();
+    m_pending.clear();
+    m_rebuildTrail = true;
+    resetHeatmap();
+
+    if (m_pointCount != 0)
+    {
+        m_pointCount = 0;
+        emit pointCountChanged();
+    }
+    update();
+}
+
+void GgDiagram::rebuild()
+{
+    m_pending.clear();
+    m_rebuildTrail = true;
+    m_heatmapDirty = true;
+    update();
+}
+
+void GgDiagram::resetHeatmap()
+{
+    m_cells.assign(size_t(m_heatmapResolution) * size_t(m_heatmapResolution), 0);
+    m_maxCell = 0;
+    m_heatmapDirty = true;
+}
+
+QPointF GgDiagram::toPixels(const QPointF &g) const
+{
+    const double halfWidth = width() / 2.0;
+    const double halfHeight = height() / 2.0;
+    const double x = halfWidth + g.x() / m_maxLateralG * (halfWidth - m_margin);
+    const double y = halfHeight - g.y() / m_maxLongitudinalG * (halfHeight - m_margin);
+    return QPointF(qBound(m_margin, x, width() - m_margin), qBound(m_margin, y, height() - m_margin));
+}
+
+QSGNode *GgDiagram::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *)
+{
+    auto *root = static_cast<GgDiagramNode *>(oldNode);
+    if (!root)
+    {
+        root = new GgDiagramNode;
+    }
+
+    if (m_colorChanged)
+    {
+        for (const TrailChunk &chunk : root->chunks)
+        {
+            static_cast<QSGFlatColorMaterial *>(chunk.node->material())->setColor(m_color);
+            chunk.node->markDirty(QSGNode::DirtyMaterial);
+        }
+        m_colorChanged = false;
+    }
+
+    if (m_mode == Trail)
+    {
+        root->removeHeatmap();
+
+        if (m_rebuildTrail)
+        {
+            root->clearTrail();
+            m_pending.assign(m_trail.begin(), m_trail.end());
+            m_rebuildTrail = false;
+        }
+
+        for (const QPointF &g : m_pending)
+        {
+            if (root->chunks.empty() || root->chunks.back().vertices == ChunkSize)
+            {
+                // Segments carry their own start point, so a new chunk needs nothing from the previous one
+                TrailChunk chunk{createChunkNode(m_color), 0, 0};
+                root->appendChildNode(chunk.node);
+                root->chunks.push_back(chunk);
+            }
+
+            TrailChunk &chunk = root->chunks.back();
+            const QPointF pixel = toPixels(g);
+            chunk.points++;
+            root->points++;
+
+            if (root->hasLast)
+            {
+                const QPointF direction = pixel - root->last;
+                const double length = std::hypot(direction.x(), direction.y());
+                if (length > 1e-6)
+                {
+                    root->lastSide = QPointF(-direction.y(), direction.x()) * (TrailWidth / 2.0 / length);
+                }
+
+                const QPointF &side = root->lastSide;
+                QSGGeometry::Point2D *vertex = chunk.node->geometry()->vertexDataAsPoint2D() + chunk.vertices;
+                vertex[0].set(float(root->last.x() + side.x()), float(root->last.y() + side.y()));
+                vertex[1].set(float(root->last.x() - side.x()), float(root->last.y() - side.y()));
+                vertex[2].set(float(pixel.x() + side.x()), float(pixel.y() + side.y()));
+                vertex[3].set(float(pixel.x() - side.x()), float(pixel.y() - side.y()));
+                chunk.vertices += VerticesPerSegment;
+            }
+            else
+            {
+                root->lastSide = QPointF(0.0, TrailWidth / 2.0);
+            }
+            root->last = pixel;
+            root->hasLast = true;
+
+            if (chunk.vertices == ChunkSize)
+            {
+                chunk.node->markDirty(QSGNode::DirtyGeometry);
+            }
+        }
+
+        if (!m_pending.empty())
+        {
+            // Pad the newest chunk with its last vertex and upload it
+            TrailChunk &chunk = root->chunks.back();
+            QSGGeometry::Point2D *vertices = chunk.node->geometry()->vertexDataAsPoint2D();
+            QSGGeometry::Point2D padding;
+            padding.set(float(root->last.x()), float(root->last.y()));
+            if (chunk.vertices > 0)
+            {
+                padding = vertices[chunk.vertices - 1];
+            }
+            for (int i = chunk.vertices; i < ChunkSize; ++i)
+            {
+                vertices[i] = padding;
+            }
+            chunk.node->markDirty(QSGNode::DirtyGeometry);
+            m_pending.clear();
+        }
+
+        root->dropOldChunks(m_trailLength);
+        return root;
+    }
+
+    root->clearTrail();
+    m_pending.clear();
+    m_rebuildTrail = true; // Replay the kept points when switching back
+
+    if (!root->heatmap)
+    {
+        auto *geometry = new QSGGeometry(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0);
+        geometry->setDrawingMode(QSGGeometry::DrawTriangles);
+        root->heatmap = new QSGGeometryNode;
+        root->heatmap->setGeometry(geometry);
+        root->heatmap->setMaterial(new QSGVertexColorMaterial);
+        root->heatmap->setFlags(QSGNode::OwnsGeometry | QSGNode::OwnsMaterial);
+        root->appendChildNode(root->heatmap);
+        m_heatmapDirty = true;
+    }
+
+    if (m_heatmapDirty)
+    {
+        const int resolution = m_heatmapResolution;
+        int occupied = 0;
+        for (quint32 count : m_cells)
+        {
+            occupied += count > 0 ? 1 : 0;
+        }
+
+        QSGGeometry *geometry = root->heatmap->geometry();
+        geometry->allocate(occupied * 6);
+        QSGGeometry::ColoredPoint2D *vertex = geometry->vertexDataAsColoredPoint2D();
+
+        const double cellWidth = (width() - 2.0 * m_margin) / resolution;
+        const double cellHeight = (height() - 2.0 * m_margin) / resolution;
+        const double scale = m_maxCell > 0 ? 1.0 / std::log1p(double(m_maxCell)) : 0.0;
+
+        for (int row = 0; row < resolution; ++row)
+        {
+            for (int column = 0; column < resolution; ++column)
+            {
+                const quint32 count = m_cells[size_t(row) * size_t(resolution) + size_t(column)];
+                if (count == 0)
+                {
+                    continue;
+                }
+
+                // Vertex colours are premultiplied
+                const double t = std::log1p(double(count)) * scale;
+                const QColor color = heatColor(t);
+                const double alpha = 0.35 + 0.65 * t;
+                const uchar r = uchar(color.red() * alpha);
+                const uchar g = uchar(color.green() * alpha);
+                const uchar b = uchar(color.blue() * alpha);
+                const uchar a = uchar(255 * alpha);
+
+                const float left = float(m_margin + column * cellWidth);
+                const float top = float(m_margin + row * cellHeight);
+                const float right = float(left + cellWidth);
+                const float bottom = float(top + cellHeight);
+
+                vertex[0].set(left, top, r, g, b, a);
+                vertex[1].set(right, top, r, g, b, a);
+                vertex[2].set(left, bottom, r, g, b, a);
+                vertex[3].set(right, top, r, g, b, a);
+                vertex[4].set(right, bottom, r, g, b, a);
+                vertex[5].set(left, bottom, r, g, b, a);
+                vertex += 6;
+            }
+        }
+
+        root->heatmap->markDirty(QSGNode::DirtyGeometry);
+        m_heatmapDirty = false;
+    }
+
+    return root;
+}
+
+void GgDiagram::geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    QQuickItem::geometryChange(newGeometry, oldGeometry);
+    if (newGeometry.size() != oldGeometry.size())
+    {
+        rebuild();
+    }
+}
+
+void GgDiagram::setMode(Mode mode)
+{
+    if (mode == m_mode)
+    {
+        return;
+    }
+
+    m_mode = mode;
+    rebuild();
+    emit modeChanged();
+}
+
+void GgDiagram::setTrailLength(int points)
+{
+    points = qMax(2, points);
+    if (points == m_trailLength)
+    {
+        return;
+    }
+
+    m_trailLength = points;
+    while (int(m_trail.size()) > m_trailLength)
+    {
+        m_trail.pop_front();
+    }
+    rebuild();
+    emit trailLengthChanged();
+}
+
+void GgDiagram::setMaxLateralG(double g)
+{
+    if (g <= 0.0 || g == m_maxLateralG)
+    {
+        return;
+    }
+
+    m_maxLateralG = g;
+    resetHeatmap(); // Cells are laid out in G; earlier counts no longer fit them
+    rebuild();
+    emit rangeChanged();
+}
+
+void GgDiagram::setMaxLongitudinalG(double g)
+{
+    if (g <= 0.0 || g == m_maxLongitudinalG)
+    {
+        return;
+    }
+
+    m_maxLongitudinalG = g;
+    resetHeatmap();
+    rebuild();
+    emit rangeChanged();
+}
+
+void GgDiagram::setMargin(double pixels)
+{
+    if (pixels == m_margin)
+    {
+        return;
+    }
+
+    m_margin = qMax(0.0, pixels);
+    rebuild();
+    emit rangeChanged();
+}
+
+void GgDiagram::setColor(const QColor &color)
+{
+    if (color == m_color)
+    {
+        return;
+    }
+
+    m_color = color;
+    m_colorChanged = true;
+    update();
+    emit colorChanged();
+}
+
+void GgDiagram::setHeatmapResolution(int cells)
+{
+    cells = qBound(4, cells, 256);
+    if (cells == m_heatmapResolution)
+    {
+        return;
+    }
+
+    m_heatmapResolution = cells;
+    resetHeatmap();
+    update();
+    emit heatmapResolutionChanged();
+}
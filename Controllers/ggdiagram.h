@@ -0,0 +1,137 @@
+#ifndef GGDIAGRAM_H
+#define GGDIAGRAM_H
+
+#include <QColor>
+#include <QPointer>
+#include <QPointF>
+#include <QQuickItem>
+#include <deque>
+#include <vector>
+#include "telemetryhistory.h"
+
+/**
+ * @brief The GgDiagram class draws the friction circle (G-G diagram) in the scene graph
+ *
+ * Points are read from a TelemetryHistory as it grows, so every accepted frame is plotted with
+ * its real lateral and longitudinal G rather than an animated marker position. Lateral G runs
+ * along x (right is positive) and longitudinal G along y (up is acceleration); the ranges
+ * map to the item minus @c margin on every side.
+ *
+ * Trail mode draws the last trailLength points as a TrailWidth pixel wide triangle strip, one
+ * quad per segment, split into chunks of ChunkSize vertices; the strip is built from quads
+ * because line widths other than 1 are only honoured by the OpenGL backend. New points are
+ * only ever appended to the newest chunk, so a frame uploads a few new vertices instead of
+ * re-tessellating the trail; the oldest chunk is dropped whole once the rest still holds
+ * trailLength points. Heatmap mode instead shades a
+ * heatmapResolution x heatmapResolution grid by how many points fell into each cell since
+ * the last clear(), on a logarithmic scale. The grid is counted in both modes, so switching
+ * shows the whole session.
+ *
+ * Resizing or changing a range rebuilds the trail from the points kept for it. The heatmap
+ * cells are laid out in G, so changing a range or the resolution starts a new count.
+ */
+class GgDiagram : public QQuickItem
+{
+    Q_OBJECT
+    Q_PROPERTY(TelemetryHistory *history READ history WRITE setHistory NOTIFY historyChanged)
+    Q_PROPERTY(Mode mode READ mode WRITE setMode NOTIFY modeChanged)
+    Q_PROPERTY(int trailLength READ trailLength WRITE setTrailLength NOTIFY trailLengthChanged)
+    Q_PROPERTY(double maxLateralG READ maxLateralG WRITE setMaxLateralG NOTIFY rangeChanged)
+    Q_PROPERTY(double maxLongitudinalG READ maxLongitudinalG WRITE setMaxLongitudinalG NOTIFY rangeChanged)
+    Q_PROPERTY(double margin READ margin WRITE setMargin NOTIFY rangeChanged)
+    Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
+    Q_PROPERTY(int heatmapResolution READ heatmapResolution WRITE setHeatmapResolution NOTIFY heatmapResolutionChanged)
+    Q_PROPERTY(int pointCount READ pointCount NOTIFY pointCountChanged)
+
+public:
+    enum Mode
+    {
+        Trail,  // Line through the most recent points
+        Heatmap // Density of all points since clear()
+    };
+    Q_ENUM(Mode)
+
+    static constexpr int ChunkSize = 256; // Vertices, four per segment
+    static constexpr double TrailWidth = 2.0;
+    static constexpr int DefaultTrailLength = 2000;
+    static constexpr int DefaultHeatmapResolution = 48;
+
+    explicit GgDiagram(QQuickItem *parent = nullptr);
+
+    TelemetryHistory *history() const { return m_history; }
+    void setHistory(TelemetryHistory *history);
+
+    Mode mode() const { return m_mode; }
+    void setMode(Mode mode);
+
+    int trailLength() const { return m_trailLength; }
+    void setTrailLength(int points);
+
+    double maxLateralG() const { return m_maxLateralG; }
+    void setMaxLateralG(double g);
+    double maxLongitudinalG() const { return m_maxLongitudinalG; }
+    void setMaxLongitudinalG(double g);
+    double margin() const { return m_margin; }
+    void setMargin(double pixels);
+
+    QColor color() const { return m_color; }
+    void setColor(const QColor &color);
+
+    int heatmapResolution() const { return m_heatmapResolution; }
+    void setHeatmapResolution(int cells);
+
+    /**
+     * @brief Points plotted since the last clear()
+     */
+    int pointCount() const { return m_pointCount; }
+
+    /**
+     * @brief Erase the trail and the heatmap; the history itself is kept
+     */
+    Q_INVOKABLE void clear();
+
+signals:
+    void historyChanged();
+    void modeChanged();
+    void trailLengthChanged();
+    void rangeChanged();
+    void colorChanged();
+    void heatmapResolutionChanged();
+    void pointCountChanged();
+
+protected:
+    QSGNode *updatePaintNode(QSGNode *oldNode, UpdatePaintNodeData *data) override;
+    void geometryChange(const QRectF &newGeometry, const QRectF &oldGeometry) override;
+
+private slots:
+    void readHistory();
+
+private:
+    QPointF toPixels(const QPointF &g) const;
+    void addPoint(const QPointF &g);
+    void rebuild();
+    void resetHeatmap();
+
+    QPointer<TelemetryHistory> m_history;
+    quint64 m_consumed; // history->appended() at the last read
+
+    Mode m_mode;
+    int m_trailLength;
+    double m_maxLateralG;
+    double m_maxLongitudinalG;
+    double m_margin;
+    QColor m_color;
+    int m_heatmapResolution;
+    int m_pointCount;
+
+    // GUI thread state, read by updatePaintNode() while the GUI thread is blocked
+    std::deque<QPointF> m_trail;    // Last trailLength points in G, for rebuilds
+    std::vector<QPointF> m_pending; // Points in G not yet appended to the nodes
+    bool m_rebuildTrail;            // Drop the trail nodes and replay m_trail instead
+    bool m_colorChanged;
+    std::vector<quint32> m_cells;   // Heatmap counts, row-major
+    quint32 m_maxCell;
+    bool m_heatmapDirty;
+};
+
+#endif // GGDIAGRAM_H
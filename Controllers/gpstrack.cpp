@@ -0,0 +1,258 @@
+#include "gpstrack.h"
+#include "telemetrychannels.h"
+#include <QtMath>
+#include <cmath>
+
+/*Streaming simplification of the GPS track, an opening-window scheme: the fixes a segment has
+ * absorbed are kept until it is committed, so a slow curve cannot drift away from its chord.
+ * Distances use a local equirectangular projection around the anchor vertex, which is accurate
+ * to well under a percent over the few hundred metres between two vertices and needs no
+ * trigonometry beyond one cosine per fix.
+ */
+
+namespace
+{
+constexpr double EarthRadiusMetres = 6371000.0;
+constexpr double DegreesToRadians = M_PI / 180.0;
+
+// Offset of @p point from @p origin in metres (east, north)
+QPointF metresFrom(const QPointF &origin, const QPointF &point)
+{
+    const double east = (point.x() - origin.x()) * DegreesToRadians * EarthRadiusMetres * std::cos(origin.y() * DegreesToRadians);
+    const double north = (point.y() - origin.y()) * DegreesToRadians * EarthRadiusMetres;
+    return QPointF(east, north);
+}
+
+double length(const QPointF &vector)
+{
+    return std::hypot(vector.x(), vector.y());
+}
+} // namespace
+
+GpsTrack::GpsTrack(QObject *parent)
+    : QObject(parent),
+      m_latitude(0.0),
+      m_longitude(0.0),
+      m_fixCount(0),
+      m_skippedFixes(0),
+      m_gap(false),
+      m_distanceTolerance(DefaultDistanceTolerance),
+      m_angleTolerance(DefaultAngleTolerance),
+      m_maximumVertices(DefaultMaximumVertices),
+      m_firstChanged(0),
+      m_reset(false),
+      m_positionChanged(false)
+{
+    m_absorbed.reserve(MaximumAbsorbed);
+}
+
+bool GpsTrack::isValidFix(double latitude, double longitude)
+{
+    return std::isfinite(latitude) && std::isfinite(longitude)
+           && latitude >= -90.0 && latitude <= 90.0
+           && longitude >= -180.0 && longitude <= 180.0
+           && !(latitude == 0.0 && longitude == 0.0);
+}
+
+void GpsTrack::append(const TelemetryFrame &frame)
+{
+    append(frame.gpsLatitude, frame.gpsLongitude);
+}
+
+void GpsTrack::append(double latitude, double longitude)
+{
+    if (!isValidFix(latitude, longitude))
+    {
+        return;
+    }
+
+    m_latitude = latitude;
+    m_longitude = longitude;
+    m_fixCount++;
+    m_positionChanged = true;
+
+    const QPointF fix(longitude, latitude);
+    const int count = int(m_vertices.size());
+
+    if (count == 0)
+    {
+        m_gap = false;
+        m_vertices.push_back(fix);
+        markChanged(0);
+        return;
+    }
+
+    const QPointF &tail = m_vertices.back();
+    if (length(metresFrom(tail, fix)) < m_distanceTolerance)
+    {
+        return; // Jitter around the tail, e.g. while the car stands in the pits
+    }
+
+    if (!m_gap && count >= 2 && int(m_absorbed.size()) < MaximumAbsorbed && tailIsRedundant(m_vertices[size_t(count - 2)], tail, fix))
+    {
+        // Still on the same straight: slide the tail forward
+        m_absorbed.push_back(tail);
+        m_vertices.back() = fix;
+        markChanged(count - 1);
+        return;
+    }
+
+    // The path bends at the tail, or fixes are missing after it; keep it and start a new floating tail
+    m_gap = false;
+    m_absorbed.clear();
+    m_vertices.push_back(fix);
+    markChanged(count);
+
+    if (int(m_vertices.size()) > m_maximumVertices)
+    {
+        thin();
+    }
+}
+
+bool GpsTrack::tailIsRedundant(const QPointF &anchor, const QPointF &tail, const QPointF &fix) const
+{
+    const QPointF toTail = metresFrom(anchor, tail);
+    const QPointF toFix = metresFrom(anchor, fix);
+
+    const double chord = length(toFix);
+    if (chord <= length(toTail))
+    {
+        return false; // Not moving away from the anchor: stopping short or doubling back is a turn
+    }
+
+    // Every fix the segment absorbed must stay within the tolerance of the straight line anchor -> fix
+    const auto crossTrack = [&](const QPointF &point) {
+        const QPointF offset = metresFrom(anchor, point);
+        return std::abs(toFix.x() * offset.y() - toFix.y() * offset.x()) / chord;
+    };
+    if (crossTrack(tail) > m_distanceTolerance)
+    {
+        return false;
+    }
+    for (const QPointF &absorbed : m_absorbed)
+    {
+        if (crossTrack(absorbed) > m_distanceTolerance)
+        {
+            return false;
+        }
+    }
+
+    // How far the heading from the anchor swings. Close to the anchor a wobble within the distance
+    // tolerance already swings it a lot, so only a larger swing counts as a turn there.
+    const double turn = std::abs(std::remainder(std::atan2(toFix.y(), toFix.x()) - std::atan2(toTail.y(), toTail.x()), 2.0 * M_PI));
+    const double noiseFloor = std::asin(qMin(1.0, m_distanceTolerance / length(toTail)));
+    return turn <= qMax(m_angleTolerance * DegreesToRadians, noiseFloor);
+}
+
+void GpsTrack::thin()
+{
+    // Keep the first vertex, every second one after it, and always the last committed vertex and the tail
+    const size_t count = m_vertices.size();
+    size_t kept = 1;
+    for (size_t i = 2; i + 2 < count; i += 2)
+    {
+        m_vertices[kept++] = m_vertices[i];
+    }
+    m_vertices[kept++] = m_vertices[count - 2];
+    m_vertices[kept++] = m_vertices[count - 1];
+    m_vertices.resize(kept);
+
+    m_reset = true;
+}
+
+void GpsTrack::markChanged(int from)
+{
+    m_firstChanged = qMin(m_firstChanged, from);
+}
+
+void GpsTrack::publish()
+{
+    if (m_reset)
+    {
+        m_reset = false;
+        emit pathReset();
+    }
+    else if (m_firstChanged < int(m_vertices.size()))
+    {
+        emit pathExtended(m_firstChanged);
+    }
+    m_firstChanged = int(m_vertices.size());
+
+    if (m_positionChanged)
+    {
+        m_positionChanged = false;
+        emit positionChanged();
+    }
+}
+
+void GpsTrack::skipFixes(qint64 fixes)
+{
+    if (fixes <= 0)
+    {
+        return;
+    }
+
+    m_skippedFixes += fixes;
+    m_gap = true;
+    m_positionChanged = true;
+}
+
+void GpsTrack::clear()
+{
+    m_vertices.clear();
+    m_absorbed.clear();
+    m_skippedFixes = 0;
+    m_gap = false;
+    m_firstChanged = 0;
+    m_reset = true;
+    publish();
+}
+
+QList<QPointF> GpsTrack::vertices(int from) const
+{
+    QList<QPointF> points;
+    const int count = int(m_vertices.size());
+    from = qBound(0, from, count);
+    points.reserve(count - from);
+    for (int i = from; i < count; ++i)
+    {
+        points.append(m_vertices[size_t(i)]);
+    }
+    return points;
+}
+
+void GpsTrack::setDistanceTolerance(double metres)
+{
+    metres = qMax(0.0, metres);
+    if (metres != m_distanceTolerance)
+    {
+        m_distanceTolerance = metres;
+        emit tolerancesChanged();
+    }
+}
+
+void GpsTrack::setAngleTolerance(double degrees)
+{
+    degrees = qBound(0.0, degrees, 180.0);
+    if (degrees != m_angleTolerance)
+    {
+        m_angleTolerance = degrees;
+        emit tolerancesChanged();
+    }
+}
+
+void GpsTrack::setMaximumVertices(int count)
+{
+    count = qMax(4, count);
+    if (count == m_maximumVertices)
+    {
+        return;
+    }
+
+    m_maximumVertices = count;
+    while (int(m_vertices.size()) > m_maximumVertices)
+    {
+        thin();
+    }
+    emit tolerancesChanged();
+}
@@ -0,0 +1,140 @@
+#ifndef GPSTRACK_H
+#define GPSTRACK_H
+
+#include <QObject>
+#include <QList>
+#include <QPointF>
+#include <vector>
+
+struct TelemetryFrame;
+
+/**
+ * @brief The GpsTrack class turns the GPS fixes of a session into a simplified polyline for the map
+ *
+ * Latitude and longitude are taken from the same frame, so every fix is one vertex candidate.
+ * Fixes are simplified as they arrive: the last vertex is a floating tail that follows the car,
+ * and it is only committed when the path bends, i.e. when the heading from the previous vertex
+ * swings by more than angleTolerance degrees, or when the tail or any fix the segment absorbed
+ * would be more than distanceTolerance metres off the straight line from the previous vertex to
+ * the new fix. A segment absorbs at most MaximumAbsorbed fixes, which bounds the work per fix.
+ * Fixes closer than distanceTolerance to the tail are jitter and only move the position, so a
+ * stationary car adds nothing and a long straight costs a handful of vertices.
+ *
+ * If the track still reaches maximumVertices, every second vertex of it is dropped, so memory
+ * stays bounded while the whole session remains visible at a coarser resolution.
+ *
+ * Fixes its feeder had to drop are reported with skipFixes() and counted in skippedFixes. The
+ * vertex before such a gap is committed and the first fix after it always starts a new one, so
+ * the gap shows as one plain segment between real fixes instead of being smoothed into the path.
+ *
+ * Vertices are (longitude, latitude) points. After publish(), pathExtended(from) says that
+ * vertices from @c from onwards changed or were added, so a MapPolyline only replaces its tail
+ * and appends; pathReset() asks for the whole path to be reloaded. GUI thread only.
+ */
+class GpsTrack : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool hasFix READ hasFix NOTIFY positionChanged)
+    Q_PROPERTY(double latitude READ latitude NOTIFY positionChanged)
+    Q_PROPERTY(double longitude READ longitude NOTIFY positionChanged)
+    Q_PROPERTY(int vertexCount READ vertexCount NOTIFY positionChanged)
+    Q_PROPERTY(qint64 fixCount READ fixCount NOTIFY positionChanged)
+    Q_PROPERTY(qint64 skippedFixes READ skippedFixes NOTIFY positionChanged)
+    Q_PROPERTY(double distanceTolerance READ distanceTolerance WRITE setDistanceTolerance NOTIFY tolerancesChanged)
+    Q_PROPERTY(double angleTolerance READ angleTolerance WRITE setAngleTolerance NOTIFY tolerancesChanged)
+    Q_PROPERTY(int maximumVertices READ maximumVertices WRITE setMaximumVertices NOTIFY tolerancesChanged)
+
+public:
+    static constexpr double DefaultDistanceTolerance = 1.0; // Metres
+    static constexpr double DefaultAngleTolerance = 5.0;    // Degrees
+    static constexpr int DefaultMaximumVertices = 20000;
+    static constexpr int MaximumAbsorbed = 256; // Fixes one segment may absorb before the tail is committed anyway
+
+    explicit GpsTrack(QObject *parent = nullptr);
+
+    /**
+     * @brief Add the fix of an accepted frame; frames without a valid fix are ignored. Does not notify.
+     */
+    void append(const TelemetryFrame &frame);
+    void append(double latitude, double longitude);
+
+    /**
+     * @brief Record that @p fixes fixes were lost before the next append(). Does not notify.
+     */
+    void skipFixes(qint64 fixes);
+
+    /**
+     * @brief Emit the path and position signals for what changed since the last call
+     */
+    void publish();
+
+    /**
+     * @brief Forget the path; the position is kept
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief Vertices from index @p from onwards as (longitude, latitude) points
+     */
+    Q_INVOKABLE QList<QPointF> vertices(int from = 0) const;
+
+    /**
+     * @brief Whether the coordinates are a usable fix; (0, 0) is what a logger without a fix sends
+     */
+    static bool isValidFix(double latitude, double longitude);
+
+    bool hasFix() const { return m_fixCount > 0; }
+    double latitude() const { return m_latitude; }
+    double longitude() const { return m_longitude; }
+    int vertexCount() const { return int(m_vertices.size()); }
+    qint64 fixCount() const { return m_fixCount; }
+    qint64 skippedFixes() const { return m_skippedFixes; }
+
+    double distanceTolerance() const { return m_distanceTolerance; }
+    void setDistanceTolerance(double metres);
+    double angleTolerance() const { return m_angleTolerance; }
+    void setAngleTolerance(double degrees);
+    int maximumVertices() const { return m_maximumVertices; }
+    void setMaximumVertices(int count);
+
+signals:
+    /**
+     * @brief Vertices from @p from onwards were replaced or appended; the ones before are unchanged
+     */
+    void pathExtended(int from);
+
+    /**
+     * @brief The path was cleared or thinned and must be reloaded with vertices()
+     */
+    void pathReset();
+
+    void positionChanged();
+    void tolerancesChanged();
+
+private:
+    /**
+     * @brief Whether the tail can be dropped in favour of a straight segment to @p fix
+     */
+    bool tailIsRedundant(const QPointF &anchor, const QPointF &tail, const QPointF &fix) const;
+    void thin();
+    void markChanged(int from);
+
+    std::vector<QPointF> m_vertices; // The last one is the floating tail
+    std::vector<QPointF> m_absorbed; // Fixes dropped from the current segment, checked against every new chord
+    double m_latitude;
+    double m_longitude;
+    qint64 m_fixCount;
+    qint64 m_skippedFixes;
+    bool m_gap; // Fixes were skipped since the last append(); the next one starts a new vertex
+
+    double m_distanceTolerance;
+    double m_angleTolerance;
+    int m_maximumVertices;
+
+    // Changes since the last publish()
+    int m_firstChanged; // vertexCount() if no vertex changed
+    bool m_reset;
+    bool m_positionChanged;
+};
+
+#endif // GPSTRACK_H
@@ -0,0 +1,87 @@
+#include "linkstatistics.h"
+#include <limits>
+
+/*Loss and latency bookkeeping for the binary wire format. Runs on the parser threads under
+ * TelemetrySource's accept lock; it is a handful of integer operations per frame.
+ */
+
+namespace
+{
+constexpr double LatencySmoothing = 0.05; // Weight of the newest sample in the moving average
+}
+
+LinkStatistics::LinkStatistics()
+{
+    reset();
+}
+
+void LinkStatistics::reset()
+{
+    m_started = false;
+    m_firstSequence = 0;
+    m_highestSequence = 0;
+    m_received = 0;
+    m_lostBeforeRestart = 0;
+    m_minimumOffsetUs = std::numeric_limits<qint64>::max();
+    m_latencyUs = 0.0;
+    m_lastPublishUs = 0;
+}
+
+bool LinkStatistics::record(quint32 sequence, quint64 senderTimestampUs, qint64 hostTimestampUs)
+{
+    if (!m_started)
+    {
+        m_started = true;
+        m_firstSequence = sequence;
+        m_highestSequence = sequence;
+        m_lastPublishUs = hostTimestampUs;
+    }
+    else
+    {
+        // Extend to 64 bits: the signed 32-bit distance from the highest sequence so far
+        const qint64 extended = m_highestSequence + qint32(sequence - quint32(m_highestSequence));
+
+        if (m_highestSequence - extended > RestartThreshold)
+        {
+            // The sender restarted its counter; keep the loss seen so far and start a new span
+            m_lostBeforeRestart = framesLost();
+            m_firstSequence = sequence;
+            m_highestSequence = sequence;
+            m_received = 0;
+            m_minimumOffsetUs = std::numeric_limits<qint64>::max();
+        }
+        else if (extended > m_highestSequence)
+        {
+            m_highestSequence = extended;
+        }
+    }
+
+    m_received++;
+
+    // Transit time up to the unknown clock offset, which the running minimum cancels out
+    const qint64 offsetUs = hostTimestampUs - qint64(senderTimestampUs);
+    if (offsetUs < m_minimumOffsetUs)
+    {
+        m_minimumOffsetUs = offsetUs;
+    }
+    const double latencyUs = double(offsetUs - m_minimumOffsetUs);
+    m_latencyUs += LatencySmoothing * (latencyUs - m_latencyUs);
+
+    if (hostTimestampUs - m_lastPublishUs >= PublishIntervalUs)
+    {
+        m_lastPublishUs = hostTimestampUs;
+        return true;
+    }
+    return false;
+}
+
+qint64 LinkStatistics::framesLost() const
+{
+    if (!m_started)
+    {
+        return m_lostBeforeRestart;
+    }
+
+    const qint64 expected = m_highestSequence - m_firstSequence + 1;
+    return m_lostBeforeRestart + qMax<qint64>(0, expected - m_received);
+}
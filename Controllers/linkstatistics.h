@@ -0,0 +1,54 @@
+#ifndef LINKSTATISTICS_H
+#define LINKSTATISTICS_H
+
+#include <QtGlobal>
+#include "telemetrywireformat.h"
+
+/**
+ * @brief The LinkStatistics class derives packet loss and latency from sequenced frames
+ *
+ * Loss is the number of sequence numbers missing between the first and the highest frame
+ * seen, so frames reordered by parallel parsing are not counted as lost. The 32-bit wire
+ * sequence is extended to 64 bits to survive wrap-around, and a large backwards jump is
+ * treated as a sender restart.
+ *
+ * The car's clock is not synchronised with ours, so latency is reported relative to the
+ * fastest transit observed since the last reset: (host time - sender time) minus its minimum.
+ * That removes the clock offset and leaves queueing and network delay.
+ */
+class LinkStatistics
+{
+public:
+    static constexpr qint64 RestartThreshold = TelemetryWireFormat::SequenceRestartThreshold;
+    static constexpr qint64 PublishIntervalUs = 250000;
+
+    LinkStatistics();
+
+    void reset();
+
+    /**
+     * @brief Account for one received sequenced frame
+     * @param sequence Wire sequence number
+     * @param senderTimestampUs Sender clock at transmission
+     * @param hostTimestampUs Monotonic host clock when the frame was decoded
+     * @return True when the figures are due to be republished (at most every PublishIntervalUs)
+     */
+    bool record(quint32 sequence, quint64 senderTimestampUs, qint64 hostTimestampUs);
+
+    qint64 framesReceived() const { return m_received; }
+    qint64 framesLost() const;
+    double latencyMs() const { return m_latencyUs / 1000.0; }
+
+private:
+    bool m_started;
+    qint64 m_firstSequence;
+    qint64 m_highestSequence;
+    qint64 m_received;
+    qint64 m_lostBeforeRestart;
+
+    qint64 m_minimumOffsetUs;
+    double m_latencyUs; // Exponentially smoothed
+    qint64 m_lastPublishUs;
+};
+
+#endif // LINKSTATISTICS_H
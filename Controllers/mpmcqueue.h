@@ -0,0 +1,146 @@
+#ifndef MPMCQUEUE_H
+#define MPMCQUEUE_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief The BoundedMpmcQueue class is a bounded, lock-free multi-producer/multi-consumer queue
+ *
+ * Every slot carries a sequence number that tells producers and consumers whether the slot
+ * is free for the current lap of the ring (D. Vyukov's bounded MPMC design). Push and pop
+ * each cost one CAS on the shared index plus one release store on the slot, and never block.
+ * The capacity is rounded up to a power of two. Pair it with an EventCount when consumers
+ * need to sleep while the queue is empty.
+ */
+template <typename T>
+class BoundedMpmcQueue
+{
+public:
+    explicit BoundedMpmcQueue(std::size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          m_mask(m_capacity - 1),
+          m_slots(new Slot[m_capacity])
+    {
+        for (std::size_t i = 0; i < m_capacity; ++i)
+        {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue &) = delete;
+    BoundedMpmcQueue &operator=(const BoundedMpmcQueue &) = delete;
+
+    /**
+     * @brief Append an item from any thread
+     * @return False if the queue is full; the item is left untouched
+     */
+    template <typename U>
+    bool tryPush(U &&item)
+    {
+        std::size_t position = m_enqueuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Slot &slot = m_slots[position & m_mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position);
+
+            if (difference == 0)
+            {
+                if (m_enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.value = std::forward<U>(item);
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false; // The consumer of the previous lap has not freed this slot yet
+            }
+            else
+            {
+                position = m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Remove the oldest item from any thread
+     * @return False if the queue is empty
+     */
+    bool tryPop(T &item)
+    {
+        std::size_t position = m_dequeuePosition.load(std::memory_order_relaxed);
+
+        for (;;)
+        {
+            Slot &slot = m_slots[position & m_mask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t difference = std::ptrdiff_t(sequence) - std::ptrdiff_t(position + 1);
+
+            if (difference == 0)
+            {
+                if (m_dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    item = std::move(slot.value);
+                    slot.sequence.store(position + m_capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Approximate number of queued items; may be momentarily stale under contention
+     */
+    std::size_t sizeApprox() const
+    {
+        const std::size_t enqueued = m_enqueuePosition.load(std::memory_order_acquire);
+        const std::size_t dequeued = m_dequeuePosition.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool isEmpty() const { return sizeApprox() == 0; }
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    static constexpr std::size_t CacheLineSize = 64;
+
+    struct alignas(CacheLineSize) Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    static std::size_t roundUpToPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    alignas(CacheLineSize) std::atomic<std::size_t> m_enqueuePosition{0};
+    alignas(CacheLineSize) std::atomic<std::size_t> m_dequeuePosition{0};
+};
+
+#endif // MPMCQUEUE_H
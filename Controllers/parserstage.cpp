@@ -0,0 +1,525 @@
+#include "parserstage.h"
+#include "sessionrecorder.h"
+#include <QDebug>
+#include <QStringList>
+#include <QThread>
+
+/*ParserStage
+ * The parsing half of the pipeline shared by the UDP and MQTT clients. It keeps up to the maximum
+ * number of long-running UdpParserWorkers, stamps and spreads incoming datagrams over the bounded
+ * queues of the active ones, forwards their results, keeps the drop and parse error accounting
+ * and sizes the active set to the load.
+ */
+
+ParserStage::ParserStage(TelemetryFramePool *framePool, QObject *parent)
+    : QObject(parent),
+      m_framePool(framePool),
+      m_recorder(nullptr),
+      m_minimumThreads(1),
+      m_maximumThreads(QThread::idealThreadCount()),
+      m_queueCapacity(UdpParserWorker::DefaultQueueCapacity),
+      m_overflowPolicy(UdpParserWorker::DropNewest),
+      m_latestOnly(false),
+      m_debugMode(false),
+      m_activeWorkers(0),
+      m_nextWorker(0),
+      m_nextArrival(1),
+      m_overloadedTicks(0),
+      m_idleTicks(0),
+      m_utilisation(0.0),
+      m_parseTimeUs(0.0),
+      m_queueDepth(0),
+      m_reportedDrops(0),
+      m_reportedSteals(0),
+      m_reportedOverflows(0),
+      m_reportedUtilisation(0.0),
+      m_hasErrorSample(false)
+{
+    m_pool.setMaxThreadCount(m_maximumThreads);
+    m_pool.setExpiryTimeout(PoolExpiryMs); // Threads freed by retired workers do not linger
+
+    m_scalingTimer.setInterval(ScalingIntervalMs);
+    connect(&m_scalingTimer, &QTimer::timeout, this, &ParserStage::measureLoad);
+
+    m_statsTimer.setInterval(StatsIntervalMs);
+    connect(&m_statsTimer, &QTimer::timeout, this, &ParserStage::checkStatistics);
+}
+
+ParserStage::~ParserStage()
+{
+    stop();
+}
+
+void ParserStage::setThreadBounds(int minimum, int maximum)
+{
+    m_minimumThreads = qMax(1, minimum);
+    m_maximumThreads = qMax(m_minimumThreads, maximum);
+}
+
+void ParserStage::setQueueCapacity(int capacity)
+{
+    m_queueCapacity = qMax(2, capacity);
+}
+
+int ParserStage::queueCapacityPerWorker() const
+{
+    // Full queues may hold every buffer the producer and the parsers do not have in hand. The
+    // queues round their capacity up to a power of two, so the share is rounded down to one.
+    const int share = (m_bufferPool.capacity() - DispatchBatchReserve - m_maximumThreads) / m_maximumThreads;
+    int capacity = 2;
+    while (capacity * 2 <= share && capacity < m_queueCapacity)
+    {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+void ParserStage::setOverflowPolicy(UdpParserWorker::OverflowPolicy policy)
+{
+    m_overflowPolicy = policy;
+
+    for (UdpParserWorker *worker : m_workers)
+    {
+        worker->setOverflowPolicy(policy);
+    }
+}
+
+void ParserStage::setLatestOnly(bool enabled)
+{
+    m_latestOnly = enabled;
+
+    for (UdpParserWorker *worker : m_workers)
+    {
+        worker->setLatestOnly(enabled);
+    }
+}
+
+void ParserStage::start()
+{
+    stop();
+
+    m_pool.setMaxThreadCount(m_maximumThreads);
+
+    const int queueCapacity = queueCapacityPerWorker();
+    for (int i = 0; i < m_maximumThreads; ++i)
+    {
+        UdpParserWorker *worker = new UdpParserWorker(m_framePool, &m_bufferPool, m_debugMode, queueCapacity);
+        worker->setOverflowPolicy(m_overflowPolicy);
+        worker->setLatestOnly(m_latestOnly);
+
+        // Re-emitted on the parser thread; receivers connect with a queued connection
+        connect(worker, &UdpParserWorker::frameParsed, this, &ParserStage::frameParsed, Qt::DirectConnection);
+
+        m_workers.append(worker);
+    }
+
+    // Only the initial active set gets a thread; the others wait until the load calls for them
+    for (int i = 0; i < m_workers.size(); ++i)
+    {
+        UdpParserWorker *worker = m_workers[i];
+        worker->joinStealGroup(&m_workers, &m_wakeups);
+
+        if (i < m_minimumThreads)
+        {
+            worker->startOn(m_pool);
+        }
+        else
+        {
+            worker->retire();
+        }
+    }
+
+    m_activeWorkers.store(m_minimumThreads);
+    m_nextWorker = 0;
+    m_staging.assign(size_t(m_workers.size()), {});
+
+    m_lastBusyNanoseconds.assign(size_t(m_workers.size()), 0);
+    m_lastHandled.assign(size_t(m_workers.size()), 0);
+    m_overloadedTicks = 0;
+    m_idleTicks = 0;
+    m_utilisation = 0.0;
+    m_parseTimeUs = 0.0;
+    m_queueDepth = 0;
+    m_lastScalingDecision.clear();
+    m_scalingClock.start();
+    m_scalingTimer.start();
+
+    m_reportedDrops = 0;
+    m_reportedSteals = 0;
+    m_reportedOverflows = bufferOverflows(); // The pool outlives sessions
+    m_reportedErrors = QList<qint64>(UdpParserWorker::ParseErrorCount, 0);
+    m_lastErrorSample = UdpParserWorker::ErrorSample();
+    m_hasErrorSample = false;
+    m_reportedUtilisation = 0.0;
+    m_statsTimer.start();
+
+    if (m_debugMode)
+    {
+        qDebug() << "Started" << m_minimumThreads << "of up to" << m_maximumThreads
+                 << "parsers with queue capacity" << queueCapacity << "of" << m_queueCapacity << "requested";
+    }
+
+    emit scalingChanged();
+}
+
+void ParserStage::stop()
+{
+    m_statsTimer.stop();
+    m_scalingTimer.stop();
+
+    // Stop all parsers and wait for their run() to return
+    m_activeWorkers.store(0);
+    for (UdpParserWorker *worker : m_workers)
+    {
+        worker->stop();
+    }
+    m_pool.waitForDone();
+
+    const bool wasRunning = !m_workers.isEmpty();
+    qDeleteAll(m_workers);
+    m_workers.clear();
+    m_staging.clear();
+
+    if (wasRunning)
+    {
+        emit scalingChanged();
+    }
+}
+
+bool ParserStage::dispatch(const QByteArray &data)
+{
+    const quint64 arrival = m_nextArrival.fetch_add(1, std::memory_order_relaxed);
+    if (m_recorder)
+    {
+        m_recorder->record(data, arrival);
+    }
+
+    const int active = m_activeWorkers.load(std::memory_order_acquire);
+    if (active == 0)
+    {
+        return false;
+    }
+
+    // The active set may have shrunk since the last call
+    if (m_nextWorker >= active)
+    {
+        m_nextWorker = 0;
+    }
+
+    UdpParserWorker *worker = m_workers[m_nextWorker];
+    m_nextWorker = (m_nextWorker + 1) % active;
+
+    return worker->queueDatagram(data, arrival);
+}
+
+void ParserStage::dispatchBatch(DatagramBuffer **buffers, int count)
+{
+    // Recorded before the parsers take the buffers over
+    quint64 arrival = m_nextArrival.fetch_add(quint64(count), std::memory_order_relaxed);
+    if (m_recorder)
+    {
+        m_recorder->recordBatch(buffers, count, arrival);
+    }
+
+    const int active = m_activeWorkers.load(std::memory_order_acquire);
+    if (active == 0)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            m_bufferPool.release(buffers[i]);
+        }
+        return;
+    }
+
+    if (m_nextWorker >= active)
+    {
+        m_nextWorker = 0;
+    }
+
+    // Round-robin into per-parser batches; the stamps keep the original order for the sequencer
+    for (int i = 0; i < count; ++i)
+    {
+        m_staging[size_t(m_nextWorker)].push_back(
+            QueuedDatagram{buffers[i], arrival++});
+        m_nextWorker = (m_nextWorker + 1) % active;
+    }
+
+    for (int i = 0; i < active; ++i)
+    {
+        std::vector<QueuedDatagram> &staging = m_staging[size_t(i)];
+        if (!staging.empty())
+        {
+            m_workers[i]->publishBatch(staging.data(), int(staging.size()));
+            staging.clear();
+        }
+    }
+}
+
+qint64 ParserStage::datagramsDropped() const
+{
+    qint64 total = 0;
+    for (const UdpParserWorker *worker : m_workers)
+    {
+        total += qint64(worker->datagramsDropped());
+    }
+    return total;
+}
+
+QList<qint64> ParserStage::datagramsDroppedPerParser() const
+{
+    QList<qint64> drops;
+    drops.reserve(m_workers.size());
+
+    for (const UdpParserWorker *worker : m_workers)
+    {
+        drops.append(qint64(worker->datagramsDropped()));
+    }
+    return drops;
+}
+
+qint64 ParserStage::datagramsStolen() const
+{
+    qint64 total = 0;
+    for (const UdpParserWorker *worker : m_workers)
+    {
+        total += qint64(worker->datagramsStolen());
+    }
+    return total;
+}
+
+qint64 ParserStage::ingestAllocations() const
+{
+    qint64 total = 0;
+    for (const UdpParserWorker *worker : m_workers)
+    {
+        total += qint64(worker->ingestAllocations());
+    }
+    return total;
+}
+
+void ParserStage::checkStatistics()
+{
+    reportParseErrors();
+
+    const qint64 drops = datagramsDropped();
+    const qint64 steals = datagramsStolen();
+    const qint64 overflows = bufferOverflows();
+    if (drops != m_reportedDrops || steals != m_reportedSteals || overflows != m_reportedOverflows
+        || qAbs(m_utilisation - m_reportedUtilisation) >= 0.05)
+    {
+        m_reportedDrops = drops;
+        m_reportedSteals = steals;
+        m_reportedOverflows = overflows;
+        m_reportedUtilisation = m_utilisation;
+        emit statisticsChanged();
+    }
+}
+
+QList<qint64> ParserStage::parseErrorCounts() const
+{
+    QList<qint64> counts(UdpParserWorker::ParseErrorCount, 0);
+    for (const UdpParserWorker *worker : m_workers)
+    {
+        for (int reason = 0; reason < UdpParserWorker::ParseErrorCount; ++reason)
+        {
+            counts[reason] += qint64(worker->parseErrors(UdpParserWorker::ParseError(reason)));
+        }
+    }
+    return counts;
+}
+
+QString ParserStage::parseErrorName(UdpParserWorker::ParseError reason)
+{
+    switch (reason)
+    {
+    case UdpParserWorker::BinaryTooShort:
+        return QStringLiteral("binary-too-short");
+    case UdpParserWorker::UnsupportedVersion:
+        return QStringLiteral("unsupported-version");
+    case UdpParserWorker::WrongFieldCount:
+        return QStringLiteral("wrong-field-count");
+    case UdpParserWorker::BadValue:
+        return QStringLiteral("bad-value");
+    case UdpParserWorker::ParserException:
+    case UdpParserWorker::ParseErrorCount:
+        break;
+    }
+    return QStringLiteral("exception");
+}
+
+QString ParserStage::describeSample(const UdpParserWorker::ErrorSample &sample)
+{
+    QString text;
+    text.reserve(sample.payload.size() + 32);
+
+    for (char ch : sample.payload)
+    {
+        const uchar byte = uchar(ch);
+        if (byte >= 0x20 && byte < 0x7f)
+        {
+            text += QLatin1Char(ch);
+        }
+        else
+        {
+            text += QStringLiteral("\\x%1").arg(byte, 2, 16, QLatin1Char('0'));
+        }
+    }
+
+    if (sample.size > sample.payload.size())
+    {
+        text += QStringLiteral("... (%1 bytes)").arg(sample.size);
+    }
+    return text;
+}
+
+void ParserStage::reportParseErrors()
+{
+    const QList<qint64> counts = parseErrorCounts();
+
+    QStringList reasons;
+    qint64 rejected = 0;
+    for (int reason = 0; reason < counts.size(); ++reason)
+    {
+        const qint64 delta = counts[reason] - m_reportedErrors.value(reason);
+        if (delta > 0)
+        {
+            rejected += delta;
+            reasons << QStringLiteral("%1 %2").arg(parseErrorName(UdpParserWorker::ParseError(reason))).arg(delta);
+        }
+    }
+
+    if (rejected == 0)
+    {
+        return;
+    }
+    m_reportedErrors = counts;
+
+    // Keep the first sample and free every worker's slot so the next interval gets a fresh one
+    bool sampled = false;
+    UdpParserWorker::ErrorSample sample;
+    for (UdpParserWorker *worker : m_workers)
+    {
+        if (worker->takeErrorSample(sample) && !sampled)
+        {
+            m_lastErrorSample = sample;
+            m_hasErrorSample = true;
+            sampled = true;
+        }
+    }
+
+    QString summary = QStringLiteral("Rejected %1 malformed datagrams (%2)").arg(rejected).arg(reasons.join(QStringLiteral(", ")));
+    if (sampled)
+    {
+        summary += QStringLiteral("; sample [%1]: %2")
+                       .arg(parseErrorName(m_lastErrorSample.reason), describeSample(m_lastErrorSample));
+    }
+
+    emit parseErrorsChanged();
+    emit errorOccurred(summary);
+}
+
+void ParserStage::measureLoad()
+{
+    const qint64 elapsedNs = m_scalingClock.nsecsElapsed();
+    m_scalingClock.restart();
+    if (elapsedNs <= 0 || m_workers.isEmpty())
+    {
+        return;
+    }
+
+    const int active = m_activeWorkers.load();
+    quint64 busyNs = 0;
+    quint64 handled = 0;
+    int depth = 0;
+
+    // Every worker is sampled so that the baselines stay current across scaling changes
+    for (int i = 0; i < m_workers.size(); ++i)
+    {
+        UdpParserWorker *worker = m_workers[i];
+        const quint64 busy = worker->busyNanoseconds();
+        const quint64 done = worker->datagramsHandled();
+        const int queued = worker->queueDepth();
+
+        if (i < active)
+        {
+            busyNs += busy - m_lastBusyNanoseconds[size_t(i)];
+            handled += done - m_lastHandled[size_t(i)];
+            depth += queued;
+
+            // Restart a worker whose retirement raced with its reactivation
+            worker->startOn(m_pool);
+        }
+        else if (queued > 0)
+        {
+            // Retired with datagrams still queued: let it drain them
+            worker->startOn(m_pool);
+        }
+
+        m_lastBusyNanoseconds[size_t(i)] = busy;
+        m_lastHandled[size_t(i)] = done;
+    }
+
+    m_utilisation = double(busyNs) / (double(elapsedNs) * active);
+    if (handled > 0)
+    {
+        m_parseTimeUs = double(busyNs) / double(handled) / 1000.0;
+    }
+    m_queueDepth = depth;
+
+    // How long the last queued datagram waits if the active workers share the queue evenly
+    const double queueDelayUs = double(depth) / active * m_parseTimeUs;
+
+    if (m_utilisation > ScaleUpUtilisation || queueDelayUs > ScaleUpDelayUs)
+    {
+        m_idleTicks = 0;
+        if (++m_overloadedTicks >= ScaleUpTicks && active < m_maximumThreads)
+        {
+            setActiveWorkers(active + 1, QStringLiteral("added parser: utilisation %1%, queue delay %2 us")
+                                             .arg(qRound(m_utilisation * 100)).arg(qRound(queueDelayUs)));
+        }
+    }
+    else if (m_utilisation < ScaleDownUtilisation && queueDelayUs < ScaleDownDelayUs)
+    {
+        m_overloadedTicks = 0;
+        if (++m_idleTicks >= ScaleDownTicks && active > m_minimumThreads)
+        {
+            setActiveWorkers(active - 1, QStringLiteral("retired parser: utilisation %1%, queue delay %2 us")
+                                             .arg(qRound(m_utilisation * 100)).arg(qRound(queueDelayUs)));
+        }
+    }
+    else
+    {
+        // In the dead band between the thresholds: keep the current size
+        m_overloadedTicks = 0;
+        m_idleTicks = 0;
+    }
+}
+
+void ParserStage::setActiveWorkers(int count, const QString &reason)
+{
+    const int active = m_activeWorkers.load();
+
+    if (count > active)
+    {
+        UdpParserWorker *worker = m_workers[active];
+        worker->activate();
+        worker->startOn(m_pool);
+    }
+    else
+    {
+        // The producer stops picking it at its next dispatch; what is already queued still gets parsed
+        m_workers[count]->retire();
+    }
+
+    m_activeWorkers.store(count, std::memory_order_release);
+    m_overloadedTicks = 0;
+    m_idleTicks = 0;
+    m_lastScalingDecision = reason;
+
+    if (m_debugMode)
+    {
+        qDebug() << "Parser stage:" << reason << "->" << count << "active";
+    }
+
+    emit scalingChanged();
+}
@@ -0,0 +1,261 @@
+#ifndef PARSERSTAGE_H
+#define PARSERSTAGE_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QThreadPool>
+#include <QTimer>
+#include <atomic>
+#include <vector>
+#include "datagrambufferpool.h"
+#include "eventcount.h"
+#include "udpparserworker.h"
+
+class SessionRecorder;
+class TelemetryFramePool;
+
+/**
+ * @brief The ParserStage class owns the parser workers of a client and distributes datagrams to them
+ *
+ * Datagrams are stamped with their arrival order and spread round-robin over the bounded
+ * queues of the active workers. What happens when a queue is full is decided by the overflow
+ * policy, and every discarded datagram is counted per worker. The workers form one steal
+ * group: a worker whose queue is empty takes datagrams from its siblings' queues, so a parser
+ * that is descheduled or stuck on a slow datagram does not build up a private backlog.
+ * Payloads travel in buffers of the stage's DatagramBufferPool, which the producer fills and
+ * the parsers return, so steady ingestion does not allocate. The pool also bounds the queues:
+ * start() shrinks each queue so that all of them full, plus a producer batch and one datagram
+ * in every parser's hands, never need more buffers than the pool has. A backlog is then met by
+ * the overflow policy instead of heap allocations.
+ *
+ * Rejected datagrams are only counted by reason on the parser threads. Once per
+ * StatsIntervalMs the stage sums the counters and, if anything was rejected, emits one
+ * errorOccurred() summary with a sample of an offending payload, so a noisy link cannot
+ * flood the GUI thread with per-packet messages.
+ *
+ * The number of active workers scales between the configured minimum and maximum. Every
+ * ScalingIntervalMs the stage measures how busy the active workers were and how long the
+ * queued datagrams will wait (queue depth times the average parse time):
+ * - it adds a worker when utilisation or queueing delay stays above the upper threshold for
+ *   ScaleUpTicks consecutive measurements;
+ * - it retires one when both stay below the lower threshold for ScaleDownTicks measurements.
+ * The wide gap between the thresholds and the tick counts is the hysteresis; after every
+ * change the counts start over. A retired worker parses what is still queued and then gives
+ * its thread back to the pool, and idle pool threads exit after PoolExpiryMs, so an idle
+ * session is left with minimum-count sleeping parsers.
+ *
+ * With a SessionRecorder attached, every dispatched datagram is also teed into the session log,
+ * stamped with the same arrival number the parsers see.
+ *
+ * dispatch() and dispatchBatch() may be called from one producer thread at a time, e.g. the
+ * UDP receiver thread; everything else belongs to the thread the stage lives in. A producer
+ * on another thread must be detached before stop() is called.
+ */
+class ParserStage : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int StatsIntervalMs = 1000;
+    static constexpr int ScalingIntervalMs = 250;
+    static constexpr int ScaleUpTicks = 2;   // 0.5 s of sustained load before adding a worker
+    static constexpr int ScaleDownTicks = 8; // 2 s of sustained idleness before retiring one
+    static constexpr double ScaleUpUtilisation = 0.75;
+    static constexpr double ScaleDownUtilisation = 0.25;
+    static constexpr double ScaleUpDelayUs = 2000.0;  // Estimated queueing delay that calls for another worker
+    static constexpr double ScaleDownDelayUs = 200.0;
+    static constexpr int PoolExpiryMs = 5000;
+    static constexpr int DispatchBatchReserve = 64; // Buffers a producer may hold while filling a batch
+
+    explicit ParserStage(TelemetryFramePool *framePool, QObject *parent = nullptr);
+    ~ParserStage();
+
+    /**
+     * @brief Bound the number of active workers; takes effect on the next start()
+     *
+     * Equal bounds pin the worker count and disable scaling.
+     */
+    void setThreadBounds(int minimum, int maximum);
+    void setThreadCount(int count) { setThreadBounds(count, count); }
+    int minimumThreads() const { return m_minimumThreads; }
+    int maximumThreads() const { return m_maximumThreads; }
+    int threadCount() const { return m_maximumThreads; }
+
+    /**
+     * @brief Requested capacity of each parser queue; takes effect on the next start()
+     *
+     * The queues get at most their share of the buffer pool, see queueCapacityPerWorker().
+     */
+    void setQueueCapacity(int capacity);
+    int queueCapacity() const { return m_queueCapacity; }
+
+    /**
+     * @brief Capacity each parser queue gets on start(): the requested one, bounded by the buffer pool
+     */
+    int queueCapacityPerWorker() const;
+    void setOverflowPolicy(UdpParserWorker::OverflowPolicy policy);
+    UdpParserWorker::OverflowPolicy overflowPolicy() const { return m_overflowPolicy; }
+    void setLatestOnly(bool enabled);
+    void setDebugMode(bool enabled) { m_debugMode = enabled; }
+
+    void start();
+    void stop();
+    bool isRunning() const { return !m_workers.isEmpty(); }
+
+    /**
+     * @brief Pool that dispatchBatch() buffers must come from. Safe to use from any thread.
+     */
+    DatagramBufferPool *bufferPool() { return &m_bufferPool; }
+
+    /**
+     * @brief Tee dispatched datagrams into @p recorder, which records only while it is started
+     *
+     * Set it before the first dispatch; the recorder must outlive the stage's producers.
+     */
+    void setRecorder(SessionRecorder *recorder) { m_recorder = recorder; }
+
+    /**
+     * @brief Arrival stamp the next dispatched datagram will get; stamps only ever grow
+     */
+    quint64 nextArrival() const { return m_nextArrival.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Hand a copy of one datagram to the next active parser
+     * @return False if it was dropped
+     */
+    bool dispatch(const QByteArray &data);
+
+    /**
+     * @brief Hand a batch of datagrams to the active parsers, waking each parser at most once
+     * @param buffers Buffers taken from bufferPool(); the parsers take them over
+     * @param count Number of datagrams in the batch
+     */
+    void dispatchBatch(DatagramBuffer **buffers, int count);
+
+    /**
+     * @brief Datagrams discarded by full queues since start(), in total and per parser
+     */
+    qint64 datagramsDropped() const;
+    QList<qint64> datagramsDroppedPerParser() const;
+
+    /**
+     * @brief Datagrams parsed by a worker other than the one they were dispatched to, since start()
+     */
+    qint64 datagramsStolen() const;
+
+    /**
+     * @brief Heap allocations on the parser side of the ingest path since start(); debug builds only
+     */
+    qint64 ingestAllocations() const;
+
+    /**
+     * @brief Datagrams rejected since start(), indexed by UdpParserWorker::ParseError
+     */
+    QList<qint64> parseErrorCounts() const;
+
+    /**
+     * @brief The most recent rejected datagram sampled by the summary, if any
+     */
+    const UdpParserWorker::ErrorSample &lastErrorSample() const { return m_lastErrorSample; }
+    bool hasErrorSample() const { return m_hasErrorSample; }
+
+    /**
+     * @brief Stable, QML-friendly name of a parse error reason, e.g. "wrong-field-count"
+     */
+    static QString parseErrorName(UdpParserWorker::ParseError reason);
+
+    /**
+     * @brief Render a sampled payload as printable text; other bytes become \xHH escapes
+     */
+    static QString describeSample(const UdpParserWorker::ErrorSample &sample);
+
+    /**
+     * @brief Payload buffers served from the heap because the pool was empty or too small, ever
+     */
+    qint64 bufferOverflows() const { return qint64(m_bufferPool.overflowAllocations()); }
+
+    // Autoscaler figures from the last measurement
+    int activeWorkers() const { return m_activeWorkers.load(std::memory_order_relaxed); }
+    double utilisation() const { return m_utilisation; }
+    double parseTimeUs() const { return m_parseTimeUs; }
+    int queueDepth() const { return m_queueDepth; }
+    QString lastScalingDecision() const { return m_lastScalingDecision; }
+
+signals:
+    /**
+     * @brief Emitted from a parser thread for every parsed frame; the receiver must release it to the pool
+     */
+    void frameParsed(TelemetryFrame *frame);
+
+    /**
+     * @brief At most once per StatsIntervalMs: a summary of the datagrams rejected in that interval
+     */
+    void errorOccurred(const QString &error);
+
+    /**
+     * @brief Emitted with errorOccurred() when the parse error counters or the sample changed
+     */
+    void parseErrorsChanged();
+
+    /**
+     * @brief Emitted at most every StatsIntervalMs when the drop or steal counters or the load changed
+     */
+    void statisticsChanged();
+
+    /**
+     * @brief Emitted when the active worker count changes, by the autoscaler or by start()/stop()
+     */
+    void scalingChanged();
+
+private slots:
+    void checkStatistics();
+    void measureLoad();
+
+private:
+    void setActiveWorkers(int count, const QString &reason);
+    void reportParseErrors();
+
+    TelemetryFramePool *m_framePool;
+    SessionRecorder *m_recorder;
+    DatagramBufferPool m_bufferPool; // Outlives the workers, which are deleted in stop()
+    QThreadPool m_pool;
+    QList<UdpParserWorker *> m_workers; // maximumThreads() workers; the first activeWorkers() receive datagrams
+    EventCount m_wakeups;               // Shared by the steal group; any idle worker may answer a push
+
+    int m_minimumThreads;
+    int m_maximumThreads;
+    int m_queueCapacity;
+    UdpParserWorker::OverflowPolicy m_overflowPolicy;
+    bool m_latestOnly;
+    bool m_debugMode;
+
+    // Producer state (the dispatching thread only, apart from the atomics)
+    std::atomic<int> m_activeWorkers;
+    int m_nextWorker;
+    std::atomic<quint64> m_nextArrival; // Never reset, so stamps stay monotonic across restarts
+    std::vector<std::vector<QueuedDatagram>> m_staging; // One pending batch per parser
+
+    // Autoscaler state (stage thread only)
+    QTimer m_scalingTimer;
+    QElapsedTimer m_scalingClock;
+    std::vector<quint64> m_lastBusyNanoseconds;
+    std::vector<quint64> m_lastHandled;
+    int m_overloadedTicks;
+    int m_idleTicks;
+    double m_utilisation;
+    double m_parseTimeUs;
+    int m_queueDepth;
+    QString m_lastScalingDecision;
+
+    QTimer m_statsTimer;
+    qint64 m_reportedDrops;
+    qint64 m_reportedSteals;
+    qint64 m_reportedOverflows;
+    double m_reportedUtilisation;
+    QList<qint64> m_reportedErrors;
+    UdpParserWorker::ErrorSample m_lastErrorSample;
+    bool m_hasErrorSample;
+};
+
+#endif // PARSERSTAGE_H
@@ -0,0 +1,240 @@
+#include "replayclient.h"
+#include <QDebug>
+
+/*ReplayClient
+ * Plays a session log back through the shared parse/publish path. The replay worker takes the
+ * receiver's place on its own thread and dispatches straight into the parser stage; this class
+ * only forwards control calls and collects the worker's statistics. Calls that change what the
+ * worker dispatches next (open, seek, detaching the stage) block until the worker has done them,
+ * so the session reset that follows a seek cleanly separates old and new datagrams.
+ */
+
+ReplayClient::ReplayClient(QObject *parent)
+    : TelemetrySource(parent),
+      m_generation(0),
+      m_debugMode(false),
+      m_speed(1.0),
+      m_paused(false),
+      m_finished(false),
+      m_durationUs(0),
+      m_recordCount(0),
+      m_positionUs(0),
+      m_replayRate(0.0),
+      m_datagramsReplayed(0)
+{
+    m_worker = new ReplayWorker();
+    m_worker->moveToThread(&m_replayThread);
+
+    connect(m_worker, &ReplayWorker::finished, this, &ReplayClient::handleFinished, Qt::QueuedConnection);
+    connect(m_worker, &ReplayWorker::statisticsUpdated, this, &ReplayClient::handleStatistics, Qt::QueuedConnection);
+    connect(m_worker, &ReplayWorker::errorOccurred, this, &ReplayClient::handleError, Qt::QueuedConnection);
+    connect(&parserStage(), &ParserStage::errorOccurred, this, &ReplayClient::handleError, Qt::QueuedConnection);
+
+    connect(&m_replayThread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_replayThread.setObjectName("Replay Thread");
+}
+
+ReplayClient::~ReplayClient()
+{
+    stop();
+
+    if (m_replayThread.isRunning())
+    {
+        m_replayThread.quit();
+        m_replayThread.wait();
+    }
+}
+
+bool ReplayClient::start(const QString &path)
+{
+    stop();
+
+    m_replayThread.start();
+    parserStage().start();
+    resetSession();
+
+    m_datagramsReplayed = 0;
+    m_positionUs = 0;
+    m_replayRate = 0.0;
+    setFinished(false);
+    if (m_paused)
+    {
+        m_paused = false;
+        emit pausedChanged();
+    }
+
+    ReplayWorker *worker = m_worker;
+    const double speed = m_speed;
+    bool opened = false;
+    quint32 generation = 0;
+    QString sessionName;
+    qint64 durationUs = 0;
+    qint64 records = 0;
+    QMetaObject::invokeMethod(worker, [&]() {
+        worker->setSpeed(speed);
+        worker->setPaused(false);
+        opened = worker->open(path);
+        generation = worker->generation();
+
+        const SessionLogReader &reader = worker->reader();
+        sessionName = reader.header().sessionName;
+        durationUs = reader.lastTimestampUs() - reader.firstTimestampUs();
+        records = reader.recordCount();
+    }, Qt::BlockingQueuedConnection);
+    m_generation = generation;
+
+    if (!opened)
+    {
+        parserStage().stop();
+        return false;
+    }
+
+    m_sessionName = sessionName;
+    m_durationUs = durationUs;
+    m_recordCount = records;
+    emit replayOpened();
+
+    attachStageToWorker(&parserStage());
+
+    if (m_debugMode)
+    {
+        qDebug() << "Replaying" << path << "with" << parserStage().threadCount() << "parser threads";
+    }
+
+    emit replayStatisticsChanged();
+    return true;
+}
+
+bool ReplayClient::stop()
+{
+    if (m_replayThread.isRunning())
+    {
+        // Detach first: the worker must not touch the parsers once they are stopped
+        attachStageToWorker(nullptr);
+
+        ReplayWorker *worker = m_worker;
+        QMetaObject::invokeMethod(worker, [worker]() { worker->close(); }, Qt::BlockingQueuedConnection);
+    }
+
+    parserStage().stop();
+    return true;
+}
+
+void ReplayClient::seek(double seconds)
+{
+    if (!m_replayThread.isRunning())
+    {
+        return;
+    }
+
+    ReplayWorker *worker = m_worker;
+    const qint64 positionUs = qint64(seconds * 1e6);
+    quint32 generation = 0;
+    QMetaObject::invokeMethod(worker, [worker, positionUs, &generation]() {
+        worker->seek(positionUs);
+        generation = worker->generation();
+    }, Qt::BlockingQueuedConnection);
+    m_generation = generation;
+
+    // The worker dispatches nothing until resume(), so the session boundary falls exactly on the new position
+    resetSession();
+    setFinished(false);
+    QMetaObject::invokeMethod(worker, [worker]() { worker->resume(); }, Qt::QueuedConnection);
+}
+
+void ReplayClient::setSpeed(double speed)
+{
+    speed = qMax(0.0, speed);
+    if (qFuzzyCompare(m_speed + 1.0, speed + 1.0))
+    {
+        return;
+    }
+
+    m_speed = speed;
+    QMetaObject::invokeMethod(m_worker, "setSpeed", Qt::QueuedConnection, Q_ARG(double, speed));
+    emit speedChanged();
+}
+
+void ReplayClient::setPaused(bool paused)
+{
+    if (m_paused == paused)
+    {
+        return;
+    }
+
+    m_paused = paused;
+    QMetaObject::invokeMethod(m_worker, "setPaused", Qt::QueuedConnection, Q_ARG(bool, paused));
+    emit pausedChanged();
+}
+
+void ReplayClient::setParserThreadCount(int count)
+{
+    // A fixed count pins the parser pool; otherwise it scales with the load
+    if (count > 0)
+    {
+        setParserThreadBounds(count, count);
+    }
+}
+
+void ReplayClient::setDebugMode(bool enabled)
+{
+    m_debugMode = enabled;
+    parserStage().setDebugMode(enabled);
+}
+
+void ReplayClient::attachStageToWorker(ParserStage *stage)
+{
+    ReplayWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [worker, stage]() { worker->setParserStage(stage); }, Qt::BlockingQueuedConnection);
+}
+
+void ReplayClient::setFinished(bool finished)
+{
+    if (m_finished == finished)
+    {
+        return;
+    }
+
+    m_finished = finished;
+    emit finishedChanged();
+}
+
+void ReplayClient::handleFinished(quint32 generation)
+{
+    if (generation != m_generation)
+    {
+        return;
+    }
+
+    if (m_debugMode)
+    {
+        qDebug() << "Replay finished after" << m_datagramsReplayed << "datagrams";
+    }
+
+    setFinished(true);
+}
+
+void ReplayClient::handleStatistics(const ReplayStats &stats)
+{
+    // Counted regardless of the generation; only the position of an older one is stale
+    m_datagramsReplayed += qint64(stats.datagrams);
+    if (stats.generation != m_generation)
+    {
+        emit replayStatisticsChanged();
+        return;
+    }
+
+    m_positionUs = stats.positionUs;
+    m_replayRate = stats.intervalMs > 0 ? stats.datagrams * 1000.0 / stats.intervalMs : 0.0;
+    emit replayStatisticsChanged();
+}
+
+void ReplayClient::handleError(const QString &error)
+{
+    if (m_debugMode)
+    {
+        qDebug() << "Replay error:" << error;
+    }
+
+    emit errorOccurred(error);
+}
@@ -0,0 +1,103 @@
+#ifndef REPLAYCLIENT_H
+#define REPLAYCLIENT_H
+
+#include <QObject>
+#include <QThread>
+#include "replayworker.h"
+#include "telemetrysource.h"
+
+/**
+ * @brief The ReplayClient class plays a recorded session log back through the telemetry pipeline
+ *
+ * It is a TelemetrySource like UdpClient and MqttClient, so every page that takes a data client
+ * works with it unchanged. A ReplayWorker on a dedicated thread stands in for the network and
+ * dispatches the logged datagrams into the parser stage; parsing, sequencing and publishing are
+ * the live code paths.
+ *
+ * Playback runs at @c speed times the recorded pace, or as fast as the parsers go with speed 0,
+ * which makes an unthrottled replay an end-to-end throughput measurement without a network or
+ * broker (see benchmarks/replay_benchmark). Seeking starts a new session, so the history, the
+ * GPS track and the link statistics only cover data from the new position on.
+ */
+class ReplayClient : public TelemetrySource
+{
+    Q_OBJECT
+    Q_PROPERTY(QString sessionName READ sessionName NOTIFY replayOpened)
+    Q_PROPERTY(double duration READ duration NOTIFY replayOpened)
+    Q_PROPERTY(qint64 recordCount READ recordCount NOTIFY replayOpened)
+    Q_PROPERTY(double position READ position NOTIFY replayStatisticsChanged)
+    Q_PROPERTY(double replayRate READ replayRate NOTIFY replayStatisticsChanged)
+    Q_PROPERTY(qint64 datagramsReplayed READ datagramsReplayed NOTIFY replayStatisticsChanged)
+    Q_PROPERTY(double speed READ speed WRITE setSpeed NOTIFY speedChanged)
+    Q_PROPERTY(bool paused READ paused WRITE setPaused NOTIFY pausedChanged)
+    Q_PROPERTY(bool finished READ finished NOTIFY finishedChanged)
+
+public:
+    explicit ReplayClient(QObject *parent = nullptr);
+    ~ReplayClient();
+
+    /**
+     * @brief Start replaying the session log at @p path from its beginning
+     * @return False if the log cannot be opened; the reason is emitted with errorOccurred()
+     */
+    Q_INVOKABLE bool start(const QString &path);
+    Q_INVOKABLE bool stop();
+
+    /**
+     * @brief Continue from @p seconds into the log, measured from its first record
+     */
+    Q_INVOKABLE void seek(double seconds);
+
+    Q_INVOKABLE void setParserThreadCount(int count);
+    Q_INVOKABLE void setDebugMode(bool enabled);
+
+    /**
+     * @brief Playback speed relative to the recording; 0 replays as fast as possible
+     */
+    void setSpeed(double speed);
+    double speed() const { return m_speed; }
+
+    void setPaused(bool paused);
+    bool paused() const { return m_paused; }
+    bool finished() const { return m_finished; }
+
+    QString sessionName() const { return m_sessionName; }
+    double duration() const { return m_durationUs / 1e6; }
+    qint64 recordCount() const { return m_recordCount; }
+    double position() const { return m_positionUs / 1e6; }
+    double replayRate() const { return m_replayRate; }
+    qint64 datagramsReplayed() const { return m_datagramsReplayed; }
+
+signals:
+    void replayOpened();
+    void replayStatisticsChanged();
+    void speedChanged();
+    void pausedChanged();
+    void finishedChanged();
+
+private slots:
+    void handleFinished(quint32 generation);
+    void handleStatistics(const ReplayStats &stats);
+    void handleError(const QString &error);
+
+private:
+    void attachStageToWorker(ParserStage *stage);
+    void setFinished(bool finished);
+
+    QThread m_replayThread;
+    ReplayWorker *m_worker;
+    quint32 m_generation; // Worker generation of the current position; older signals are ignored
+    bool m_debugMode;
+
+    double m_speed;
+    bool m_paused;
+    bool m_finished;
+    QString m_sessionName;
+    qint64 m_durationUs;
+    qint64 m_recordCount;
+    qint64 m_positionUs;
+    double m_replayRate;
+    qint64 m_datagramsReplayed;
+};
+
+#endif // REPLAYCLIENT_H
@@ -0,0 +1,239 @@
+#include "replayworker.h"
+#include "parserstage.h"
+
+/*ReplayWorker
+ * The replay counterpart of the UdpReceiverWorker. It lives on its own thread, reads records
+ * straight out of the memory-mapped log and dispatches them in batches into the parser stage's
+ * inboxes, released either on the recorded schedule (scaled by the speed) or as fast as the
+ * stage takes them. Work is done in short slices driven by a timer, so the thread's event loop
+ * stays free for control calls from the client.
+ */
+
+ReplayWorker::ReplayWorker(QObject *parent)
+    : QObject(parent),
+      m_parserStage(nullptr),
+      m_bufferPool(nullptr),
+      m_pumpTimer(this),
+      m_speed(1.0),
+      m_paused(false),
+      m_finished(false),
+      m_generation(0),
+      m_anchorRecordUs(0),
+      m_anchorClockUs(0)
+{
+    m_pending.reserve(BatchSize);
+
+    m_pumpTimer.setSingleShot(true);
+    m_pumpTimer.setTimerType(Qt::PreciseTimer);
+    connect(&m_pumpTimer, &QTimer::timeout, this, &ReplayWorker::pump);
+
+    m_clock.start();
+    m_statsTimer.start();
+}
+
+ReplayWorker::~ReplayWorker()
+{
+    close();
+}
+
+void ReplayWorker::setParserStage(ParserStage *stage)
+{
+    // Nothing may be left pending in the old stage's buffers
+    flushDispatch();
+
+    m_parserStage = stage;
+    m_bufferPool = stage ? stage->bufferPool() : nullptr;
+
+    if (m_parserStage && m_reader.isOpen() && !m_paused)
+    {
+        restartPacing();
+        m_pumpTimer.start(0);
+    }
+}
+
+bool ReplayWorker::open(const QString &path)
+{
+    close();
+
+    if (!m_reader.open(path))
+    {
+        emit errorOccurred(m_reader.errorString());
+        return false;
+    }
+
+    m_finished = false;
+    m_generation++;
+    m_stats = ReplayStats();
+    m_statsTimer.restart();
+
+    restartPacing();
+    if (!m_paused)
+    {
+        m_pumpTimer.start(0);
+    }
+    return true;
+}
+
+void ReplayWorker::close()
+{
+    m_pumpTimer.stop();
+    flushDispatch();
+    m_reader.close();
+}
+
+void ReplayWorker::setSpeed(double speed)
+{
+    m_speed = qMax(0.0, speed);
+
+    // Continue from the current record at the new pace
+    restartPacing();
+    if (m_reader.isOpen() && !m_paused)
+    {
+        m_pumpTimer.start(0);
+    }
+}
+
+void ReplayWorker::setPaused(bool paused)
+{
+    m_paused = paused;
+
+    if (m_paused)
+    {
+        m_pumpTimer.stop();
+        publishStatistics();
+        return;
+    }
+
+    restartPacing();
+    if (m_reader.isOpen())
+    {
+        m_pumpTimer.start(0);
+    }
+}
+
+void ReplayWorker::seek(qint64 positionUs)
+{
+    if (!m_reader.isOpen())
+    {
+        return;
+    }
+
+    // Stays stopped until resume(), so nothing of the new position is dispatched before the client resets
+    m_pumpTimer.stop();
+
+    // pump() never returns with datagrams pending, so nothing of the old position is left over
+    flushDispatch();
+    publishStatistics();
+
+    m_reader.seekToTime(m_reader.firstTimestampUs() + qMax<qint64>(0, positionUs));
+    m_finished = false;
+    m_generation++;
+    publishStatistics();
+}
+
+void ReplayWorker::resume()
+{
+    if (!m_reader.isOpen() || m_paused)
+    {
+        return;
+    }
+
+    restartPacing();
+    m_pumpTimer.start(0);
+}
+
+void ReplayWorker::pump()
+{
+    if (!m_reader.isOpen() || !m_parserStage || m_paused || m_finished)
+    {
+        return;
+    }
+
+    const qint64 sliceEndUs = m_clock.nsecsElapsed() / 1000 + MaxSliceMs * 1000;
+    SessionLogReader::Record record;
+
+    for (;;)
+    {
+        if (!m_reader.peek(record))
+        {
+            flushDispatch();
+            m_finished = true;
+            publishStatistics();
+            emit finished(m_generation);
+            return;
+        }
+
+        if (m_speed > 0.0)
+        {
+            // Sleep until the next record is due; everything already due goes out as one batch
+            const qint64 dueUs = m_anchorClockUs + qint64(double(record.hostTimestampUs - m_anchorRecordUs) / m_speed);
+            const qint64 nowUs = m_clock.nsecsElapsed() / 1000;
+            if (dueUs > nowUs)
+            {
+                flushDispatch();
+                if (m_statsTimer.elapsed() >= StatsIntervalMs)
+                {
+                    publishStatistics();
+                }
+                m_pumpTimer.start(int((dueUs - nowUs + 999) / 1000));
+                return;
+            }
+        }
+
+        m_pending.push_back(m_bufferPool->acquireCopy(record.data, record.size));
+        m_stats.datagrams++;
+        m_stats.bytes += quint64(record.size);
+        m_reader.advance(record);
+
+        if (int(m_pending.size()) >= BatchSize)
+        {
+            flushDispatch();
+
+            // Give the event loop a turn, e.g. for a pause or seek
+            if (m_clock.nsecsElapsed() / 1000 >= sliceEndUs)
+            {
+                if (m_statsTimer.elapsed() >= StatsIntervalMs)
+                {
+                    publishStatistics();
+                }
+                m_pumpTimer.start(0);
+                return;
+            }
+        }
+    }
+}
+
+void ReplayWorker::restartPacing()
+{
+    SessionLogReader::Record record;
+    m_anchorClockUs = m_clock.nsecsElapsed() / 1000;
+    m_anchorRecordUs = m_reader.peek(record) ? record.hostTimestampUs : 0;
+}
+
+void ReplayWorker::flushDispatch()
+{
+    if (!m_parserStage || m_pending.empty())
+    {
+        return;
+    }
+
+    m_parserStage->dispatchBatch(m_pending.data(), int(m_pending.size()));
+    m_pending.clear();
+}
+
+qint64 ReplayWorker::positionUs() const
+{
+    SessionLogReader::Record record;
+    const qint64 timestampUs = m_reader.peek(record) ? record.hostTimestampUs : m_reader.lastTimestampUs();
+    return timestampUs - m_reader.firstTimestampUs();
+}
+
+void ReplayWorker::publishStatistics()
+{
+    m_stats.generation = m_generation;
+    m_stats.positionUs = positionUs();
+    m_stats.intervalMs = m_statsTimer.restart();
+    emit statisticsUpdated(m_stats);
+
+    m_stats = ReplayStats();
+}
@@ -0,0 +1,140 @@
+#ifndef REPLAYWORKER_H
+#define REPLAYWORKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <vector>
+#include "sessionlogreader.h"
+
+class DatagramBufferPool;
+class ParserStage;
+struct DatagramBuffer;
+
+/**
+ * @brief Replay statistics for one reporting interval of the ReplayWorker
+ */
+struct ReplayStats
+{
+    quint32 generation = 0; // ReplayWorker::generation() the figures belong to
+    qint64 positionUs = 0;  // Receive time of the next record, relative to the first one
+    quint64 datagrams = 0;  // Datagrams injected in the interval
+    quint64 bytes = 0;
+    qint64 intervalMs = 0;
+};
+Q_DECLARE_METATYPE(ReplayStats)
+
+/**
+ * @brief The ReplayWorker class injects the datagrams of a session log into a parser stage
+ *
+ * It takes the place of the UdpReceiverWorker on its own thread: records are copied into
+ * buffers of the stage's pool and handed over with ParserStage::dispatchBatch(), so replayed
+ * datagrams take exactly the path of live ones from there on.
+ *
+ * With a positive speed, a record is released when speed times the time since the replay
+ * (re)started has caught up with its recorded receive time, so 1.0 reproduces the original
+ * pacing and gaps. Records that are due together go out as one batch, and the worker sleeps on
+ * a precise timer until the next one is due. A speed of 0 replays as fast as the parsers
+ * accept datagrams. Either way the worker returns to its event loop at least every
+ * MaxSliceMs, so pause, seek and speed changes are handled promptly.
+ */
+class ReplayWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BatchSize = 64; // Matches BatchDatagramReader::DefaultBatchSize
+    static constexpr int MaxSliceMs = 5;
+    static constexpr int StatsIntervalMs = 250;
+
+    explicit ReplayWorker(QObject *parent = nullptr);
+    ~ReplayWorker();
+
+    /**
+     * @brief Feed this stage; pass nullptr before the stage stops. Worker thread only.
+     */
+    void setParserStage(ParserStage *stage);
+
+    /**
+     * @brief Open a session log and start replaying it from the beginning. Worker thread only.
+     * @return False if it cannot be read; the reason is emitted with errorOccurred()
+     */
+    bool open(const QString &path);
+
+    void close();
+
+    /**
+     * @brief Reposition on the first record at or after @p positionUs into the log. Worker thread only.
+     *
+     * Datagrams of the old position that were not handed over yet are dispatched first. The
+     * worker then stays stopped until resume(), so the stage's nextArrival() in between is the
+     * first arrival stamp of the new position and the client can reset its session on it.
+     */
+    void seek(qint64 positionUs);
+
+    /**
+     * @brief Start dispatching again after seek(); does nothing while paused. Worker thread only.
+     */
+    void resume();
+
+    /**
+     * @brief The open log. Worker thread only.
+     */
+    const SessionLogReader &reader() const { return m_reader; }
+
+    /**
+     * @brief Incremented by every open() and seek(); signals carry it so stale ones can be told apart
+     */
+    quint32 generation() const { return m_generation; }
+
+public slots:
+    /**
+     * @brief Replay at @p speed times the recorded pace; 0 replays as fast as possible
+     */
+    void setSpeed(double speed);
+
+    void setPaused(bool paused);
+
+signals:
+    /**
+     * @brief Emitted once the last record of @p generation was dispatched
+     */
+    void finished(quint32 generation);
+
+    void errorOccurred(const QString &error);
+
+    /**
+     * @brief Emitted every StatsIntervalMs while replaying, and after seeking or finishing
+     */
+    void statisticsUpdated(const ReplayStats &stats);
+
+private slots:
+    void pump();
+
+private:
+    void restartPacing();
+    void flushDispatch();
+    void publishStatistics();
+    qint64 positionUs() const;
+
+    SessionLogReader m_reader;
+    ParserStage *m_parserStage;
+    DatagramBufferPool *m_bufferPool;
+    std::vector<DatagramBuffer *> m_pending;
+
+    QTimer m_pumpTimer;
+    QElapsedTimer m_clock;
+    double m_speed;
+    bool m_paused;
+    bool m_finished;
+    quint32 m_generation;
+
+    // Pacing anchor: the record time that was due at m_anchorClockUs on m_clock
+    qint64 m_anchorRecordUs;
+    qint64 m_anchorClockUs;
+
+    QElapsedTimer m_statsTimer;
+    ReplayStats m_stats;
+};
+
+#endif // REPLAYWORKER_H
@@ -0,0 +1,130 @@
+#ifndef SEQLOCKSNAPSHOT_H
+#define SEQLOCKSNAPSHOT_H
+
+#include <QtGlobal>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * @brief The SeqLockSnapshot class publishes the latest value of a trivially copyable struct to any number of readers
+ *
+ * One writer at a time calls store() (writers on several threads must serialize it themselves);
+ * any thread may call load() and always gets one whole value, never a mix of two stores. The
+ * writer never waits for readers. Values are kept in a small ring of sequence-locked slots:
+ * store() fills the slot after the current one and then publishes it, so a reader copying the
+ * current slot only has to retry if the writer laps the entire ring during that one copy. In
+ * practice load() completes in a single pass.
+ *
+ * The payload is copied word by word through relaxed atomics, which keeps concurrent reads and
+ * writes free of data races while compiling to plain loads and stores.
+ */
+template <typename T, int SlotCount = 4>
+class SeqLockSnapshot
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLockSnapshot copies values bytewise");
+    static_assert(SlotCount >= 2, "The writer needs a slot other than the published one");
+
+public:
+    SeqLockSnapshot()
+        : m_latest(0),
+          m_version(0)
+    {
+        const T initial{};
+        for (Slot &slot : m_slots)
+        {
+            slot.sequence.store(0, std::memory_order_relaxed);
+            writeWords(slot, initial);
+        }
+    }
+
+    SeqLockSnapshot(const SeqLockSnapshot &) = delete;
+    SeqLockSnapshot &operator=(const SeqLockSnapshot &) = delete;
+
+    /**
+     * @brief Publish a new value. One writer at a time; never blocks.
+     */
+    void store(const T &value)
+    {
+        const int index = (m_latest.load(std::memory_order_relaxed) + 1) % SlotCount;
+        Slot &slot = m_slots[size_t(index)];
+
+        // Odd sequence: slot is being written
+        const quint32 sequence = slot.sequence.load(std::memory_order_relaxed);
+        slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        writeWords(slot, value);
+
+        slot.sequence.store(sequence + 2, std::memory_order_release);
+        m_latest.store(index, std::memory_order_release);
+        m_version.fetch_add(1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read the most recently published value. Any thread.
+     */
+    T load() const
+    {
+        for (;;)
+        {
+            const Slot &slot = m_slots[size_t(m_latest.load(std::memory_order_acquire))];
+
+            const quint32 before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                continue; // The writer lapped the ring and is refilling this slot
+            }
+
+            T value;
+            readWords(slot, value);
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+            {
+                return value;
+            }
+        }
+    }
+
+    /**
+     * @brief Number of values stored so far; lets pollers skip work when nothing changed
+     */
+    quint64 version() const { return m_version.load(std::memory_order_acquire); }
+
+private:
+    static constexpr size_t WordCount = (sizeof(T) + sizeof(quint64) - 1) / sizeof(quint64);
+
+    struct alignas(64) Slot
+    {
+        std::atomic<quint32> sequence;
+        std::array<std::atomic<quint64>, WordCount> words;
+    };
+
+    static void writeWords(Slot &slot, const T &value)
+    {
+        quint64 buffer[WordCount] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            slot.words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+
+    static void readWords(const Slot &slot, T &value)
+    {
+        quint64 buffer[WordCount];
+        for (size_t i = 0; i < WordCount; ++i)
+        {
+            buffer[i] = slot.words[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(&value, buffer, sizeof(T));
+    }
+
+    std::array<Slot, SlotCount> m_slots;
+    alignas(64) std::atomic<int> m_latest;
+    std::atomic<quint64> m_version;
+};
+
+#endif // SEQLOCKSNAPSHOT_H
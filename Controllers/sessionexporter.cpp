@@ -0,0 +1,366 @@
+#include "sessionexporter.h"
+#include "columncodec.h"
+#include "telemetrychannels.h"
+#include "telemetrycsvparser.h"
+#include "telemetrywireformat.h"
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/*SessionExporter
+ * Streams a session log into the columnar export. Values are stored little-endian into the
+ * column buffers as rows arrive; a chunk's minimum and maximum are found in one pass over each
+ * column when the chunk is written, which keeps the per-row work to a handful of stores.
+ */
+
+namespace
+{
+// The first two columns; the channels follow in table order
+enum FixedColumn
+{
+    TimestampColumn,
+    ArrivalColumn,
+    FixedColumnCount
+};
+
+template <typename T>
+constexpr ColumnarSessionFormat::ColumnType columnTypeOf()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return ColumnarSessionFormat::Float32;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return ColumnarSessionFormat::Float64;
+    }
+    else if constexpr (std::is_same_v<T, quint64>)
+    {
+        return ColumnarSessionFormat::UInt64;
+    }
+    else if constexpr (std::is_same_v<T, qint64>)
+    {
+        return ColumnarSessionFormat::Int64;
+    }
+    else
+    {
+        static_assert(std::is_same_v<T, int>, "No column type for this channel type");
+        return ColumnarSessionFormat::Int32;
+    }
+}
+
+template <typename T>
+void writeValue(char *out, T value)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        qToLittleEndian<quint32>(std::bit_cast<quint32>(value), out);
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        qToLittleEndian<quint64>(std::bit_cast<quint64>(value), out);
+    }
+    else
+    {
+        qToLittleEndian<T>(value, out);
+    }
+}
+
+template <typename T>
+T readValue(const char *data)
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return std::bit_cast<float>(qFromLittleEndian<quint32>(data));
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return std::bit_cast<double>(qFromLittleEndian<quint64>(data));
+    }
+    else
+    {
+        return qFromLittleEndian<T>(data);
+    }
+}
+
+// Minimum and maximum of @p rows values, as the 8-byte footer representation of their type
+template <typename T>
+void bounds(const char *data, int rows, quint64 &minimum, quint64 &maximum)
+{
+    using Wide = std::conditional_t<std::is_floating_point_v<T>, double, std::conditional_t<std::is_signed_v<T>, qint64, quint64>>;
+
+    Wide low = std::numeric_limits<Wide>::max();
+    Wide high = std::numeric_limits<Wide>::lowest();
+    bool any = false;
+    for (int i = 0; i < rows; ++i)
+    {
+        const Wide value = Wide(readValue<T>(data + qsizetype(i) * qsizetype(sizeof(T))));
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (std::isnan(value))
+            {
+                continue;
+            }
+        }
+
+        low = value < low ? value : low;
+        high = value > high ? value : high;
+        any = true;
+    }
+
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (!any)
+        {
+            low = high = std::numeric_limits<double>::quiet_NaN();
+        }
+        minimum = std::bit_cast<quint64>(low);
+        maximum = std::bit_cast<quint64>(high);
+    }
+    else
+    {
+        if (!any)
+        {
+            low = high = 0;
+        }
+        minimum = quint64(low);
+        maximum = quint64(high);
+    }
+}
+
+bool decodeDatagram(const SessionLogReader::Record &record, TelemetryFrame &frame)
+{
+    if (TelemetryWireFormat::isBinary(record.data, record.size))
+    {
+        return TelemetryWireFormat::decode(record.data, record.size, frame) == TelemetryWireFormat::Ok;
+    }
+
+    return TelemetryCsvParser::parse(record.data, record.data + record.size, frame).status == TelemetryCsvParser::Ok;
+}
+} // namespace
+
+SessionExporter::SessionExporter()
+    : m_chunkRows(DefaultChunkRows),
+      m_compress(true),
+      m_rows(0),
+      m_offset(0)
+{
+}
+
+std::vector<ColumnarSessionFormat::Column> SessionExporter::columns()
+{
+    std::vector<ColumnarSessionFormat::Column> columns;
+    columns.push_back({QByteArrayLiteral("hostTimestampUs"), ColumnarSessionFormat::Int64});
+    columns.push_back({QByteArrayLiteral("arrival"), ColumnarSessionFormat::UInt64});
+
+    forEachTelemetryChannel([&](const auto &channel, int) {
+        using Type = typename std::decay_t<decltype(channel)>::Type;
+        columns.push_back({QByteArray(channel.name), columnTypeOf<Type>()});
+    });
+    return columns;
+}
+
+bool SessionExporter::exportSession(const QString &logPath, const QString &outputPath, const Options &options,
+                                    const ProgressFunction &progress)
+{
+    m_statistics = Statistics();
+    m_errorString.clear();
+
+    if (!m_reader.open(logPath))
+    {
+        m_errorString = m_reader.errorString();
+        return false;
+    }
+
+    m_output.setFileName(outputPath);
+    if (!m_output.open(QIODevice::WriteOnly))
+    {
+        m_errorString = QString("Cannot create %1: %2").arg(outputPath, m_output.errorString());
+        m_reader.close();
+        return false;
+    }
+
+    // Bounded so a column chunk, even compressed at worst, fits the footer's u32 size
+    m_chunkRows = qBound(1, options.chunkRows, MaximumChunkRows);
+    m_compress = options.compress;
+    m_rows = 0;
+    m_offset = 0;
+    m_footer.clear();
+    m_columns.clear();
+    for (const ColumnarSessionFormat::Column &column : columns())
+    {
+        ColumnBuffer buffer;
+        buffer.column = column;
+        buffer.width = ColumnarSessionFormat::typeSize(column.type);
+        buffer.data.resize(size_t(m_chunkRows) * size_t(buffer.width));
+        m_columns.push_back(std::move(buffer));
+    }
+
+    ColumnarSessionFormat::Header header;
+    header.startWallClockMs = m_reader.header().startWallClockMs;
+    header.startMonotonicUs = m_reader.header().startMonotonicUs;
+    header.sessionName = m_reader.header().sessionName;
+    for (const ColumnBuffer &buffer : m_columns)
+    {
+        header.columns.push_back(buffer.column);
+    }
+    const QByteArray encodedHeader = ColumnarSessionFormat::encodeHeader(header);
+    bool ok = write(encodedHeader.constData(), encodedHeader.size());
+
+    const qint64 first = m_reader.firstTimestampUs();
+    const qint64 last = options.toUs < 0 ? std::numeric_limits<qint64>::max() : first + options.toUs;
+    if (options.fromUs > 0)
+    {
+        m_reader.seekToTime(first + options.fromUs);
+    }
+
+    SessionLogReader::Record record;
+    while (ok && m_reader.next(record) && record.hostTimestampUs <= last)
+    {
+        m_statistics.records++;
+
+        TelemetryFrame frame;
+        if (!decodeDatagram(record, frame))
+        {
+            m_statistics.rejected++;
+            continue;
+        }
+
+        appendRow(record, frame);
+        if (m_rows == m_chunkRows)
+        {
+            ok = flushChunk();
+            if (ok && progress)
+            {
+                progress(m_statistics);
+            }
+        }
+    }
+
+    if (ok && m_rows > 0)
+    {
+        ok = flushChunk();
+        if (ok && progress)
+        {
+            progress(m_statistics);
+        }
+    }
+
+    if (ok)
+    {
+        ColumnarSessionFormat::Trailer trailer;
+        trailer.chunkCount = quint32(m_statistics.chunks);
+        trailer.footerOffset = m_offset;
+        const QByteArray encodedTrailer = ColumnarSessionFormat::encodeTrailer(trailer);
+        ok = write(m_footer.constData(), m_footer.size()) && write(encodedTrailer.constData(), encodedTrailer.size());
+    }
+
+    if (ok && !m_output.commit())
+    {
+        m_errorString = QString("Cannot write %1: %2").arg(outputPath, m_output.errorString());
+        ok = false;
+    }
+    else if (!ok)
+    {
+        m_output.cancelWriting();
+        m_output.commit();
+    }
+
+    // Give the chunk buffers back; an exporter may sit idle between exports
+    m_columns.clear();
+    m_footer.clear();
+    m_encoded.clear();
+    m_reader.close();
+    return ok;
+}
+
+void SessionExporter::appendRow(const SessionLogReader::Record &record, const TelemetryFrame &frame)
+{
+    const qsizetype row = m_rows;
+    writeValue<qint64>(m_columns[TimestampColumn].data.data() + row * 8, record.hostTimestampUs);
+    writeValue<quint64>(m_columns[ArrivalColumn].data.data() + row * 8, record.arrival);
+
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        using Type = typename std::decay_t<decltype(channel)>::Type;
+        writeValue<Type>(m_columns[FixedColumnCount + index].data.data() + row * qsizetype(sizeof(Type)), frame.*channel.member);
+    });
+
+    m_rows++;
+    m_statistics.rows++;
+}
+
+bool SessionExporter::flushChunk()
+{
+    QByteArray entry(ColumnarSessionFormat::ChunkEntryHeaderSize + qsizetype(m_columns.size()) * ColumnarSessionFormat::ColumnEntrySize,
+                     Qt::Uninitialized);
+    qToLittleEndian<quint32>(quint32(m_rows), entry.data());
+    qToLittleEndian<quint32>(0, entry.data() + 4);
+    char *out = entry.data() + ColumnarSessionFormat::ChunkEntryHeaderSize;
+
+    for (const ColumnBuffer &buffer : m_columns)
+    {
+        ColumnarSessionFormat::ColumnChunk chunk;
+        chunk.offset = m_offset;
+        chunk.size = quint32(m_rows) * quint32(buffer.width);
+        chunk.encoding = ColumnarSessionFormat::Plain;
+
+        const char *data = buffer.data.data();
+        switch (buffer.column.type)
+        {
+        case ColumnarSessionFormat::Int32:
+            bounds<qint32>(data, m_rows, chunk.minimum, chunk.maximum);
+            break;
+        case ColumnarSessionFormat::Int64:
+            bounds<qint64>(data, m_rows, chunk.minimum, chunk.maximum);
+            break;
+        case ColumnarSessionFormat::UInt64:
+            bounds<quint64>(data, m_rows, chunk.minimum, chunk.maximum);
+            break;
+        case ColumnarSessionFormat::Float32:
+            bounds<float>(data, m_rows, chunk.minimum, chunk.maximum);
+            break;
+        case ColumnarSessionFormat::Float64:
+            bounds<double>(data, m_rows, chunk.minimum, chunk.maximum);
+            break;
+        }
+
+        if (m_compress)
+        {
+            ColumnCodec::encode(buffer.column.type, data, m_rows, m_encoded);
+            if (m_encoded.size() < qsizetype(chunk.size))
+            {
+                data = m_encoded.constData();
+                chunk.size = quint32(m_encoded.size());
+                chunk.encoding = ColumnCodec::encodingFor(buffer.column.type);
+            }
+        }
+
+        m_statistics.plainBytes += qint64(m_rows) * buffer.width;
+        if (!write(data, chunk.size))
+        {
+            return false;
+        }
+
+        ColumnarSessionFormat::encodeColumnChunk(chunk, out);
+        out += ColumnarSessionFormat::ColumnEntrySize;
+    }
+
+    m_footer.append(entry);
+    m_statistics.chunks++;
+    m_rows = 0;
+    return true;
+}
+
+bool SessionExporter::write(const char *data, qint64 size)
+{
+    if (m_output.write(data, size) != size)
+    {
+        m_errorString = QString("Cannot write %1: %2").arg(m_output.fileName(), m_output.errorString());
+        return false;
+    }
+
+    m_offset += size;
+    m_statistics.bytesWritten = m_offset;
+    return true;
+}
@@ -0,0 +1,102 @@
+#ifndef SESSIONEXPORTER_H
+#define SESSIONEXPORTER_H
+
+#include <QByteArray>
+#include <QSaveFile>
+#include <QString>
+#include <functional>
+#include <vector>
+#include "columnarsessionformat.h"
+#include "sessionlogreader.h"
+#include "telemetryframe.h"
+
+/**
+ * @brief The SessionExporter class converts a session log into a ColumnarSessionFormat file
+ *
+ * Every datagram of the log is decoded like the parsers do (binary wire format or CSV) and
+ * becomes one row: the receive time, the arrival stamp and one column per telemetry channel,
+ * generated from TelemetryChannels. Rejected datagrams are counted and left out.
+ *
+ * The conversion streams: rows are gathered in per-column buffers of chunkRows values and
+ * written out chunk by chunk, so memory stays at one chunk plus the footer (a few dozen bytes
+ * per column per chunk) however long the session is. The log itself is read through
+ * SessionLogReader's file mapping, whose pages the OS can drop again at any time. A time range
+ * is found through the log's SessionLogIndex instead of scanning up to it.
+ *
+ * Column chunks are compressed with ColumnCodec unless Options::compress is off; a chunk that
+ * would not get smaller is stored Plain. The output is written to a temporary file and only
+ * replaces the target once complete.
+ */
+class SessionExporter
+{
+public:
+    static constexpr int DefaultChunkRows = 65536;
+    static constexpr int MaximumChunkRows = 1 << 24;
+
+    struct Options
+    {
+        qint64 fromUs = 0; // Start of the exported range, relative to the first record
+        qint64 toUs = -1;  // End of the range (inclusive), relative to the first record; negative for the end
+        int chunkRows = DefaultChunkRows;
+        bool compress = true;
+    };
+
+    struct Statistics
+    {
+        qint64 records = 0;  // Datagrams read from the log
+        qint64 rows = 0;     // Frames written
+        qint64 rejected = 0; // Datagrams neither decoder accepted
+        qint64 chunks = 0;
+        qint64 bytesWritten = 0;
+        qint64 plainBytes = 0; // Column data size before compression
+    };
+
+    using ProgressFunction = std::function<void(const Statistics &)>;
+
+    SessionExporter();
+
+    SessionExporter(const SessionExporter &) = delete;
+    SessionExporter &operator=(const SessionExporter &) = delete;
+
+    /**
+     * @brief Export the log at @p logPath to @p outputPath
+     * @param progress Called after every chunk written; may be empty
+     * @return False on a read or write error; see errorString()
+     */
+    bool exportSession(const QString &logPath, const QString &outputPath, const Options &options,
+                       const ProgressFunction &progress = ProgressFunction());
+
+    QString errorString() const { return m_errorString; }
+    const Statistics &statistics() const { return m_statistics; }
+
+    /**
+     * @brief The columns of an export, in file order
+     */
+    static std::vector<ColumnarSessionFormat::Column> columns();
+
+private:
+    struct ColumnBuffer
+    {
+        ColumnarSessionFormat::Column column;
+        int width = 0;
+        std::vector<char> data; // chunkRows little-endian values
+    };
+
+    void appendRow(const SessionLogReader::Record &record, const TelemetryFrame &frame);
+    bool flushChunk();
+    bool write(const char *data, qint64 size);
+
+    SessionLogReader m_reader;
+    QSaveFile m_output;
+    std::vector<ColumnBuffer> m_columns;
+    QByteArray m_footer;
+    QByteArray m_encoded; // Compressed column chunk, reused
+    int m_chunkRows;
+    bool m_compress;
+    int m_rows;      // Rows in the current chunk
+    qint64 m_offset; // File offset of the next write
+    Statistics m_statistics;
+    QString m_errorString;
+};
+
+#endif // SESSIONEXPORTER_H
@@ -0,0 +1,126 @@
+#ifndef SESSIONLOGFORMAT_H
+#define SESSIONLOGFORMAT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtEndian>
+#include <cstring>
+
+/**
+ * @brief The SessionLogFormat class describes the append-only session log written by SessionRecorder
+ *
+ * A log is one file header followed by one record per received datagram, in arrival order.
+ * All multi-byte fields are little-endian and unaligned. Version 1 file header:
+ *
+ * | Offset | Type  | Field                                         |
+ * |--------|-------|-----------------------------------------------|
+ * | 0      | u8[8] | magic ("CDSESLOG")                            |
+ * | 8      | u16   | format version                                |
+ * | 10     | u16   | header size in bytes, including the name      |
+ * | 12     | u32   | flags (0)                                     |
+ * | 16     | i64   | wall clock at start (ms since the Unix epoch) |
+ * | 24     | i64   | host monotonic clock at start (µs)            |
+ * | 32     | u16   | session name length                           |
+ * | 34     | u8[]  | session name (UTF-8)                          |
+ *
+ * Record:
+ *
+ * | Offset | Type | Field                                                         |
+ * |--------|------|---------------------------------------------------------------|
+ * | 0      | i64  | host receive time (µs, TelemetryFrame::hostTimestampUs clock) |
+ * | 8      | u64  | arrival stamp assigned by the ParserStage                     |
+ * | 16     | u32  | payload size                                                  |
+ * | 20     | u8[] | datagram payload, as received                                 |
+ *
+ * A recording that was cut short (crash, power loss) ends in a truncated record; readers stop
+ * at the last complete one. Readers skip header bytes beyond the fields they know. Seek entries
+ * live in a separate file next to the log, described in SessionLogIndex.
+ */
+class SessionLogFormat
+{
+public:
+    static constexpr char Magic[8] = {'C', 'D', 'S', 'E', 'S', 'L', 'O', 'G'};
+    static constexpr quint16 Version = 1;
+    static constexpr int FixedHeaderSize = 34;
+    static constexpr int MaximumNameSize = 1024;
+    static constexpr int RecordHeaderSize = 20;
+    static constexpr const char *FileSuffix = ".cdlog";
+
+    struct Header
+    {
+        qint64 startWallClockMs = 0;
+        qint64 startMonotonicUs = 0;
+        QString sessionName;
+    };
+
+    struct RecordHeader
+    {
+        qint64 hostTimestampUs = 0;
+        quint64 arrival = 0;
+        quint32 size = 0;
+    };
+
+    /**
+     * @brief Serialize a file header; names longer than MaximumNameSize bytes are cut
+     */
+    static QByteArray encodeHeader(const Header &header)
+    {
+        const QByteArray name = header.sessionName.toUtf8().left(MaximumNameSize);
+        QByteArray out(FixedHeaderSize + name.size(), Qt::Uninitialized);
+        char *data = out.data();
+
+        std::memcpy(data, Magic, sizeof(Magic));
+        qToLittleEndian<quint16>(Version, data + 8);
+        qToLittleEndian<quint16>(quint16(out.size()), data + 10);
+        qToLittleEndian<quint32>(0, data + 12);
+        qToLittleEndian<qint64>(header.startWallClockMs, data + 16);
+        qToLittleEndian<qint64>(header.startMonotonicUs, data + 24);
+        qToLittleEndian<quint16>(quint16(name.size()), data + 32);
+        std::memcpy(data + FixedHeaderSize, name.constData(), size_t(name.size()));
+        return out;
+    }
+
+    /**
+     * @brief Parse a file header from the start of a log
+     * @param headerSize Receives the offset of the first record
+     * @return False if @p data does not start with a complete header of a known version
+     */
+    static bool decodeHeader(const char *data, qsizetype size, Header &header, int &headerSize)
+    {
+        if (size < FixedHeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0
+            || qFromLittleEndian<quint16>(data + 8) != Version)
+        {
+            return false;
+        }
+
+        headerSize = qFromLittleEndian<quint16>(data + 10);
+        const int nameSize = qFromLittleEndian<quint16>(data + 32);
+        if (headerSize < FixedHeaderSize + nameSize || size < headerSize)
+        {
+            return false;
+        }
+
+        header.startWallClockMs = qFromLittleEndian<qint64>(data + 16);
+        header.startMonotonicUs = qFromLittleEndian<qint64>(data + 24);
+        header.sessionName = QString::fromUtf8(data + FixedHeaderSize, nameSize);
+        return true;
+    }
+
+    static void encodeRecordHeader(const RecordHeader &record, char *out)
+    {
+        qToLittleEndian<qint64>(record.hostTimestampUs, out);
+        qToLittleEndian<quint64>(record.arrival, out + 8);
+        qToLittleEndian<quint32>(record.size, out + 16);
+    }
+
+    static RecordHeader decodeRecordHeader(const char *data)
+    {
+        RecordHeader record;
+        record.hostTimestampUs = qFromLittleEndian<qint64>(data);
+        record.arrival = qFromLittleEndian<quint64>(data + 8);
+        record.size = qFromLittleEndian<quint32>(data + 16);
+        return record;
+    }
+};
+
+#endif // SESSIONLOGFORMAT_H
@@ -0,0 +1,174 @@
+#include "sessionlogindex.h"
+#include "sessionlogreader.h"
+#include <QFile>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+/*SessionLogIndex
+ * Sparse seek table of a session log. Entries are appended in file order, so both receive times
+ * and arrival stamps are non-decreasing and can be binary searched.
+ */
+
+SessionLogIndex::SessionLogIndex()
+    : m_startWallClockMs(0),
+      m_records(0)
+{
+}
+
+void SessionLogIndex::reset(qint64 startWallClockMs)
+{
+    m_entries.clear();
+    m_startWallClockMs = startWallClockMs;
+    m_records = 0;
+}
+
+bool SessionLogIndex::observe(qint64 timestampUs, quint64 arrival, qint64 offset)
+{
+    const bool due = m_entries.empty() || timestampUs >= m_entries.back().timestampUs + IntervalUs
+                     || m_records - m_entries.back().record >= MaxRecordsPerEntry;
+    if (due)
+    {
+        m_entries.push_back(Entry{timestampUs, arrival, offset, m_records});
+    }
+
+    m_records++;
+    return due;
+}
+
+void SessionLogIndex::build(SessionLogReader &reader)
+{
+    reset(reader.header().startWallClockMs);
+    reader.rewind();
+
+    SessionLogReader::Record record;
+    qint64 offset = reader.offset();
+    while (reader.next(record))
+    {
+        observe(record.hostTimestampUs, record.arrival, offset);
+        offset = reader.offset();
+    }
+
+    reader.rewind();
+}
+
+const SessionLogIndex::Entry *SessionLogIndex::floorByTime(qint64 timestampUs) const
+{
+    if (m_entries.empty())
+    {
+        return nullptr;
+    }
+
+    // Records sharing a receive time can straddle an entry, so stop short of the first entry at the target
+    const auto at = std::lower_bound(m_entries.begin(), m_entries.end(), timestampUs,
+                                     [](const Entry &entry, qint64 value) { return entry.timestampUs < value; });
+    return at == m_entries.begin() ? &m_entries.front() : &*(at - 1);
+}
+
+const SessionLogIndex::Entry *SessionLogIndex::floorByArrival(quint64 arrival) const
+{
+    if (m_entries.empty())
+    {
+        return nullptr;
+    }
+
+    const auto at = std::lower_bound(m_entries.begin(), m_entries.end(), arrival,
+                                     [](const Entry &entry, quint64 value) { return entry.arrival < value; });
+    return at == m_entries.begin() ? &m_entries.front() : &*(at - 1);
+}
+
+QByteArray SessionLogIndex::encodeHeader() const
+{
+    QByteArray out(HeaderSize, Qt::Uninitialized);
+    char *data = out.data();
+
+    std::memcpy(data, Magic, sizeof(Magic));
+    qToLittleEndian<quint16>(Version, data + 8);
+    qToLittleEndian<quint16>(EntrySize, data + 10);
+    qToLittleEndian<quint32>(0, data + 12);
+    qToLittleEndian<qint64>(IntervalUs, data + 16);
+    qToLittleEndian<qint64>(m_startWallClockMs, data + 24);
+    return out;
+}
+
+QByteArray SessionLogIndex::encodeEntries(int first) const
+{
+    const int count = qMax(0, int(m_entries.size()) - first);
+    QByteArray out(qsizetype(count) * EntrySize, Qt::Uninitialized);
+    char *data = out.data();
+
+    for (int i = 0; i < count; ++i, data += EntrySize)
+    {
+        const Entry &entry = m_entries[size_t(first + i)];
+        qToLittleEndian<qint64>(entry.timestampUs, data);
+        qToLittleEndian<quint64>(entry.arrival, data + 8);
+        qToLittleEndian<qint64>(entry.offset, data + 16);
+        qToLittleEndian<qint64>(entry.record, data + 24);
+    }
+    return out;
+}
+
+bool SessionLogIndex::load(const QString &path, qint64 startWallClockMs)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+
+    const QByteArray contents = file.readAll();
+    const char *data = contents.constData();
+    if (contents.size() < HeaderSize || std::memcmp(data, Magic, sizeof(Magic)) != 0
+        || qFromLittleEndian<quint16>(data + 8) != Version || qFromLittleEndian<quint16>(data + 10) != EntrySize
+        || qFromLittleEndian<qint64>(data + 24) != startWallClockMs)
+    {
+        return false;
+    }
+
+    reset(startWallClockMs);
+
+    // A recorder that died mid-write leaves a partial last entry; ignore it
+    const qsizetype count = (contents.size() - HeaderSize) / EntrySize;
+    m_entries.reserve(size_t(count));
+    for (data += HeaderSize; m_entries.size() < size_t(count); data += EntrySize)
+    {
+        const Entry entry{qFromLittleEndian<qint64>(data), qFromLittleEndian<quint64>(data + 8),
+                          qFromLittleEndian<qint64>(data + 16), qFromLittleEndian<qint64>(data + 24)};
+
+        if (!m_entries.empty())
+        {
+            const Entry &previous = m_entries.back();
+            if (entry.offset <= previous.offset || entry.record <= previous.record || entry.timestampUs < previous.timestampUs)
+            {
+                m_entries.clear();
+                return false;
+            }
+        }
+        m_entries.push_back(entry);
+    }
+
+    // Records from the last entry on are counted again when the log's tail is observed
+    m_records = m_entries.empty() ? 0 : m_entries.back().record;
+    return true;
+}
+
+bool SessionLogIndex::save(const QString &path) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return false;
+    }
+
+    file.write(encodeHeader());
+    file.write(encodeEntries(0));
+    return file.commit();
+}
+
+QString SessionLogIndex::pathFor(const QString &logPath)
+{
+    const QLatin1String logSuffix(".cdlog");
+    const QString stem = logPath.endsWith(logSuffix) ? logPath.chopped(logSuffix.size()) : logPath;
+    return stem + QLatin1String(FileSuffix);
+}
@@ -0,0 +1,117 @@
+#ifndef SESSIONLOGINDEX_H
+#define SESSIONLOGINDEX_H
+
+#include <QByteArray>
+#include <QString>
+#include <vector>
+
+class SessionLogReader;
+
+/**
+ * @brief The SessionLogIndex class maps receive times and arrival stamps of a session log to file offsets
+ *
+ * The index is sparse: it holds one entry for the first record, then one whenever IntervalUs of
+ * receive time or MaxRecordsPerEntry records have passed since the previous entry. A seek is a
+ * binary search over the entries followed by a forward scan of at most one interval of records.
+ *
+ * Entries are keyed on the host receive time and the receiver's arrival stamp, not on the
+ * sequence number the car sends. The wire sequence restarts whenever the sender does, so it
+ * is not monotonic across a session and could not be binary searched; CSV datagrams carry
+ * none at all; and reading it would mean decoding every payload while recording. A frame's
+ * sequence number is found by seeking to its receive time or arrival and scanning forward.
+ *
+ * It is kept in a sidecar file next to the log (".cdidx" instead of ".cdlog"), which the
+ * SessionRecorder appends to as it writes blocks; entries never point past the data on disk.
+ * Logs without a usable sidecar are indexed by SessionLogReader on open. Little-endian layout:
+ *
+ * | Offset | Type  | Field                                                 |
+ * |--------|-------|-------------------------------------------------------|
+ * | 0      | u8[8] | magic ("CDSESIDX")                                    |
+ * | 8      | u16   | format version                                        |
+ * | 10     | u16   | entry size in bytes (32)                              |
+ * | 12     | u32   | flags (0)                                             |
+ * | 16     | i64   | interval (µs)                                         |
+ * | 24     | i64   | start wall clock of the indexed log                   |
+ * | 32     | entry | entries in file order: i64 receive time, u64 arrival, |
+ * |        |       | i64 record offset, i64 record number                  |
+ */
+class SessionLogIndex
+{
+public:
+    static constexpr char Magic[8] = {'C', 'D', 'S', 'E', 'S', 'I', 'D', 'X'};
+    static constexpr quint16 Version = 1;
+    static constexpr int HeaderSize = 32;
+    static constexpr int EntrySize = 32;
+    static constexpr qint64 IntervalUs = 1000000;
+    static constexpr qint64 MaxRecordsPerEntry = 8192;
+    static constexpr const char *FileSuffix = ".cdidx";
+
+    struct Entry
+    {
+        qint64 timestampUs;
+        quint64 arrival;
+        qint64 offset; // File offset of the record
+        qint64 record; // Number of records before it
+    };
+
+    SessionLogIndex();
+
+    /**
+     * @brief Start an empty index for the log whose header carries @p startWallClockMs
+     */
+    void reset(qint64 startWallClockMs);
+
+    /**
+     * @brief Account for the next record of the log, in file order
+     * @return True if it became an entry
+     */
+    bool observe(qint64 timestampUs, quint64 arrival, qint64 offset);
+
+    /**
+     * @brief Index every record of @p reader from its first one; leaves the reader rewound
+     */
+    void build(SessionLogReader &reader);
+
+    const std::vector<Entry> &entries() const { return m_entries; }
+    bool isEmpty() const { return m_entries.empty(); }
+
+    /**
+     * @brief Records observed so far, including those between entries
+     */
+    qint64 recordCount() const { return m_records; }
+
+    /**
+     * @brief The last entry received before @p timestampUs, or the first entry; nullptr if empty
+     */
+    const Entry *floorByTime(qint64 timestampUs) const;
+
+    /**
+     * @brief The last entry stamped before arrival @p arrival, or the first entry; nullptr if empty
+     */
+    const Entry *floorByArrival(quint64 arrival) const;
+
+    /**
+     * @brief Serialized sidecar header, and entries from @p first on
+     */
+    QByteArray encodeHeader() const;
+    QByteArray encodeEntries(int first) const;
+
+    /**
+     * @brief Read a sidecar file written for a log started at @p startWallClockMs
+     * @return False if it is missing, of another version, or belongs to another log
+     */
+    bool load(const QString &path, qint64 startWallClockMs);
+    bool save(const QString &path) const;
+
+    /**
+     * @brief Sidecar path of the log at @p logPath
+     */
+    static QString pathFor(const QString &logPath);
+
+private:
+    std::vector<Entry> m_entries;
+    qint64 m_startWallClockMs;
+    qint64 m_records;
+};
+
+#endif // SESSIONLOGINDEX_H
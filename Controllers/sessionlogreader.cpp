@@ -0,0 +1,185 @@
+#include "sessionlogreader.h"
+
+/*SessionLogReader
+ * Sequential and seekable access to a memory-mapped session log. Records are decoded in place;
+ * the reader only keeps the byte offset of the current one. A seek is a binary search of the sparse
+ * index followed by a short forward scan, so its cost does not grow with the length of the log.
+ */
+
+SessionLogReader::SessionLogReader()
+    : m_data(nullptr),
+      m_size(0),
+      m_firstRecordOffset(0),
+      m_offset(0),
+      m_firstTimestampUs(0),
+      m_lastTimestampUs(0),
+      m_recordCount(0)
+{
+}
+
+SessionLogReader::~SessionLogReader()
+{
+    close();
+}
+
+bool SessionLogReader::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        m_errorString = QString("Cannot open %1: %2").arg(path, m_file.errorString());
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : nullptr;
+    if (!m_data)
+    {
+        m_errorString = QString("Cannot map %1: %2").arg(path, m_file.errorString());
+        m_file.close();
+        return false;
+    }
+
+    int headerSize = 0;
+    if (!SessionLogFormat::decodeHeader(reinterpret_cast<const char *>(m_data), m_size, m_header, headerSize))
+    {
+        m_errorString = QString("%1 is not a session log").arg(path);
+        close();
+        return false;
+    }
+
+    m_firstRecordOffset = headerSize;
+    m_offset = headerSize;
+
+    // A matching sidecar leaves only the records after its last entry to scan
+    if (!loadIndex(path))
+    {
+        m_index.build(*this);
+        m_index.save(SessionLogIndex::pathFor(path)); // Best effort: the log may sit in a read-only place
+    }
+
+    Record record;
+    if (!m_index.isEmpty())
+    {
+        m_firstTimestampUs = m_index.entries().front().timestampUs;
+        seekToOffset(m_index.entries().back().offset);
+    }
+    while (next(record))
+    {
+        m_lastTimestampUs = record.hostTimestampUs;
+    }
+    m_recordCount = m_index.recordCount();
+
+    rewind();
+    return true;
+}
+
+bool SessionLogReader::loadIndex(const QString &path)
+{
+    if (!m_index.load(SessionLogIndex::pathFor(path), m_header.startWallClockMs) || m_index.isEmpty())
+    {
+        return false;
+    }
+
+    // The sidecar must describe this log: its last entry has to land on the record it names
+    const SessionLogIndex::Entry last = m_index.entries().back();
+    Record record;
+    if (m_index.entries().front().offset != m_firstRecordOffset || last.offset < m_firstRecordOffset
+        || !readAt(last.offset, record) || record.hostTimestampUs != last.timestampUs || record.arrival != last.arrival)
+    {
+        return false;
+    }
+
+    // Count the records after the last entry; a recorder that did not stop cleanly may have left many
+    seekToOffset(last.offset);
+    qint64 offset = m_offset;
+    while (next(record))
+    {
+        m_index.observe(record.hostTimestampUs, record.arrival, offset);
+        offset = m_offset;
+    }
+    return true;
+}
+
+void SessionLogReader::close()
+{
+    if (m_data)
+    {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+    }
+    m_file.close();
+
+    m_size = 0;
+    m_firstRecordOffset = 0;
+    m_offset = 0;
+    m_header = SessionLogFormat::Header();
+    m_firstTimestampUs = 0;
+    m_lastTimestampUs = 0;
+    m_recordCount = 0;
+    m_index.reset(0);
+}
+
+bool SessionLogReader::readAt(qint64 offset, Record &record) const
+{
+    if (offset + SessionLogFormat::RecordHeaderSize > m_size)
+    {
+        return false;
+    }
+
+    const char *at = reinterpret_cast<const char *>(m_data) + offset;
+    const SessionLogFormat::RecordHeader header = SessionLogFormat::decodeRecordHeader(at);
+
+    // A truncated last record ends the log
+    if (qint64(header.size) > m_size - offset - SessionLogFormat::RecordHeaderSize)
+    {
+        return false;
+    }
+
+    record.hostTimestampUs = header.hostTimestampUs;
+    record.arrival = header.arrival;
+    record.data = at + SessionLogFormat::RecordHeaderSize;
+    record.size = int(header.size);
+    return true;
+}
+
+bool SessionLogReader::next(Record &record)
+{
+    if (!readAt(m_offset, record))
+    {
+        return false;
+    }
+
+    advance(record);
+    return true;
+}
+
+void SessionLogReader::seekToTime(qint64 timestampUs)
+{
+    if (const SessionLogIndex::Entry *entry = m_index.floorByTime(timestampUs))
+    {
+        seekToOffset(entry->offset);
+    }
+
+    Record record;
+    while (peek(record) && record.hostTimestampUs < timestampUs)
+    {
+        advance(record);
+    }
+}
+
+void SessionLogReader::seekToArrival(quint64 arrival)
+{
+    if (const SessionLogIndex::Entry *entry = m_index.floorByArrival(arrival))
+    {
+        seekToOffset(entry->offset);
+    }
+
+    Record record;
+    while (peek(record) && record.arrival < arrival)
+    {
+        advance(record);
+    }
+}
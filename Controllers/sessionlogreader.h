@@ -0,0 +1,106 @@
+#ifndef SESSIONLOGREADER_H
+#define SESSIONLOGREADER_H
+
+#include <QFile>
+#include <QString>
+#include "sessionlogformat.h"
+#include "sessionlogindex.h"
+
+/**
+ * @brief The SessionLogReader class walks the records of a session log written by SessionRecorder
+ *
+ * The file is memory-mapped read-only, so reading a record neither copies nor issues a system
+ * call; the payload pointer stays valid until close(). A log that is still being written, or was
+ * cut short, ends at its last complete record.
+ *
+ * Seeks go through a SessionLogIndex: the recorder's sidecar when it matches the log, otherwise
+ * one built on open (and saved next to the log for the next time).
+ */
+class SessionLogReader
+{
+public:
+    struct Record
+    {
+        qint64 hostTimestampUs = 0;
+        quint64 arrival = 0;
+        const char *data = nullptr;
+        int size = 0;
+    };
+
+    SessionLogReader();
+    ~SessionLogReader();
+
+    SessionLogReader(const SessionLogReader &) = delete;
+    SessionLogReader &operator=(const SessionLogReader &) = delete;
+
+    /**
+     * @brief Map @p path and position the reader on the first record
+     * @return False if the file cannot be mapped or is not a session log; see errorString()
+     */
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_data != nullptr; }
+    QString errorString() const { return m_errorString; }
+
+    const SessionLogFormat::Header &header() const { return m_header; }
+
+    /**
+     * @brief Receive times of the first and the last complete record; 0 for an empty log
+     */
+    qint64 firstTimestampUs() const { return m_firstTimestampUs; }
+    qint64 lastTimestampUs() const { return m_lastTimestampUs; }
+    qint64 recordCount() const { return m_recordCount; }
+
+    /**
+     * @brief Decode the record at the current position without consuming it
+     * @return False at the end of the log
+     */
+    bool peek(Record &record) const { return readAt(m_offset, record); }
+
+    /**
+     * @brief Move past the record returned by the last successful peek()
+     */
+    void advance(const Record &record) { m_offset += SessionLogFormat::RecordHeaderSize + record.size; }
+
+    /**
+     * @brief Decode the record at the current position and move past it
+     */
+    bool next(Record &record);
+
+    /**
+     * @brief Byte offset of the current record; pass it to seekToOffset() to come back
+     */
+    qint64 offset() const { return m_offset; }
+    void seekToOffset(qint64 offset) { m_offset = qBound(m_firstRecordOffset, offset, m_size); }
+    void rewind() { m_offset = m_firstRecordOffset; }
+
+    /**
+     * @brief Position the reader on the first record received at or after @p timestampUs
+     */
+    void seekToTime(qint64 timestampUs);
+
+    /**
+     * @brief Position the reader on the first record stamped at or after arrival @p arrival
+     */
+    void seekToArrival(quint64 arrival);
+
+    const SessionLogIndex &index() const { return m_index; }
+
+private:
+    bool readAt(qint64 offset, Record &record) const;
+    bool loadIndex(const QString &path);
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    qint64 m_firstRecordOffset;
+    qint64 m_offset;
+    SessionLogFormat::Header m_header;
+    qint64 m_firstTimestampUs;
+    qint64 m_lastTimestampUs;
+    qint64 m_recordCount;
+    SessionLogIndex m_index;
+    QString m_errorString;
+};
+
+#endif // SESSIONLOGREADER_H
@@ -0,0 +1,449 @@
+#include "sessionrecorder.h"
+#include "datagrambufferpool.h"
+#include "sessionlogformat.h"
+#include <QDateTime>
+#include <QDir>
+#include <QStandardPaths>
+#include <QThread>
+#include <chrono>
+#include <cstring>
+
+/*SessionRecorder
+ * Persists the raw datagrams of a session. The producer copies each datagram into a preallocated
+ * block and only touches lock-free queues; a writer thread turns the blocks into large sequential
+ * appends. The producer/stop() handshake is a pair of sequentially consistent flags, so the hot
+ * path pays nothing while no recording is running and one flag exchange per batch while it is.
+ * The busy flag doubles as a lock on the current block for the idle flush. The flush only takes
+ * it once the published start time of the block shows it went stale, which a producer that is
+ * still recording never lets happen, and holds it for a few instructions; a producer that does
+ * meet it spins until it is free, so no datagram is lost to the flush.
+ */
+
+namespace
+{
+// The clock of TelemetryFrame::hostTimestampUs
+qint64 monotonicMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+QString fileNameStem(const QString &sessionName)
+{
+    QString stem;
+    stem.reserve(sessionName.size());
+    for (const QChar c : sessionName.trimmed())
+    {
+        stem.append(c.isLetterOrNumber() || c == QLatin1Char('-') ? c : QLatin1Char('_'));
+    }
+
+    return stem.isEmpty() ? QStringLiteral("session") : stem;
+}
+} // namespace
+
+SessionRecorder::SessionRecorder(QObject *parent)
+    : QObject(parent),
+      m_logOffset(0),
+      m_indexedEntries(0),
+      m_fullBlocks(BlockCount),
+      m_freeBlocks(BlockCount),
+      m_writer(nullptr),
+      m_stopWriter(false),
+      m_recording(false),
+      m_producerBusy(false),
+      m_current(nullptr),
+      m_currentStartUs(0),
+      m_recordedDatagrams(0),
+      m_droppedDatagrams(0),
+      m_writtenBytes(0),
+      m_reportedRecorded(0),
+      m_reportedDropped(0)
+{
+    m_statsTimer.setInterval(StatsIntervalMs);
+    connect(&m_statsTimer, &QTimer::timeout, this, &SessionRecorder::flushIdleBlock);
+    connect(&m_statsTimer, &QTimer::timeout, this, &SessionRecorder::checkStatistics);
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+QString SessionRecorder::recordingDirectory()
+{
+    const QString configured = qEnvironmentVariable("CAR_DASHBOARD_RECORDING_DIR");
+    if (!configured.isEmpty())
+    {
+        return configured;
+    }
+
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/sessions");
+}
+
+bool SessionRecorder::start(const QString &sessionName)
+{
+    stop();
+
+    const QDir directory(recordingDirectory());
+    if (!directory.mkpath(QStringLiteral(".")))
+    {
+        emit errorOccurred(QString("Cannot create the recording directory %1").arg(directory.path()));
+        return false;
+    }
+
+    // Never reuse a log: a second session of the same name in the same second gets a suffix
+    const QString stem = fileNameStem(sessionName) + QLatin1Char('_')
+                         + QDateTime::currentDateTime().toString(QStringLiteral("yyyyMMdd-HHmmss"));
+    QString path = directory.filePath(stem + QLatin1String(SessionLogFormat::FileSuffix));
+    for (int suffix = 2; QFile::exists(path); ++suffix)
+    {
+        path = directory.filePath(QStringLiteral("%1-%2%3").arg(stem).arg(suffix).arg(QLatin1String(SessionLogFormat::FileSuffix)));
+    }
+
+    // Unbuffered: the blocks already are the write buffer
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::NewOnly | QIODevice::Unbuffered))
+    {
+        emit errorOccurred(QString("Cannot create session log %1: %2").arg(path, m_file.errorString()));
+        return false;
+    }
+
+    SessionLogFormat::Header header;
+    header.startWallClockMs = QDateTime::currentMSecsSinceEpoch();
+    header.startMonotonicUs = monotonicMicroseconds();
+    header.sessionName = sessionName;
+    const QByteArray encodedHeader = SessionLogFormat::encodeHeader(header);
+    if (m_file.write(encodedHeader) != encodedHeader.size())
+    {
+        emit errorOccurred(QString("Cannot write session log %1: %2").arg(path, m_file.errorString()));
+        m_file.close();
+        return false;
+    }
+
+    // Without a sidecar the log is still complete; the first reader indexes it
+    m_index.reset(header.startWallClockMs);
+    m_logOffset = encodedHeader.size();
+    m_indexedEntries = 0;
+    m_indexFile.setFileName(SessionLogIndex::pathFor(path));
+    if (m_indexFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+    {
+        const QByteArray indexHeader = m_index.encodeHeader();
+        if (m_indexFile.write(indexHeader) != indexHeader.size())
+        {
+            m_indexFile.close();
+        }
+    }
+
+    m_blocks.reserve(BlockCount);
+    for (int i = 0; i < BlockCount; ++i)
+    {
+        auto block = std::make_unique<Block>();
+        block->data.reset(new char[BlockSize]);
+        m_freeBlocks.tryPush(block.get());
+        m_blocks.push_back(std::move(block));
+    }
+
+    m_filePath = path;
+    m_current = nullptr;
+    m_currentStartUs.store(0, std::memory_order_relaxed);
+    m_recordedDatagrams.store(0, std::memory_order_relaxed);
+    m_droppedDatagrams.store(0, std::memory_order_relaxed);
+    m_writtenBytes.store(quint64(encodedHeader.size()), std::memory_order_relaxed);
+    m_reportedRecorded = 0;
+    m_reportedDropped = 0;
+
+    m_stopWriter.store(false, std::memory_order_relaxed);
+    m_writer = QThread::create([this]() { writeLoop(); });
+    m_writer->setObjectName("Session Recorder");
+    m_writer->start();
+
+    // Publishes the blocks and the file to the producer
+    m_recording.store(true, std::memory_order_seq_cst);
+    m_statsTimer.start();
+
+    emit recordingChanged();
+    emit statisticsChanged();
+    return true;
+}
+
+void SessionRecorder::stop()
+{
+    if (!m_recording.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // After this the producer either saw the flag cleared or has left; it never waits on us
+    m_recording.store(false, std::memory_order_seq_cst);
+    while (m_producerBusy.load(std::memory_order_seq_cst))
+    {
+        QThread::yieldCurrentThread();
+    }
+
+    // The producer is out, so its partially filled block is ours to hand over
+    if (m_current && m_current->used > 0)
+    {
+        handOver();
+    }
+    m_current = nullptr;
+    m_currentStartUs.store(0, std::memory_order_relaxed);
+
+    m_stopWriter.store(true, std::memory_order_release);
+    m_writerWakeups.notifyAll();
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+
+    Block *block = nullptr;
+    while (m_fullBlocks.tryPop(block))
+    {
+    }
+    while (m_freeBlocks.tryPop(block))
+    {
+    }
+    m_blocks.clear();
+    m_file.close();
+    m_indexFile.close();
+
+    m_statsTimer.stop();
+    emit recordingChanged();
+    emit statisticsChanged();
+}
+
+bool SessionRecorder::enterProducer()
+{
+    if (!m_recording.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    // flushIdleBlock() holds the flag only for the few instructions of a hand-over
+    while (m_producerBusy.exchange(true, std::memory_order_seq_cst))
+    {
+        QThread::yieldCurrentThread();
+    }
+
+    // Pairs with stop(): either it sees us busy, or we see the recording stopped
+    if (!m_recording.load(std::memory_order_seq_cst))
+    {
+        leaveProducer();
+        return false;
+    }
+
+    return true;
+}
+
+void SessionRecorder::record(const QByteArray &data, quint64 arrival)
+{
+    if (!enterProducer())
+    {
+        return;
+    }
+
+    const qint64 now = monotonicMicroseconds();
+    append(data.constData(), int(data.size()), arrival, now);
+
+    if (m_current && now - m_current->firstTimestampUs >= FlushIntervalMs * 1000)
+    {
+        handOver();
+    }
+
+    leaveProducer();
+}
+
+void SessionRecorder::recordBatch(DatagramBuffer *const *buffers, int count, quint64 firstArrival)
+{
+    if (!enterProducer())
+    {
+        return;
+    }
+
+    // One batch is drained at once, so its datagrams share the receive time
+    const qint64 now = monotonicMicroseconds();
+    for (int i = 0; i < count; ++i)
+    {
+        append(buffers[i]->data, buffers[i]->size, firstArrival + quint64(i), now);
+    }
+
+    if (m_current && now - m_current->firstTimestampUs >= FlushIntervalMs * 1000)
+    {
+        handOver();
+    }
+
+    leaveProducer();
+}
+
+void SessionRecorder::append(const char *data, int size, quint64 arrival, qint64 timestampUs)
+{
+    const int recordSize = SessionLogFormat::RecordHeaderSize + size;
+
+    if (m_current && m_current->used + recordSize > BlockSize)
+    {
+        handOver();
+    }
+
+    if (!m_current)
+    {
+        // Every block is waiting for the disk; lose this datagram rather than the receiver's time
+        if (recordSize > BlockSize || !m_freeBlocks.tryPop(m_current))
+        {
+            m_droppedDatagrams.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        m_current->used = 0;
+        m_current->firstTimestampUs = timestampUs;
+        m_currentStartUs.store(timestampUs, std::memory_order_relaxed);
+    }
+
+    char *out = m_current->data.get() + m_current->used;
+    SessionLogFormat::RecordHeader header;
+    header.hostTimestampUs = timestampUs;
+    header.arrival = arrival;
+    header.size = quint32(size);
+    SessionLogFormat::encodeRecordHeader(header, out);
+    std::memcpy(out + SessionLogFormat::RecordHeaderSize, data, size_t(size));
+    m_current->used += recordSize;
+
+    // Only the producer writes the counters, so no read-modify-write is needed
+    m_recordedDatagrams.store(m_recordedDatagrams.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void SessionRecorder::handOver()
+{
+    // The queue holds every block, so it cannot be full
+    const bool queued = m_fullBlocks.tryPush(m_current);
+    Q_ASSERT(queued);
+    Q_UNUSED(queued);
+
+    m_current = nullptr;
+    m_currentStartUs.store(0, std::memory_order_relaxed);
+    m_writerWakeups.notifyOne();
+}
+
+void SessionRecorder::writeLoop()
+{
+    bool failed = false;
+    Block *block = nullptr;
+
+    for (;;)
+    {
+        while (m_fullBlocks.tryPop(block))
+        {
+            if (!failed)
+            {
+                if (m_file.write(block->data.get(), block->used) == block->used)
+                {
+                    m_writtenBytes.fetch_add(quint64(block->used), std::memory_order_relaxed);
+                    indexBlock(*block);
+                }
+                else
+                {
+                    // Keep recycling blocks so the producer only ever sees drops, never a stall
+                    failed = true;
+                    reportWriteError(m_file.errorString());
+                }
+            }
+
+            block->used = 0;
+            m_freeBlocks.tryPush(block);
+        }
+
+        // stop() queues the last block before raising the flag, so one more pass drains it
+        if (m_stopWriter.load(std::memory_order_acquire))
+        {
+            if (m_fullBlocks.isEmpty())
+            {
+                return;
+            }
+            continue;
+        }
+
+        const quint32 key = m_writerWakeups.prepareWait();
+        if (!m_fullBlocks.isEmpty() || m_stopWriter.load(std::memory_order_acquire))
+        {
+            m_writerWakeups.cancelWait();
+        }
+        else
+        {
+            m_writerWakeups.commitWait(key);
+        }
+    }
+}
+
+void SessionRecorder::indexBlock(const Block &block)
+{
+    // A block holds whole records only, so its record headers can be walked from the start
+    const char *data = block.data.get();
+    for (int at = 0; at < block.used;)
+    {
+        const SessionLogFormat::RecordHeader header = SessionLogFormat::decodeRecordHeader(data + at);
+        m_index.observe(header.hostTimestampUs, header.arrival, m_logOffset + at);
+        at += SessionLogFormat::RecordHeaderSize + int(header.size);
+    }
+    m_logOffset += block.used;
+
+    // Written after the block itself, so an entry never points past the data on disk
+    const int entries = int(m_index.entries().size());
+    if (entries > m_indexedEntries && m_indexFile.isOpen())
+    {
+        const QByteArray encoded = m_index.encodeEntries(m_indexedEntries);
+        if (m_indexFile.write(encoded) == encoded.size())
+        {
+            m_indexedEntries = entries;
+        }
+        else
+        {
+            m_indexFile.close();
+        }
+    }
+}
+
+void SessionRecorder::reportWriteError(const QString &error)
+{
+    const QString message = QString("Session log %1 is no longer written: %2").arg(m_filePath, error);
+    QMetaObject::invokeMethod(this, [this, message]() { emit errorOccurred(message); }, Qt::QueuedConnection);
+}
+
+void SessionRecorder::flushIdleBlock()
+{
+    if (!m_recording.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Leave a block that is empty or still filling to the producer, without touching its flag
+    const qint64 started = m_currentStartUs.load(std::memory_order_relaxed);
+    if (started == 0 || monotonicMicroseconds() - started < FlushIntervalMs * 1000)
+    {
+        return;
+    }
+
+    // A producer inside record() flushes the stale block itself
+    bool busy = false;
+    if (!m_producerBusy.compare_exchange_strong(busy, true, std::memory_order_seq_cst))
+    {
+        return;
+    }
+
+    if (m_current && m_current->used > 0 && monotonicMicroseconds() - m_current->firstTimestampUs >= FlushIntervalMs * 1000)
+    {
+        handOver();
+    }
+
+    leaveProducer();
+}
+
+void SessionRecorder::checkStatistics()
+{
+    const quint64 recorded = m_recordedDatagrams.load(std::memory_order_relaxed);
+    const quint64 dropped = m_droppedDatagrams.load(std::memory_order_relaxed);
+
+    if (recorded != m_reportedRecorded || dropped != m_reportedDropped)
+    {
+        m_reportedRecorded = recorded;
+        m_reportedDropped = dropped;
+        emit statisticsChanged();
+    }
+}
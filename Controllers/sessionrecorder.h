@@ -0,0 +1,150 @@
+#ifndef SESSIONRECORDER_H
+#define SESSIONRECORDER_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "eventcount.h"
+#include "sessionlogindex.h"
+#include "spscringbuffer.h"
+
+class QThread;
+struct DatagramBuffer;
+
+/**
+ * @brief The SessionRecorder class tees received datagrams into an append-only session log
+ *
+ * The producer - the thread that feeds the ParserStage, e.g. the UDP receiver - copies each
+ * datagram with its host receive time and arrival stamp into the current one of BlockCount
+ * preallocated BlockSize buffers. Full blocks, and partially filled ones older than
+ * FlushIntervalMs, go through a lock-free queue to a dedicated writer thread, which appends
+ * them to the file in single large writes and hands them back through a second queue. The
+ * producer hands a partial block over when it records into it after FlushIntervalMs; if the
+ * link goes quiet first, the recorder's own thread hands it over on its next statistics tick,
+ * so a datagram reaches the disk within FlushIntervalMs + StatsIntervalMs. The producer never
+ * waits for the disk: when every block is queued for writing, datagrams are dropped from the
+ * recording and counted in droppedDatagrams() while parsing carries on.
+ *
+ * The file format is described in SessionLogFormat. After each block the writer also appends
+ * any new seek entries to the log's SessionLogIndex sidecar, so a replay can seek a log that
+ * is still being recorded, or whose recorder crashed, without reading it first. Logs are named
+ * from the session name and the start time and live in the directory given by
+ * CAR_DASHBOARD_RECORDING_DIR, or in "sessions" under the application data location.
+ *
+ * start() and stop() belong to the thread the recorder lives in and may be called while the
+ * producer is running; record() and recordBatch() may be called from one producer thread at a
+ * time, like ParserStage::dispatch().
+ */
+class SessionRecorder : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BlockSize = 256 * 1024;
+    static constexpr int BlockCount = 16; // 4 MiB in flight before the recording drops datagrams
+    static constexpr int FlushIntervalMs = 250;
+    static constexpr int StatsIntervalMs = 1000;
+
+    explicit SessionRecorder(QObject *parent = nullptr);
+    ~SessionRecorder();
+
+    /**
+     * @brief Open a new log for @p sessionName and start recording; stops a running recording first
+     * @return False if the log could not be created; the reason is emitted with errorOccurred()
+     */
+    bool start(const QString &sessionName);
+
+    /**
+     * @brief Write everything recorded so far and close the log
+     */
+    void stop();
+
+    bool isRecording() const { return m_recording.load(std::memory_order_relaxed); }
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * @brief Append one datagram (producer thread only)
+     */
+    void record(const QByteArray &data, quint64 arrival);
+
+    /**
+     * @brief Append a batch of datagrams stamped @p firstArrival, @p firstArrival + 1, ... (producer thread only)
+     */
+    void recordBatch(DatagramBuffer *const *buffers, int count, quint64 firstArrival);
+
+    // Counters of the current recording
+    qint64 recordedDatagrams() const { return qint64(m_recordedDatagrams.load(std::memory_order_relaxed)); }
+    qint64 droppedDatagrams() const { return qint64(m_droppedDatagrams.load(std::memory_order_relaxed)); }
+    qint64 writtenBytes() const { return qint64(m_writtenBytes.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief Directory new logs are created in
+     */
+    static QString recordingDirectory();
+
+signals:
+    void recordingChanged();
+
+    /**
+     * @brief Emitted at most every StatsIntervalMs while the counters change
+     */
+    void statisticsChanged();
+
+    void errorOccurred(const QString &error);
+
+private slots:
+    void flushIdleBlock();
+    void checkStatistics();
+
+private:
+    struct Block
+    {
+        std::unique_ptr<char[]> data;
+        int used = 0;
+        qint64 firstTimestampUs = 0; // Receive time of the first record in the block
+    };
+
+    bool enterProducer();
+    void leaveProducer() { m_producerBusy.store(false, std::memory_order_release); }
+    void append(const char *data, int size, quint64 arrival, qint64 timestampUs);
+    void handOver();
+    void writeLoop();
+    void indexBlock(const Block &block);
+    void reportWriteError(const QString &error);
+
+    QFile m_file; // Written by the writer thread while recording
+    QString m_filePath;
+    QFile m_indexFile;       // Sidecar; closed on a failed write, leaving the reader to rebuild it
+    SessionLogIndex m_index; // Writer thread only while recording
+    qint64 m_logOffset;      // File offset of the next block
+    int m_indexedEntries;    // Entries already in the sidecar
+    std::vector<std::unique_ptr<Block>> m_blocks;
+    SpscRingBuffer<Block *> m_fullBlocks; // Producer to writer
+    SpscRingBuffer<Block *> m_freeBlocks; // Writer to producer
+    EventCount m_writerWakeups;
+    QThread *m_writer;
+    std::atomic<bool> m_stopWriter;
+
+    // Producer handshake: stop() clears m_recording and waits until the producer has left.
+    // m_producerBusy is also the ownership of m_current: flushIdleBlock() takes it briefly to hand
+    // over a stale block, and a producer that finds it taken spins until it is released.
+    std::atomic<bool> m_recording;
+    std::atomic<bool> m_producerBusy;
+    Block *m_current;                     // Block being filled; whoever holds m_producerBusy
+    std::atomic<qint64> m_currentStartUs; // m_current's first receive time, 0 without a block
+
+    std::atomic<quint64> m_recordedDatagrams;
+    std::atomic<quint64> m_droppedDatagrams;
+    std::atomic<quint64> m_writtenBytes;
+
+    QTimer m_statsTimer;
+    quint64 m_reportedRecorded;
+    quint64 m_reportedDropped;
+};
+
+#endif // SESSIONRECORDER_H
@@ -0,0 +1,116 @@
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * @brief The SpscRingBuffer class is a bounded, lock-free single-producer/single-consumer queue
+ *
+ * Exactly one thread may call tryPush() and exactly one (other) thread may call tryPop().
+ * The capacity is rounded up to a power of two. The producer and consumer indices live on
+ * separate cache lines and each side caches the other's index, so an uncontended push or
+ * pop touches shared memory only when the cached view says the ring is full or empty.
+ */
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(std::size_t capacity)
+        : m_capacity(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity)),
+          m_mask(m_capacity - 1),
+          m_slots(new T[m_capacity])
+    {
+    }
+
+    SpscRingBuffer(const SpscRingBuffer &) = delete;
+    SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+    /**
+     * @brief Append an item (producer thread only)
+     * @return False if the ring is full; the item is left untouched
+     */
+    template <typename U>
+    bool tryPush(U &&item)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+
+        if (tail - m_cachedHead == m_capacity)
+        {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail - m_cachedHead == m_capacity)
+            {
+                return false;
+            }
+        }
+
+        m_slots[tail & m_mask] = std::forward<U>(item);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Remove the oldest item (consumer thread only)
+     * @return False if the ring is empty
+     */
+    bool tryPop(T &item)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+
+        if (head == m_cachedTail)
+        {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cachedTail)
+            {
+                return false;
+            }
+        }
+
+        item = std::move(m_slots[head & m_mask]);
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Approximate number of queued items; exact only when both sides are quiescent
+     */
+    std::size_t sizeApprox() const
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_acquire);
+        const std::size_t head = m_head.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool isEmpty() const { return sizeApprox() == 0; }
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    static std::size_t roundUpToPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    static constexpr std::size_t CacheLineSize = 64;
+
+    const std::size_t m_capacity;
+    const std::size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    // Consumer side
+    alignas(CacheLineSize) std::atomic<std::size_t> m_head{0};
+    std::size_t m_cachedTail = 0;
+
+    // Producer side
+    alignas(CacheLineSize) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_cachedHead = 0;
+};
+
+#endif // SPSCRINGBUFFER_H
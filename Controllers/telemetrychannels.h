@@ -0,0 +1,112 @@
+#ifndef TELEMETRYCHANNELS_H
+#define TELEMETRYCHANNELS_H
+
+#include <QtGlobal>
+#include <cmath>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include "telemetryframe.h"
+
+/**
+ * @brief Describes one telemetry channel: where it lives in TelemetryFrame and how it is compared
+ *
+ * @c name must match the channel's Q_PROPERTY on TelemetrySource, @c wireIndex is the channel's
+ * position in the CSV packet, and @c tolerance is an absolute dead-band below which a change is
+ * not published (0 publishes every change; floating-point channels additionally ignore
+ * differences qFuzzyCompare() considers equal).
+ */
+template <typename T>
+struct TelemetryChannel
+{
+    using Type = T;
+
+    const char *name;
+    T TelemetryFrame::*member;
+    int wireIndex;
+    double tolerance;
+};
+
+/**
+ * @brief The channel table. Everything per-channel is generated from this list:
+ * TelemetrySource's storage and change notifications, and TelemetryCsvParser's field mapping.
+ *
+ * To add a channel: add the member to TelemetryFrame, append a row here, and declare the
+ * matching Q_PROPERTY, getter and NOTIFY signal in TelemetrySource (moc cannot see templates).
+ */
+inline constexpr auto TelemetryChannels = std::make_tuple(
+    TelemetryChannel<float>{"speed", &TelemetryFrame::speed, 0, 0.0},
+    TelemetryChannel<int>{"rpm", &TelemetryFrame::rpm, 1, 0.0},
+    TelemetryChannel<int>{"accPedal", &TelemetryFrame::accPedal, 2, 0.0},
+    TelemetryChannel<int>{"brakePedal", &TelemetryFrame::brakePedal, 3, 0.0},
+    TelemetryChannel<double>{"encoderAngle", &TelemetryFrame::encoderAngle, 4, 0.0},
+    TelemetryChannel<float>{"temperature", &TelemetryFrame::temperature, 5, 0.0},
+    TelemetryChannel<int>{"batteryLevel", &TelemetryFrame::batteryLevel, 6, 0.0},
+    TelemetryChannel<double>{"gpsLongitude", &TelemetryFrame::gpsLongitude, 7, 0.0},
+    TelemetryChannel<double>{"gpsLatitude", &TelemetryFrame::gpsLatitude, 8, 0.0},
+    TelemetryChannel<int>{"speedFL", &TelemetryFrame::speedFL, 9, 0.0},
+    TelemetryChannel<int>{"speedFR", &TelemetryFrame::speedFR, 10, 0.0},
+    TelemetryChannel<int>{"speedBL", &TelemetryFrame::speedBL, 11, 0.0},
+    TelemetryChannel<int>{"speedBR", &TelemetryFrame::speedBR, 12, 0.0},
+    TelemetryChannel<double>{"lateralG", &TelemetryFrame::lateralG, 13, 0.0},
+    TelemetryChannel<double>{"longitudinalG", &TelemetryFrame::longitudinalG, 14, 0.0});
+
+inline constexpr int TelemetryChannelCount = int(std::tuple_size_v<std::decay_t<decltype(TelemetryChannels)>>);
+static_assert(TelemetryChannelCount <= 32, "Change masks are 32 bits wide");
+
+/**
+ * @brief Invoke @p function with (channel, index) for every channel, unrolled at compile time
+ */
+template <typename Function>
+constexpr void forEachTelemetryChannel(Function &&function)
+{
+    [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+        (function(std::get<Index>(TelemetryChannels), int(Index)), ...);
+    }(std::make_index_sequence<TelemetryChannelCount>());
+}
+
+namespace TelemetryChannelsDetail
+{
+constexpr bool wireIndicesMatchTableOrder()
+{
+    bool ordered = true;
+    forEachTelemetryChannel([&](const auto &channel, int index) { ordered = ordered && channel.wireIndex == index; });
+    return ordered;
+}
+static_assert(wireIndicesMatchTableOrder(), "TelemetryChannels rows must be listed in wire order");
+
+template <typename T>
+inline bool valueChanged(T oldValue, T newValue, double tolerance)
+{
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        if (qFuzzyCompare(oldValue, newValue))
+        {
+            return false;
+        }
+    }
+    else if (oldValue == newValue)
+    {
+        return false;
+    }
+
+    return tolerance <= 0.0 || std::fabs(double(newValue) - double(oldValue)) > tolerance;
+}
+} // namespace TelemetryChannelsDetail
+
+/**
+ * @brief Bit mask of the channels whose value differs between two frames, per each channel's tolerance
+ */
+inline quint32 changedTelemetryChannels(const TelemetryFrame &previous, const TelemetryFrame &current)
+{
+    quint32 mask = 0;
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        if (TelemetryChannelsDetail::valueChanged(previous.*channel.member, current.*channel.member, channel.tolerance))
+        {
+            mask |= quint32(1) << index;
+        }
+    });
+    return mask;
+}
+
+#endif // TELEMETRYCHANNELS_H
@@ -0,0 +1,140 @@
+#include "telemetrycsvparser.h"
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+/*Walks the packet bytes once: a memchr() pass counts the comma-separated parts, then each of the
+ * first FieldCount fields is trimmed and converted in place. Nothing is copied and nothing is
+ *  allocated, so the cost per frame is a handful of from_chars() calls.
+ */
+
+namespace
+{
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Narrow [begin, end) to the field without surrounding whitespace and an optional leading '+'
+inline bool prepareField(const char *&begin, const char *&end)
+{
+    while (begin != end && isSpace(*begin))
+    {
+        ++begin;
+    }
+    while (end != begin && isSpace(*(end - 1)))
+    {
+        --end;
+    }
+
+    // from_chars() rejects '+', Qt's conversions accept a single one
+    if (begin != end && *begin == '+')
+    {
+        ++begin;
+        if (begin != end && (*begin == '+' || *begin == '-'))
+        {
+            return false;
+        }
+    }
+
+    return begin != end;
+}
+
+inline bool toValue(const char *begin, const char *end, int &value)
+{
+    if (!prepareField(begin, end))
+    {
+        return false;
+    }
+
+    const std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+inline bool toValue(const char *begin, const char *end, double &value)
+{
+    if (!prepareField(begin, end))
+    {
+        return false;
+    }
+
+    const std::from_chars_result result = std::from_chars(begin, end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+inline bool toValue(const char *begin, const char *end, float &value)
+{
+    double wide;
+    if (!toValue(begin, end, wide))
+    {
+        return false;
+    }
+
+    // Same narrowing rules as QString::toFloat(): explicit infinities pass, overflow and underflow fail
+    if (!std::isinf(wide) && std::fabs(wide) > double(std::numeric_limits<float>::max()))
+    {
+        return false;
+    }
+
+    const float narrow = float(wide);
+    if (wide != 0.0 && narrow == 0.0f)
+    {
+        return false;
+    }
+
+    value = narrow;
+    return true;
+}
+
+class FieldCursor
+{
+public:
+    FieldCursor(const char *begin, const char *end) : m_cursor(begin), m_end(end) {}
+
+    // Returns the next field; must not be called more often than there are fields
+    void next(const char *&fieldBegin, const char *&fieldEnd)
+    {
+        fieldBegin = m_cursor;
+        const void *comma = std::memchr(m_cursor, ',', size_t(m_end - m_cursor));
+        fieldEnd = comma ? static_cast<const char *>(comma) : m_end;
+        m_cursor = comma ? fieldEnd + 1 : m_end;
+    }
+
+private:
+    const char *m_cursor;
+    const char *m_end;
+};
+} // namespace
+
+TelemetryCsvParser::Result TelemetryCsvParser::parse(const char *begin, const char *end, TelemetryFrame &frame)
+{
+    Result result;
+
+    // An empty or all-whitespace packet still counts as one (empty) part, like QString::split()
+    result.fieldCount = 1;
+    for (const char *p = begin; (p = static_cast<const char *>(std::memchr(p, ',', size_t(end - p)))) != nullptr; ++p)
+    {
+        result.fieldCount++;
+    }
+
+    if (result.fieldCount < FieldCount)
+    {
+        result.status = WrongFieldCount;
+        return result;
+    }
+
+    FieldCursor fields(begin, end);
+    const char *b;
+    const char *e;
+    bool ok = true;
+
+    // One field per channel, in wire order; the conversion is picked by the channel's type
+    forEachTelemetryChannel([&](const auto &channel, int) {
+        fields.next(b, e);
+        ok &= toValue(b, e, frame.*channel.member);
+    });
+
+    result.status = ok ? Ok : BadValue;
+    return result;
+}
@@ -0,0 +1,47 @@
+#ifndef TELEMETRYCSVPARSER_H
+#define TELEMETRYCSVPARSER_H
+
+#include <QByteArray>
+#include "telemetrychannels.h"
+
+/**
+ * @brief The TelemetryCsvParser class decodes a comma-separated telemetry packet without allocating
+ *
+ * The packet bytes are walked once and every field is converted in place with std::from_chars.
+ * Acceptance rules mirror the previous QString::split() + toFloat()/toInt()/toDouble() path:
+ * whitespace around a field is ignored, a leading '+' is accepted, fields beyond the last channel
+ * are counted but ignored, and a float that overflows or underflows to zero is rejected.
+ */
+class TelemetryCsvParser
+{
+public:
+    static constexpr int FieldCount = TelemetryChannelCount;
+
+    enum Status
+    {
+        Ok,
+        WrongFieldCount, // Fewer than FieldCount comma-separated parts
+        BadValue         // A field is not a valid number of its channel's type
+    };
+
+    struct Result
+    {
+        Status status = Ok;
+        int fieldCount = 0; // Number of comma-separated parts in the packet
+    };
+
+    /**
+     * @brief Parse a packet into a frame
+     * @param begin First byte of the packet
+     * @param end One past the last byte of the packet
+     * @param frame Receives the values; only fully valid on Ok
+     */
+    static Result parse(const char *begin, const char *end, TelemetryFrame &frame);
+
+    static Result parse(const QByteArray &data, TelemetryFrame &frame)
+    {
+        return parse(data.constData(), data.constData() + data.size(), frame);
+    }
+};
+
+#endif // TELEMETRYCSVPARSER_H
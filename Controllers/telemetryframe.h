@@ -0,0 +1,52 @@
+#ifndef TELEMETRYFRAME_H
+#define TELEMETRYFRAME_H
+
+#include <QtGlobal>
+#include <QMetaType>
+
+/**
+ * @brief The TelemetryFrame struct holds the decoded values of one telemetry packet
+ *
+ * Field order matches the order of the comma-separated values sent by the car. Frames decoded
+ * from the binary wire format also carry the sender's sequence number and timestamp.
+ *
+ * Parsers take frames from a TelemetryFramePool and pass them across threads as a single
+ * pointer; whoever handles the frame returns it to the pool.
+ */
+struct TelemetryFrame
+{
+    float speed = 0.0f;
+    int rpm = 0;
+    int accPedal = 0;
+    int brakePedal = 0;
+    double encoderAngle = 0.0;
+    float temperature = 0.0f;
+    int batteryLevel = 0;
+    double gpsLongitude = 0.0;
+    double gpsLatitude = 0.0;
+    int speedFL = 0;
+    int speedFR = 0;
+    int speedBL = 0;
+    int speedBR = 0;
+    double lateralG = 0.0;
+    double longitudinalG = 0.0;
+
+    // Monotonic host clock when the frame was decoded
+    qint64 hostTimestampUs = 0;
+
+    // Dispatch order stamped when the datagram was handed to a parser (0 if unknown)
+    quint64 arrival = 0;
+
+    // Older queued datagrams the parser skipped to reach this one in latest-only mode
+    quint32 skippedBefore = 0;
+
+    // Link metadata, only valid when sequenced is true (binary wire format)
+    bool sequenced = false;
+    quint32 sequence = 0;
+    quint64 senderTimestampUs = 0;
+};
+
+Q_DECLARE_METATYPE(TelemetryFrame)
+Q_DECLARE_METATYPE(TelemetryFrame *)
+
+#endif // TELEMETRYFRAME_H
@@ -0,0 +1,51 @@
+#include "telemetryframepool.h"
+
+/*Fixed block of frames plus a lock-free free list. The free list has the same capacity as the
+ * block, so returning a pooled frame can never fail.
+ */
+
+TelemetryFramePool::TelemetryFramePool(int capacity)
+    : m_capacity(qMax(1, capacity)),
+      m_storage(new TelemetryFrame[m_capacity]),
+      m_freeList(size_t(m_capacity)),
+      m_overflowAllocations(0)
+{
+    for (int i = 0; i < m_capacity; ++i)
+    {
+        m_freeList.tryPush(&m_storage[i]);
+    }
+}
+
+TelemetryFramePool::~TelemetryFramePool() = default;
+
+TelemetryFrame *TelemetryFramePool::acquire()
+{
+    TelemetryFrame *frame = nullptr;
+
+    if (m_freeList.tryPop(frame))
+    {
+        *frame = TelemetryFrame();
+        return frame;
+    }
+
+    // Pool exhausted: consumers are behind. Stay correct and let the counter tell the story.
+    m_overflowAllocations.fetch_add(1, std::memory_order_relaxed);
+    return new TelemetryFrame();
+}
+
+void TelemetryFramePool::release(TelemetryFrame *frame)
+{
+    if (!frame)
+    {
+        return;
+    }
+
+    if (owns(frame))
+    {
+        m_freeList.tryPush(frame);
+    }
+    else
+    {
+        delete frame;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef TELEMETRYFRAMEPOOL_H
+#define TELEMETRYFRAMEPOOL_H
+
+#include <QtGlobal>
+#include <atomic>
+#include <memory>
+#include "mpmcqueue.h"
+#include "telemetryframe.h"
+
+/**
+ * @brief The TelemetryFramePool class recycles TelemetryFrame objects between parser threads and clients
+ *
+ * Frames are preallocated in one block and handed out through a lock-free free list, so a
+ * parsed frame crosses threads as a single pointer and no allocation happens per packet.
+ * If consumers fall so far behind that the pool runs dry, acquire() falls back to the heap
+ * and release() deletes those frames again; overflowAllocations() counts how often.
+ *
+ * acquire() and release() may be called from any thread.
+ */
+class TelemetryFramePool
+{
+public:
+    static constexpr int DefaultCapacity = 1024;
+
+    explicit TelemetryFramePool(int capacity = DefaultCapacity);
+    ~TelemetryFramePool();
+
+    TelemetryFramePool(const TelemetryFramePool &) = delete;
+    TelemetryFramePool &operator=(const TelemetryFramePool &) = delete;
+
+    /**
+     * @brief Take a frame, reset to default values
+     */
+    TelemetryFrame *acquire();
+
+    /**
+     * @brief Return a frame obtained from acquire()
+     */
+    void release(TelemetryFrame *frame);
+
+    int capacity() const { return m_capacity; }
+    quint64 overflowAllocations() const { return m_overflowAllocations.load(std::memory_order_relaxed); }
+
+private:
+    bool owns(const TelemetryFrame *frame) const
+    {
+        return frame >= m_storage.get() && frame < m_storage.get() + m_capacity;
+    }
+
+    const int m_capacity;
+    std::unique_ptr<TelemetryFrame[]> m_storage;
+    BoundedMpmcQueue<TelemetryFrame *> m_freeList;
+    std::atomic<quint64> m_overflowAllocations;
+};
+
+#endif // TELEMETRYFRAMEPOOL_H
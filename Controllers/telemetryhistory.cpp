@@ -0,0 +1,139 @@
+#include "telemetryhistory.h"
+#include <limits>
+
+/*Per-channel ring buffer behind the history plots. Appending a frame writes one timestamp and
+ * one double per channel through relaxed atomics, which cost the same as plain stores, then
+ * publishes the frame with one release store of the frame counter. Range queries binary-search
+ * the timestamp column of the GUI's view and walk the window in place.
+ */
+
+TelemetryHistory::TelemetryHistory(QObject *parent)
+    : QObject(parent),
+      m_memoryBudget(0),
+      m_capacity(0),
+      m_lastTimestampUs(std::numeric_limits<qint64>::min()),
+      m_written(0),
+      m_clearedAt(0),
+      m_end(0),
+      m_count(0),
+      m_revision(0),
+      m_publishedRevision(0)
+{
+    setMemoryBudget(DefaultMemoryBudget);
+}
+
+void TelemetryHistory::append(const TelemetryFrame &frame)
+{
+    QMutexLocker locker(&m_writeLock);
+
+    // Parallel parsers decode slightly out of order; keep the time column sorted for the searches
+    const qint64 timestamp = qMax(frame.hostTimestampUs, m_lastTimestampUs);
+    m_lastTimestampUs = timestamp;
+
+    const quint64 frameNumber = m_written.load(std::memory_order_relaxed);
+    const size_t slot = size_t(frameNumber % quint64(m_capacity));
+
+    m_timestamps[slot].store(timestamp, std::memory_order_relaxed);
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        m_values[size_t(index) * size_t(m_capacity) + slot].store(double(frame.*channel.member), std::memory_order_relaxed);
+    });
+
+    m_written.store(frameNumber + 1, std::memory_order_release);
+}
+
+void TelemetryHistory::publish()
+{
+    const quint64 written = m_written.load(std::memory_order_acquire);
+    if (written != m_end)
+    {
+        m_end = written;
+        m_count = int(qMin<quint64>(m_end - m_clearedAt, quint64(m_capacity - readMargin())));
+        m_revision++;
+    }
+
+    if (m_revision != m_publishedRevision)
+    {
+        m_publishedRevision = m_revision;
+        emit revisionChanged();
+    }
+}
+
+void TelemetryHistory::clear()
+{
+    reset();
+    publish();
+}
+
+void TelemetryHistory::reset()
+{
+    // Frames appended from here on belong to the new history
+    m_clearedAt = m_written.load(std::memory_order_acquire);
+    m_end = m_clearedAt;
+    m_count = 0;
+    m_revision++;
+}
+
+void TelemetryHistory::setMemoryBudget(qint64 bytes)
+{
+    const int capacity = int(qBound<qint64>(16, bytes / BytesPerFrame, std::numeric_limits<int>::max() / TelemetryChannelCount));
+    m_memoryBudget = bytes;
+
+    if (capacity != m_capacity)
+    {
+        QMutexLocker locker(&m_writeLock);
+        m_capacity = capacity;
+        m_timestamps.reset(new std::atomic<qint64>[size_t(capacity)]());
+        m_values.reset(new std::atomic<double>[size_t(capacity) * TelemetryChannelCount]());
+    }
+
+    emit capacityChanged();
+    clear();
+}
+
+double TelemetryHistory::latestTime() const
+{
+    return m_count > 0 ? timestampUs(m_count - 1) / 1e6 : 0.0;
+}
+
+double TelemetryHistory::oldestTime() const
+{
+    return m_count > 0 ? timestampUs(0) / 1e6 : 0.0;
+}
+
+QStringList TelemetryHistory::channels() const
+{
+    QStringList names;
+    forEachTelemetryChannel([&](const auto &channel, int) { names << QString::fromLatin1(channel.name); });
+    return names;
+}
+
+int TelemetryHistory::channelIndex(const QString &name)
+{
+    int found = -1;
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        if (found < 0 && name == QLatin1String(channel.name))
+        {
+            found = index;
+        }
+    });
+    return found;
+}
+
+int TelemetryHistory::lowerBound(qint64 timeUs) const
+{
+    int low = 0;
+    int high = m_count;
+    while (low < high)
+    {
+        const int middle = low + (high - low) / 2;
+        if (timestampUs(middle) < timeUs)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return low;
+}
@@ -0,0 +1,133 @@
+#ifndef TELEMETRYHISTORY_H
+#define TELEMETRYHISTORY_H
+
+#include <QObject>
+#include <QMutex>
+#include <QStringList>
+#include <atomic>
+#include <memory>
+#include "telemetrychannels.h"
+
+/**
+ * @brief The TelemetryHistory class keeps the recent values of every telemetry channel for plots
+ *
+ * Frames are appended into a ring buffer laid out as structure of arrays: one timestamp column
+ * plus one contiguous column of doubles per channel, sized once from a memory budget. When the
+ * ring is full the oldest frame is overwritten, so memory stays fixed however long the session.
+ *
+ * The parser threads append every accepted frame as it is parsed, one at a time, and publish it
+ * by bumping an atomic frame counter. The GUI thread reads a view of the ring that only moves
+ * in publish(), so indices stay valid between two publishes however far the parsers run ahead.
+ * The view holds at most capacity - readMargin() frames; the margin is how far the writers may get
+ * ahead of a view before they overwrite frames it still shows.
+ *
+ * Times are seconds on the host's monotonic clock (TelemetryFrame::hostTimestampUs) and never
+ * decrease; latestTime is the time of the newest frame in the view. QML reads windows of the
+ * history through a TelemetryHistoryModel, which indexes the ring in place; C++ consumers use
+ * value() and timestampUs() directly.
+ *
+ * append() may be called from any thread, one caller at a time; everything else belongs to the
+ * GUI thread. revisionChanged() is emitted when the owning client publishes, i.e. at most once
+ * per rendered frame in FramePublishing mode.
+ */
+class TelemetryHistory : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY revisionChanged)
+    Q_PROPERTY(int capacity READ capacity NOTIFY capacityChanged)
+    Q_PROPERTY(qint64 memoryBudget READ memoryBudget WRITE setMemoryBudget NOTIFY capacityChanged)
+    Q_PROPERTY(double latestTime READ latestTime NOTIFY revisionChanged)
+    Q_PROPERTY(double oldestTime READ oldestTime NOTIFY revisionChanged)
+    Q_PROPERTY(quint64 revision READ revision NOTIFY revisionChanged)
+    Q_PROPERTY(QStringList channels READ channels CONSTANT)
+
+public:
+    static constexpr qint64 DefaultMemoryBudget = 8 * 1024 * 1024;
+    static constexpr qint64 BytesPerFrame = qint64(sizeof(qint64) + TelemetryChannelCount * sizeof(double));
+
+    explicit TelemetryHistory(QObject *parent = nullptr);
+
+    /**
+     * @brief Record an accepted frame; does not notify. Any thread, one caller at a time.
+     */
+    void append(const TelemetryFrame &frame);
+
+    /**
+     * @brief Move the view to the newest appended frame and emit revisionChanged() if it changed
+     */
+    void publish();
+
+    /**
+     * @brief Drop all frames appended so far
+     */
+    Q_INVOKABLE void clear();
+
+    /**
+     * @brief clear() without notifying; publish() announces it
+     */
+    void reset();
+
+    /**
+     * @brief Resize to hold as many frames as fit in @p bytes; clears the history
+     */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+
+    int count() const { return m_count; }
+    int capacity() const { return m_capacity; }
+    int readMargin() const { return m_capacity / 8; }
+    quint64 revision() const { return m_revision; }
+
+    /**
+     * @brief Frames in the view since the last clear; index 0 is frame number appended() - count()
+     *
+     * Lets incremental readers pick up where they left off even after the ring wrapped.
+     */
+    quint64 appended() const { return m_end - m_clearedAt; }
+    double latestTime() const;
+    double oldestTime() const;
+    QStringList channels() const;
+
+    /**
+     * @brief Index of a channel in the channel table, or -1
+     */
+    static int channelIndex(const QString &name);
+
+    // Direct access for C++ consumers; index 0 is the oldest frame of the view
+    qint64 timestampUs(int index) const { return m_timestamps[slot(index)].load(std::memory_order_relaxed); }
+    double value(int channel, int index) const
+    {
+        return m_values[size_t(channel) * size_t(m_capacity) + slot(index)].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Index of the oldest frame at or after @p timeUs; count() if there is none
+     */
+    int lowerBound(qint64 timeUs) const;
+
+signals:
+    void revisionChanged();
+    void capacityChanged();
+
+private:
+    size_t slot(int index) const { return size_t((m_end - quint64(m_count) + quint64(index)) % quint64(m_capacity)); }
+
+    qint64 m_memoryBudget;
+    int m_capacity;
+
+    // Writer side, guarded by m_writeLock; setMemoryBudget() takes it to replace the columns
+    QMutex m_writeLock;
+    qint64 m_lastTimestampUs;
+    std::atomic<quint64> m_written; // Frames ever appended; released after their slot is filled
+    std::unique_ptr<std::atomic<qint64>[]> m_timestamps; // capacity entries
+    std::unique_ptr<std::atomic<double>[]> m_values;     // TelemetryChannelCount columns of capacity entries
+
+    // View, GUI thread only
+    quint64 m_clearedAt; // m_written at the last clear
+    quint64 m_end;       // One past the newest frame in the view
+    int m_count;
+    quint64 m_revision;
+    quint64 m_publishedRevision;
+};
+
+#endif // TELEMETRYHISTORY_H
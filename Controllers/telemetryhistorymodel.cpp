@@ -0,0 +1,218 @@
+#include "telemetryhistorymodel.h"
+#include <limits>
+
+/*TelemetryHistoryModel
+ * Table model over the GUI thread's view of a TelemetryHistory. The model only keeps the frame
+ * number of its first row and the stride; a cell is looked up in the ring when a view asks for
+ * it. After each publish the window is recomputed and turned into row removals at the front and
+ * insertions at the back.
+ */
+
+TelemetryHistoryModel::TelemetryHistoryModel(QObject *parent)
+    : QAbstractTableModel(parent),
+      m_duration(DefaultDuration),
+      m_maxRows(DefaultMaxRows),
+      m_first(0),
+      m_stride(1),
+      m_rows(0),
+      m_appended(0)
+{
+}
+
+void TelemetryHistoryModel::setHistory(TelemetryHistory *history)
+{
+    if (history == m_history)
+    {
+        return;
+    }
+
+    if (m_history)
+    {
+        disconnect(m_history, nullptr, this, nullptr);
+    }
+
+    m_history = history;
+    if (m_history)
+    {
+        connect(m_history, &TelemetryHistory::revisionChanged, this, &TelemetryHistoryModel::update);
+    }
+
+    reset();
+    emit historyChanged();
+}
+
+void TelemetryHistoryModel::setDuration(double seconds)
+{
+    seconds = qMax(0.0, seconds);
+    if (seconds == m_duration)
+    {
+        return;
+    }
+
+    m_duration = seconds;
+    reset();
+    emit windowChanged();
+}
+
+void TelemetryHistoryModel::setMaxRows(int rows)
+{
+    rows = qMax(0, rows);
+    if (rows == m_maxRows)
+    {
+        return;
+    }
+
+    m_maxRows = rows;
+    reset();
+    emit windowChanged();
+}
+
+int TelemetryHistoryModel::column(const QString &channel) const
+{
+    const int index = TelemetryHistory::channelIndex(channel);
+    return index < 0 ? -1 : index + 1;
+}
+
+int TelemetryHistoryModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int TelemetryHistoryModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 1 + TelemetryChannelCount;
+}
+
+QVariant TelemetryHistoryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows)
+    {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole)
+    {
+        return cell(index.row(), index.column());
+    }
+    if (role >= TimeRole && role < FirstChannelRole + TelemetryChannelCount)
+    {
+        return cell(index.row(), role - TimeRole);
+    }
+    return QVariant();
+}
+
+QHash<int, QByteArray> TelemetryHistoryModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles.insert(TimeRole, QByteArrayLiteral("time"));
+    forEachTelemetryChannel([&](const auto &channel, int index) { roles.insert(FirstChannelRole + index, QByteArray(channel.name)); });
+    return roles;
+}
+
+double TelemetryHistoryModel::cell(int row, int column) const
+{
+    if (!m_history)
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Other receivers of revisionChanged may ask before update() has moved the rows along
+    const quint64 oldest = m_history->appended() - quint64(m_history->count());
+    const qint64 index = qint64(m_first + quint64(row) * quint64(m_stride)) - qint64(oldest);
+    if (index < 0 || index >= m_history->count())
+    {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (column == 0)
+    {
+        return m_history->timestampUs(int(index)) / 1e6;
+    }
+    return m_history->value(column - 1, int(index));
+}
+
+void TelemetryHistoryModel::reset()
+{
+    beginResetModel();
+    m_first = 0;
+    m_stride = 1;
+    m_rows = 0;
+    m_appended = 0;
+    endResetModel();
+
+    update();
+    emit countChanged();
+}
+
+void TelemetryHistoryModel::update()
+{
+    if (!m_history)
+    {
+        return;
+    }
+
+    const quint64 appended = m_history->appended();
+    const quint64 oldest = appended - quint64(m_history->count());
+    const bool cleared = appended < m_appended;
+    m_appended = appended;
+
+    // Window start, then a stride that keeps it near maxRows rows. The stride only changes once
+    // the row count drifts well away from maxRows, so a steady window is not reset every frame.
+    int begin = 0;
+    if (m_duration > 0.0 && m_history->count() > 0)
+    {
+        begin = m_history->lowerBound(m_history->timestampUs(m_history->count() - 1) - qint64(m_duration * 1e6));
+    }
+    const quint64 from = oldest + quint64(begin);
+    const quint64 length = appended - from;
+
+    int stride = m_stride;
+    if (m_maxRows == 0)
+    {
+        stride = 1;
+    }
+    else if (length / quint64(stride) > quint64(m_maxRows) + quint64(m_maxRows) / 4
+             || (stride > 1 && length / quint64(stride) < quint64(m_maxRows) / 2))
+    {
+        stride = int(qMax<quint64>(1, (length + quint64(m_maxRows) - 1) / quint64(m_maxRows)));
+    }
+
+    // Rows sit on multiples of the stride, so they stay put as the window slides
+    const quint64 first = (from + quint64(stride) - 1) / quint64(stride) * quint64(stride);
+    const int rows = first < appended ? int((appended - 1 - first) / quint64(stride)) + 1 : 0;
+    const int oldRows = m_rows;
+
+    if (cleared || stride != m_stride || (m_rows > 0 && first < m_first))
+    {
+        beginResetModel();
+        m_first = first;
+        m_stride = stride;
+        m_rows = rows;
+        endResetModel();
+    }
+    else
+    {
+        const int removed = int(qMin<quint64>(quint64(m_rows), (first - m_first) / quint64(m_stride)));
+        if (removed > 0)
+        {
+            beginRemoveRows(QModelIndex(), 0, removed - 1);
+            m_first += quint64(removed) * quint64(m_stride);
+            m_rows -= removed;
+            endRemoveRows();
+        }
+
+        // Whatever is left of the old window is the head of the new one
+        m_first = first;
+        if (rows > m_rows)
+        {
+            beginInsertRows(QModelIndex(), m_rows, rows - 1);
+            m_rows = rows;
+            endInsertRows();
+        }
+    }
+
+    if (m_rows != oldRows)
+    {
+        emit countChanged();
+    }
+}
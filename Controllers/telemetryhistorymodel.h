@@ -0,0 +1,91 @@
+#ifndef TELEMETRYHISTORYMODEL_H
+#define TELEMETRYHISTORYMODEL_H
+
+#include <QAbstractTableModel>
+#include <QPointer>
+#include "telemetryhistory.h"
+
+/**
+ * @brief The TelemetryHistoryModel class exposes a sliding time window of a TelemetryHistory to QML
+ *
+ * The model has one row per frame of the last @c duration seconds and one column per value: the
+ * time in seconds (column 0, role "time") followed by every channel in table order (role named
+ * after the channel). Cells are read from the history's ring when a view asks for them, so no
+ * list of the window is ever built. It feeds a chart series through an XYModelMapper with
+ * xColumn/yColumn, or any view through roles such as model.lateralG.
+ *
+ * Windows longer than @c maxRows frames are thinned to every n-th frame. The rows are anchored
+ * to frame numbers, so as the window slides the model only removes rows at the front and
+ * inserts them at the back; it resets when the stride changes or the history is cleared.
+ */
+class TelemetryHistoryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+    Q_PROPERTY(TelemetryHistory *history READ history WRITE setHistory NOTIFY historyChanged)
+    Q_PROPERTY(double duration READ duration WRITE setDuration NOTIFY windowChanged)
+    Q_PROPERTY(int maxRows READ maxRows WRITE setMaxRows NOTIFY windowChanged)
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    static constexpr double DefaultDuration = 10.0;
+    static constexpr int DefaultMaxRows = 1000;
+
+    explicit TelemetryHistoryModel(QObject *parent = nullptr);
+
+    TelemetryHistory *history() const { return m_history; }
+    void setHistory(TelemetryHistory *history);
+
+    /**
+     * @brief Length of the window in seconds, back from the newest frame; 0 for the whole history
+     */
+    double duration() const { return m_duration; }
+    void setDuration(double seconds);
+
+    /**
+     * @brief Most rows the window is thinned to; 0 for every frame
+     */
+    int maxRows() const { return m_maxRows; }
+    void setMaxRows(int rows);
+
+    int count() const { return m_rows; }
+
+    /**
+     * @brief Column of a channel for XYModelMapper, or -1; column 0 is the time
+     */
+    Q_INVOKABLE int column(const QString &channel) const;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+signals:
+    void historyChanged();
+    void windowChanged();
+    void countChanged();
+
+private slots:
+    void update(); // Follows the history's view after each publish
+
+private:
+    enum Role
+    {
+        TimeRole = Qt::UserRole + 1,
+        FirstChannelRole // One role per channel from here, in table order
+    };
+
+    void reset();
+    double cell(int row, int column) const;
+
+    QPointer<TelemetryHistory> m_history;
+    double m_duration;
+    int m_maxRows;
+
+    // Rows are frames first, first + stride, ... (numbered like TelemetryHistory::appended())
+    quint64 m_first;
+    int m_stride;
+    int m_rows;
+    quint64 m_appended; // History's appended() at the last update
+};
+
+#endif // TELEMETRYHISTORYMODEL_H
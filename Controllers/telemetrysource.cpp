@@ -0,0 +1,445 @@
+#include "telemetrysource.h"
+#include <QMetaProperty>
+
+/*TelemetrySource
+ * Shared publishing path of the UDP and MQTT clients. Sequencing, the link statistics, the
+ * seqlock snapshot and the history are handled on the parser threads, so none of them waits for
+ * this object's event loop, and no frame crosses into it. The parsers only post a drain request
+ * when none is pending; the drain reads the newest frame from the snapshot and the new history
+ * rows. The per-channel work is generated from the TelemetryChannels table: one compare pass
+ * builds a change mask over the contiguous frame, then only the changed channels are stored and
+ * signalled.
+ */
+
+TelemetrySource::TelemetrySource(QObject *parent)
+    : QObject(parent),
+      m_recorder(this),
+      m_parserStage(&m_framePool),
+      m_sessionArrival(0),
+      m_linkStatisticsDue(false),
+      m_staleFramesDropped(0),
+      m_staleFramesSkipped(0),
+      m_history(this),
+      m_track(this),
+      m_gpsFixes(GpsFixQueueCapacity),
+      m_lastQueuedFix(0.0, 0.0),
+      m_gpsFixesSkipped(0),
+      m_drainPending(false),
+      m_drainedVersion(0),
+      m_publishMode(ImmediatePublishing),
+      m_coalescedUpdates(0),
+      m_coalescedSincePublish(false),
+      m_latestOnly(false),
+      m_reportedStaleDropped(0),
+      m_reportedStaleSkipped(0)
+{
+    // Resolve every channel's NOTIFY signal once, by the property name in the table
+    const QMetaObject *meta = &TelemetrySource::staticMetaObject;
+
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        using Type = typename std::decay_t<decltype(channel)>::Type;
+
+        const QMetaProperty property = meta->property(meta->indexOfProperty(channel.name));
+        Q_ASSERT_X(property.isValid() && property.hasNotifySignal(), "TelemetrySource",
+                   "Every TelemetryChannels row needs a Q_PROPERTY with a NOTIFY signal");
+        Q_ASSERT_X(property.metaType() == QMetaType::fromType<Type>(), "TelemetrySource",
+                   "Q_PROPERTY type does not match its TelemetryChannels row");
+
+        m_notifySignals[size_t(index)] = property.notifySignal();
+    });
+
+    // Frames are accepted on the parser threads; this object's thread only drains the result
+    connect(&m_parserStage, &ParserStage::frameParsed, this, &TelemetrySource::acceptParsedFrame, Qt::DirectConnection);
+    connect(&m_parserStage, &ParserStage::statisticsChanged, this, &TelemetrySource::parserStatisticsChanged);
+    connect(&m_parserStage, &ParserStage::scalingChanged, this, &TelemetrySource::parserScalingChanged);
+    connect(&m_parserStage, &ParserStage::parseErrorsChanged, this, &TelemetrySource::parseErrorsChanged);
+
+    m_parserStage.setRecorder(&m_recorder);
+    connect(&m_recorder, &SessionRecorder::recordingChanged, this, &TelemetrySource::recordingChanged);
+    connect(&m_recorder, &SessionRecorder::statisticsChanged, this, &TelemetrySource::recordingStatisticsChanged);
+    connect(&m_recorder, &SessionRecorder::errorOccurred, this, &TelemetrySource::errorOccurred);
+}
+
+void TelemetrySource::acceptParsedFrame(TelemetryFrame *frame)
+{
+    bool accepted;
+    {
+        QMutexLocker locker(&m_acceptLock);
+        accepted = acceptFrame(*frame);
+    }
+
+    m_framePool.release(frame);
+
+    // One request is enough however many frames arrive before it runs; the drain clears the flag
+    if (accepted && !m_drainPending.exchange(true, std::memory_order_acq_rel))
+    {
+        QMetaObject::invokeMethod(this, [this]() { requestDrain(); }, Qt::QueuedConnection);
+    }
+}
+
+bool TelemetrySource::acceptFrame(const TelemetryFrame &frame)
+{
+    // Dispatched before the last resetSession()
+    if (frame.arrival < m_sessionArrival.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    // Binary frames carry a sequence number and sender timestamp
+    if (frame.sequenced && m_linkStatistics.record(frame.sequence, frame.senderTimestampUs, frame.hostTimestampUs))
+    {
+        m_linkStatisticsDue.store(true, std::memory_order_relaxed);
+    }
+
+    if (frame.skippedBefore > 0)
+    {
+        m_staleFramesSkipped.fetch_add(frame.skippedBefore, std::memory_order_relaxed);
+    }
+
+    // Latest wins: a frame that finished parsing after a newer one is not shown
+    if (!m_sequencer.accept(frame))
+    {
+        m_staleFramesDropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Readers on other threads and the history see every accepted frame as soon as it is parsed
+    m_snapshot.store(frame);
+    m_history.append(frame);
+
+    // The track is fed from here rather than from the history, so however long the window does
+    // not render, a fix is only lost once the queue is full. A GPS fix repeats across the many
+    // frames sent between two updates of the receiver; only a new one is queued.
+    if ((frame.gpsLatitude != m_lastQueuedFix.y() || frame.gpsLongitude != m_lastQueuedFix.x())
+        && GpsTrack::isValidFix(frame.gpsLatitude, frame.gpsLongitude))
+    {
+        if (m_gpsFixes.tryPush(QueuedFix{frame.gpsLatitude, frame.gpsLongitude, m_gpsFixesSkipped}))
+        {
+            m_lastQueuedFix = QPointF(frame.gpsLongitude, frame.gpsLatitude);
+            m_gpsFixesSkipped = 0;
+        }
+        else
+        {
+            // The next fix that fits carries the count, so the track knows where the gap is
+            m_gpsFixesSkipped++;
+        }
+    }
+    return true;
+}
+
+void TelemetrySource::requestDrain()
+{
+    if (framePaced())
+    {
+        // Drained from afterAnimating, once for everything accepted until the window renders
+        m_frameWindow->requestUpdate();
+        return;
+    }
+
+    drainAcceptedFrames();
+}
+
+void TelemetrySource::drainAcceptedFrames()
+{
+    // Acquires the parsers' stores; a frame accepted after this posts a new request
+    m_drainPending.exchange(false, std::memory_order_acq_rel);
+
+    const quint64 version = m_snapshot.version();
+    if (version != m_drainedVersion)
+    {
+        const TelemetryFrame frame = m_snapshot.load();
+
+        // Every frame accepted since the last drain but the newest was never shown
+        const quint64 superseded = version - m_drainedVersion - 1;
+        m_drainedVersion = version;
+        if (superseded > 0)
+        {
+            m_coalescedUpdates += qint64(superseded);
+            m_coalescedSincePublish = true;
+        }
+
+        // Until the new session's first frame, the snapshot still holds the previous one
+        if (frame.arrival >= m_sessionArrival.load(std::memory_order_relaxed))
+        {
+            notifyChanges(frame);
+        }
+    }
+
+    emitStatisticsSignals();
+    m_history.publish();
+    feedTrack();
+    m_track.publish();
+}
+
+void TelemetrySource::feedTrack()
+{
+    QueuedFix fix;
+    while (m_gpsFixes.tryPop(fix))
+    {
+        m_track.skipFixes(fix.skippedBefore);
+        m_track.append(fix.latitude, fix.longitude);
+    }
+}
+
+void TelemetrySource::setFrameWindow(QQuickWindow *window)
+{
+    if (m_frameWindow == window)
+    {
+        return;
+    }
+
+    if (m_frameWindow)
+    {
+        disconnect(m_frameWindow, &QQuickWindow::afterAnimating, this, &TelemetrySource::drainAcceptedFrames);
+    }
+
+    // Publish whatever is waiting for the old window's next frame
+    drainAcceptedFrames();
+    m_frameWindow = window;
+
+    if (m_frameWindow)
+    {
+        // afterAnimating is emitted on the GUI thread at the start of every frame, before bindings are synced
+        connect(m_frameWindow, &QQuickWindow::afterAnimating, this, &TelemetrySource::drainAcceptedFrames);
+    }
+}
+
+void TelemetrySource::setPublishMode(PublishMode mode)
+{
+    if (m_publishMode == mode)
+    {
+        return;
+    }
+
+    m_publishMode = mode;
+    drainAcceptedFrames();
+    emit publishModeChanged();
+}
+
+void TelemetrySource::emitStatisticsSignals()
+{
+    // Counters change per packet; their signals go out at most once per publish
+    if (m_coalescedSincePublish)
+    {
+        m_coalescedSincePublish = false;
+        emit coalescedUpdatesChanged();
+    }
+
+    // Updated by the parsers; announced at most once per publish
+    if (m_linkStatisticsDue.exchange(false, std::memory_order_relaxed))
+    {
+        emit linkStatisticsChanged();
+    }
+
+    const qint64 staleDropped = staleFramesDropped();
+    const qint64 staleSkipped = staleFramesSkipped();
+    if (staleDropped != m_reportedStaleDropped || staleSkipped != m_reportedStaleSkipped)
+    {
+        m_reportedStaleDropped = staleDropped;
+        m_reportedStaleSkipped = staleSkipped;
+        emit sequencingStatisticsChanged();
+    }
+}
+
+void TelemetrySource::notifyChanges(const TelemetryFrame &frame)
+{
+    const quint32 changed = changedTelemetryChannels(m_values, frame);
+    if (changed == 0)
+    {
+        return;
+    }
+
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        if (changed & (quint32(1) << index))
+        {
+            m_values.*channel.member = frame.*channel.member;
+        }
+    });
+
+    forEachTelemetryChannel([&](const auto &channel, int index) {
+        using Type = typename std::decay_t<decltype(channel)>::Type;
+
+        if (changed & (quint32(1) << index))
+        {
+            // Passed by value: invoke() type-checks the argument against the signal's parameter
+            m_notifySignals[size_t(index)].invoke(this, Qt::DirectConnection, Type(m_values.*channel.member));
+        }
+    });
+}
+
+QVariantMap TelemetrySource::snapshotValues() const
+{
+    const TelemetryFrame frame = snapshot();
+    QVariantMap values;
+
+    forEachTelemetryChannel([&](const auto &channel, int) {
+        values.insert(QLatin1String(channel.name), QVariant::fromValue(frame.*channel.member));
+    });
+
+    return values;
+}
+
+void TelemetrySource::setLatestOnly(bool enabled)
+{
+    if (m_latestOnly == enabled)
+    {
+        return;
+    }
+
+    m_latestOnly = enabled;
+    m_parserStage.setLatestOnly(enabled);
+    emit latestOnlyChanged(enabled);
+}
+
+void TelemetrySource::setQueueCapacity(int capacity)
+{
+    if (capacity == m_parserStage.queueCapacity())
+    {
+        return;
+    }
+
+    m_parserStage.setQueueCapacity(capacity);
+    emit parserConfigurationChanged();
+}
+
+bool TelemetrySource::setOverflowPolicy(const QString &policy)
+{
+    UdpParserWorker::OverflowPolicy requested;
+
+    if (policy.compare(QLatin1String("drop-newest"), Qt::CaseInsensitive) == 0)
+    {
+        requested = UdpParserWorker::DropNewest;
+    }
+    else if (policy.compare(QLatin1String("drop-oldest"), Qt::CaseInsensitive) == 0)
+    {
+        requested = UdpParserWorker::DropOldest;
+    }
+    else if (policy.compare(QLatin1String("block"), Qt::CaseInsensitive) == 0)
+    {
+        requested = UdpParserWorker::BlockProducer;
+    }
+    else
+    {
+        return false;
+    }
+
+    // Running parsers switch immediately
+    m_parserStage.setOverflowPolicy(requested);
+    emit parserConfigurationChanged();
+    return true;
+}
+
+QString TelemetrySource::overflowPolicy() const
+{
+    switch (m_parserStage.overflowPolicy())
+    {
+    case UdpParserWorker::DropOldest:
+        return QStringLiteral("drop-oldest");
+    case UdpParserWorker::BlockProducer:
+        return QStringLiteral("block");
+    case UdpParserWorker::DropNewest:
+        break;
+    }
+    return QStringLiteral("drop-newest");
+}
+
+QVariantList TelemetrySource::parserDrops() const
+{
+    QVariantList drops;
+    for (qint64 count : m_parserStage.datagramsDroppedPerParser())
+    {
+        drops.append(count);
+    }
+    return drops;
+}
+
+QVariantMap TelemetrySource::parseErrors() const
+{
+    const QList<qint64> counts = m_parserStage.parseErrorCounts();
+
+    QVariantMap errors;
+    for (int reason = 0; reason < counts.size(); ++reason)
+    {
+        errors.insert(ParserStage::parseErrorName(UdpParserWorker::ParseError(reason)), counts[reason]);
+    }
+    return errors;
+}
+
+qint64 TelemetrySource::parseErrorTotal() const
+{
+    qint64 total = 0;
+    for (qint64 count : m_parserStage.parseErrorCounts())
+    {
+        total += count;
+    }
+    return total;
+}
+
+QString TelemetrySource::parseErrorSample() const
+{
+    if (!m_parserStage.hasErrorSample())
+    {
+        return QString();
+    }
+
+    const UdpParserWorker::ErrorSample &sample = m_parserStage.lastErrorSample();
+    return QStringLiteral("%1: %2").arg(ParserStage::parseErrorName(sample.reason), ParserStage::describeSample(sample));
+}
+
+qint64 TelemetrySource::framesLost() const
+{
+    QMutexLocker locker(&m_acceptLock);
+    return m_linkStatistics.framesLost();
+}
+
+double TelemetrySource::linkLatencyMs() const
+{
+    QMutexLocker locker(&m_acceptLock);
+    return m_linkStatistics.latencyMs();
+}
+
+void TelemetrySource::setParserThreadBounds(int minimum, int maximum)
+{
+    m_parserStage.setThreadBounds(minimum, maximum);
+    emit parserConfigurationChanged();
+}
+
+bool TelemetrySource::startRecording(const QString &sessionName)
+{
+    return m_recorder.start(sessionName);
+}
+
+void TelemetrySource::stopRecording()
+{
+    m_recorder.stop();
+}
+
+void TelemetrySource::resetSession()
+{
+    {
+        // Parsers may still be finishing frames of the previous session
+        QMutexLocker locker(&m_acceptLock);
+        m_sessionArrival.store(m_parserStage.nextArrival(), std::memory_order_relaxed);
+        m_linkStatistics.reset();
+        m_sequencer.reset();
+        m_linkStatisticsDue.store(false, std::memory_order_relaxed);
+        m_staleFramesDropped.store(0, std::memory_order_relaxed);
+        m_staleFramesSkipped.store(0, std::memory_order_relaxed);
+        m_history.reset();
+
+        // This thread is the queue's consumer; under the lock no parser pushes meanwhile
+        QueuedFix fix;
+        while (m_gpsFixes.tryPop(fix))
+        {
+        }
+        m_lastQueuedFix = QPointF(0.0, 0.0);
+        m_gpsFixesSkipped = 0;
+    }
+    m_reportedStaleDropped = 0;
+    m_reportedStaleSkipped = 0;
+    m_history.publish();
+    m_track.clear();
+
+    emit linkStatisticsChanged();
+    emit sequencingStatisticsChanged();
+}
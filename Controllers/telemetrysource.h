@@ -0,0 +1,409 @@
+#ifndef TELEMETRYSOURCE_H
+#define TELEMETRYSOURCE_H
+
+#include <QObject>
+#include <QMetaMethod>
+#include <QMutex>
+#include <QPointer>
+#include <QQuickWindow>
+#include <QVariantList>
+#include <QVariantMap>
+#include <array>
+#include <atomic>
+#include "telemetrychannels.h"
+#include "framesequencer.h"
+#include "linkstatistics.h"
+#include "parserstage.h"
+#include "seqlocksnapshot.h"
+#include "sessionrecorder.h"
+#include "spscringbuffer.h"
+#include "telemetryframepool.h"
+#include "gpstrack.h"
+#include "telemetryhistory.h"
+
+/**
+ * @brief The TelemetrySource class is the QML-facing base of UdpClient and MqttClient
+ *
+ * It owns the parser stage both clients feed their raw packets into, with its bounded queues
+ * and drop accounting, and the frame pool the parsers draw from.
+ *
+ * It also owns the latest value of every channel in one contiguous TelemetryFrame, which it
+ * updates from the newest accepted frame when it drains: the changed channels are found by the
+ * table-driven compare in telemetrychannels.h and their NOTIFY signals are emitted through
+ * meta-methods looked up once by channel name.
+ *
+ * Parsed frames never cross into this object's thread. The parser that accepts a frame posts a
+ * drain request only if none is pending, so however fast frames arrive this thread handles at
+ * most one request per drain. The drain reads the newest frame from the snapshot, publishes the
+ * history and feeds the GPS track from a queue of the new fixes the parsers accepted. In
+ * ImmediatePublishing mode the request drains at once; in FramePublishing mode it asks the
+ * window for an update and the drain runs from QQuickWindow::afterAnimating, just before QML
+ * bindings and canvases would be evaluated anyway. Frames accepted but replaced before a drain
+ * showed them are counted in coalescedUpdates.
+ *
+ * Frames are accepted on the parser thread that produced them: under a short lock shared only
+ * by the parsers they pass a FrameSequencer, so a frame older than the last one accepted
+ * (parallel parsers finish out of order) is dropped instead of moving the needles backwards,
+ * and the link statistics are updated. In latestOnly mode the parsers themselves skip
+ * datagrams that went stale in their queue.
+ *
+ * Every datagram handed to the parser stage can be recorded to an append-only session log with
+ * startRecording(); the SessionRecorder copies on the producer thread and writes on its own.
+ *
+ * Every accepted frame is stored in a seqlock by the parser that accepted it, so snapshot()
+ * returns one consistent frame to any thread - e.g. the lateral/longitudinal G pair from the
+ * same packet - and keeps up even while this object's thread is busy. The same parser appends
+ * the frame to the history; this thread's view of it moves on with each publish.
+ *
+ * The Q_PROPERTY, getter and signal declarations below are the only per-channel code that is
+ * still written by hand, because moc cannot expand templates. The constructor asserts that each
+ * row of TelemetryChannels has a matching property of the same type.
+ */
+class TelemetrySource : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(float speed READ speed NOTIFY speedChanged)
+    Q_PROPERTY(int rpm READ rpm NOTIFY rpmChanged)
+    Q_PROPERTY(int accPedal READ accPedal NOTIFY accPedalChanged)
+    Q_PROPERTY(int brakePedal READ brakePedal NOTIFY brakePedalChanged)
+    Q_PROPERTY(double encoderAngle READ encoderAngle NOTIFY encoderAngleChanged)
+    Q_PROPERTY(float temperature READ temperature NOTIFY temperatureChanged)
+    Q_PROPERTY(int batteryLevel READ batteryLevel NOTIFY batteryLevelChanged)
+    Q_PROPERTY(double gpsLongitude READ gpsLongitude NOTIFY gpsLongitudeChanged)
+    Q_PROPERTY(double gpsLatitude READ gpsLatitude NOTIFY gpsLatitudeChanged)
+    Q_PROPERTY(int speedFL READ speedFL NOTIFY speedFLChanged)
+    Q_PROPERTY(int speedFR READ speedFR NOTIFY speedFRChanged)
+    Q_PROPERTY(int speedBL READ speedBL NOTIFY speedBLChanged)
+    Q_PROPERTY(int speedBR READ speedBR NOTIFY speedBRChanged)
+    Q_PROPERTY(double lateralG READ lateralG NOTIFY lateralGChanged)
+    Q_PROPERTY(double longitudinalG READ longitudinalG NOTIFY longitudinalGChanged)
+
+    // Link statistics from the binary wire format's sequence numbers and sender timestamps
+    Q_PROPERTY(qint64 framesLost READ framesLost NOTIFY linkStatisticsChanged)
+    Q_PROPERTY(double linkLatencyMs READ linkLatencyMs NOTIFY linkStatisticsChanged)
+
+    Q_PROPERTY(PublishMode publishMode READ publishMode WRITE setPublishMode NOTIFY publishModeChanged)
+    Q_PROPERTY(qint64 coalescedUpdates READ coalescedUpdates NOTIFY coalescedUpdatesChanged)
+
+    // Latest-wins sequencing
+    Q_PROPERTY(bool latestOnly READ latestOnly WRITE setLatestOnly NOTIFY latestOnlyChanged)
+    Q_PROPERTY(qint64 staleFramesDropped READ staleFramesDropped NOTIFY sequencingStatisticsChanged)
+    Q_PROPERTY(qint64 staleFramesSkipped READ staleFramesSkipped NOTIFY sequencingStatisticsChanged)
+
+    // Parser queues; a new capacity applies from the next start(), a new policy immediately
+    Q_PROPERTY(int queueCapacity READ queueCapacity WRITE setQueueCapacity NOTIFY parserConfigurationChanged)
+    Q_PROPERTY(QString overflowPolicy READ overflowPolicy NOTIFY parserConfigurationChanged)
+    Q_PROPERTY(qint64 datagramsDropped READ datagramsDropped NOTIFY parserStatisticsChanged)
+    Q_PROPERTY(QVariantList parserDrops READ parserDrops NOTIFY parserStatisticsChanged)
+    Q_PROPERTY(qint64 datagramsStolen READ datagramsStolen NOTIFY parserStatisticsChanged)
+    Q_PROPERTY(qint64 bufferOverflows READ bufferOverflows NOTIFY parserStatisticsChanged)
+
+    // Rejected datagrams, summarized once per ParserStage::StatsIntervalMs
+    Q_PROPERTY(QVariantMap parseErrors READ parseErrors NOTIFY parseErrorsChanged)
+    Q_PROPERTY(qint64 parseErrorTotal READ parseErrorTotal NOTIFY parseErrorsChanged)
+    Q_PROPERTY(QString parseErrorSample READ parseErrorSample NOTIFY parseErrorsChanged)
+
+    // Recent values of every channel for plots
+    Q_PROPERTY(TelemetryHistory *history READ history CONSTANT)
+    Q_PROPERTY(GpsTrack *track READ track CONSTANT)
+
+    // Raw datagram log of the session
+    Q_PROPERTY(bool recording READ recording NOTIFY recordingChanged)
+    Q_PROPERTY(QString recordingPath READ recordingPath NOTIFY recordingChanged)
+    Q_PROPERTY(qint64 recordedDatagrams READ recordedDatagrams NOTIFY recordingStatisticsChanged)
+    Q_PROPERTY(qint64 recordingDropped READ recordingDropped NOTIFY recordingStatisticsChanged)
+    Q_PROPERTY(qint64 recordedBytes READ recordedBytes NOTIFY recordingStatisticsChanged)
+
+    // Parser autoscaling; the bounds apply from the next start()
+    Q_PROPERTY(int minimumParsers READ minimumParsers NOTIFY parserConfigurationChanged)
+    Q_PROPERTY(int maximumParsers READ maximumParsers NOTIFY parserConfigurationChanged)
+    Q_PROPERTY(int activeParsers READ activeParsers NOTIFY parserScalingChanged)
+    Q_PROPERTY(QString parserScalingDecision READ parserScalingDecision NOTIFY parserScalingChanged)
+    Q_PROPERTY(double parserUtilization READ parserUtilization NOTIFY parserStatisticsChanged)
+    Q_PROPERTY(double parseTimeUs READ parseTimeUs NOTIFY parserStatisticsChanged)
+    Q_PROPERTY(int parserQueueDepth READ parserQueueDepth NOTIFY parserStatisticsChanged)
+
+public:
+    enum PublishMode
+    {
+        ImmediatePublishing, // Notify as soon as this object's thread gets to the newest frame
+        FramePublishing      // Notify at most once per frame of the window set with setFrameWindow()
+    };
+    Q_ENUM(PublishMode)
+
+    explicit TelemetrySource(QObject *parent = nullptr);
+
+    /**
+     * @brief Set the window whose frame cycle paces FramePublishing
+     *
+     * Without a window FramePublishing behaves like ImmediatePublishing.
+     */
+    void setFrameWindow(QQuickWindow *window);
+
+    void setPublishMode(PublishMode mode);
+    PublishMode publishMode() const { return m_publishMode; }
+
+    /**
+     * @brief Number of accepted frames that were replaced by a newer one before being shown
+     */
+    qint64 coalescedUpdates() const { return m_coalescedUpdates; }
+
+    /**
+     * @brief Let parsers that fall behind skip straight to their newest queued datagram
+     */
+    void setLatestOnly(bool enabled);
+    bool latestOnly() const { return m_latestOnly; }
+
+    /**
+     * @brief Maximum number of datagrams queued per parser; takes effect on the next start()
+     */
+    void setQueueCapacity(int capacity);
+    int queueCapacity() const { return m_parserStage.queueCapacity(); }
+
+    /**
+     * @brief Select what a parser does with a datagram that arrives while its queue is full
+     * @param policy "drop-newest" (default), "drop-oldest", or "block" to stall the dispatching
+     * thread until the parser catches up (only sensible when the receiver thread dispatches)
+     * @return False if the policy name is unknown
+     */
+    Q_INVOKABLE bool setOverflowPolicy(const QString &policy);
+    QString overflowPolicy() const;
+
+    /**
+     * @brief Datagrams discarded by full parser queues in the current session, in total and per parser
+     */
+    qint64 datagramsDropped() const { return m_parserStage.datagramsDropped(); }
+    QVariantList parserDrops() const;
+
+    /**
+     * @brief Datagrams an idle parser took over from a busy sibling in the current session
+     */
+    qint64 datagramsStolen() const { return m_parserStage.datagramsStolen(); }
+
+    /**
+     * @brief Datagram payloads that had to be allocated because the buffer pool was empty
+     */
+    qint64 bufferOverflows() const { return m_parserStage.bufferOverflows(); }
+
+    /**
+     * @brief Datagrams rejected in the current session, by reason ("wrong-field-count", "bad-value", ...)
+     */
+    QVariantMap parseErrors() const;
+    qint64 parseErrorTotal() const;
+
+    /**
+     * @brief Reason and printable payload of a recently rejected datagram; empty if none was rejected
+     */
+    QString parseErrorSample() const;
+
+    /**
+     * @brief History of the accepted frames of the current session
+     */
+    TelemetryHistory *history() { return &m_history; }
+
+    /**
+     * @brief Simplified GPS track of the current session
+     */
+    GpsTrack *track() { return &m_track; }
+
+    /**
+     * @brief Record every received datagram to a new log named after @p sessionName
+     *
+     * May be called before or after start(); datagrams received while recording are written to
+     * SessionRecorder::recordingDirectory() in the SessionLogFormat layout.
+     * @return False if the log could not be created
+     */
+    Q_INVOKABLE bool startRecording(const QString &sessionName);
+
+    /**
+     * @brief Flush and close the session log
+     */
+    Q_INVOKABLE void stopRecording();
+
+    bool recording() const { return m_recorder.isRecording(); }
+    QString recordingPath() const { return m_recorder.filePath(); }
+    qint64 recordedDatagrams() const { return m_recorder.recordedDatagrams(); }
+    qint64 recordingDropped() const { return m_recorder.droppedDatagrams(); }
+    qint64 recordedBytes() const { return m_recorder.writtenBytes(); }
+
+    /**
+     * @brief Let the number of parser threads follow the load between @p minimum and @p maximum
+     *
+     * Equal bounds pin the count. Takes effect on the next start().
+     */
+    Q_INVOKABLE void setParserThreadBounds(int minimum, int maximum);
+    int minimumParsers() const { return m_parserStage.minimumThreads(); }
+    int maximumParsers() const { return m_parserStage.maximumThreads(); }
+
+    /**
+     * @brief Parser load as last measured by the autoscaler, and its most recent decision
+     */
+    int activeParsers() const { return m_parserStage.activeWorkers(); }
+    QString parserScalingDecision() const { return m_parserStage.lastScalingDecision(); }
+    double parserUtilization() const { return m_parserStage.utilisation(); }
+    double parseTimeUs() const { return m_parserStage.parseTimeUs(); }
+    int parserQueueDepth() const { return m_parserStage.queueDepth(); }
+
+    /**
+     * @brief Frames dropped because a newer frame had already been accepted
+     */
+    qint64 staleFramesDropped() const { return m_staleFramesDropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Datagrams the parsers skipped without parsing in latest-only mode
+     */
+    qint64 staleFramesSkipped() const { return m_staleFramesSkipped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief The newest accepted frame, all channels from the same packet
+     *
+     * Safe to call from any thread. Wait-free in practice, never blocks the parsers, and does
+     * not wait for this object's thread to process the frame.
+     */
+    TelemetryFrame snapshot() const { return m_snapshot.load(); }
+
+    /**
+     * @brief Number of frames accepted so far; compare against a previous value to detect new data
+     */
+    quint64 snapshotVersion() const { return m_snapshot.version(); }
+
+    /**
+     * @brief snapshot() for QML, as a map from channel name to value
+     */
+    Q_INVOKABLE QVariantMap snapshotValues() const;
+
+    // Property getters
+    float speed() const { return m_values.speed; }
+    int rpm() const { return m_values.rpm; }
+    int accPedal() const { return m_values.accPedal; }
+    int brakePedal() const { return m_values.brakePedal; }
+    double encoderAngle() const { return m_values.encoderAngle; }
+    float temperature() const { return m_values.temperature; }
+    int batteryLevel() const { return m_values.batteryLevel; }
+    double gpsLongitude() const { return m_values.gpsLongitude; }
+    double gpsLatitude() const { return m_values.gpsLatitude; }
+    int speedFL() const { return m_values.speedFL; }
+    int speedFR() const { return m_values.speedFR; }
+    int speedBL() const { return m_values.speedBL; }
+    int speedBR() const { return m_values.speedBR; }
+    double lateralG() const { return m_values.lateralG; }
+    double longitudinalG() const { return m_values.longitudinalG; }
+
+    qint64 framesLost() const;
+    double linkLatencyMs() const;
+
+signals:
+    // Property change signals
+    void speedChanged(float newSpeed);
+    void rpmChanged(int newRpm);
+    void accPedalChanged(int newAccPedal);
+    void brakePedalChanged(int newBrakePedal);
+    void encoderAngleChanged(double newAngle);
+    void temperatureChanged(float newTemperature);
+    void batteryLevelChanged(int newBatteryLevel);
+    void gpsLongitudeChanged(double newLongitude);
+    void gpsLatitudeChanged(double newLatitude);
+    void speedFLChanged(int newSpeedFL);
+    void speedFRChanged(int newSpeedFR);
+    void speedBLChanged(int newSpeedBL);
+    void speedBRChanged(int newSpeedBR);
+    void lateralGChanged(double newLateralG);
+    void longitudinalGChanged(double newLongitudinalG);
+
+    // Error signal
+    void errorOccurred(const QString &error);
+
+    void linkStatisticsChanged();
+
+    void publishModeChanged();
+    void coalescedUpdatesChanged();
+    void latestOnlyChanged(bool latestOnly);
+    void sequencingStatisticsChanged();
+    void parserConfigurationChanged();
+    void parserStatisticsChanged();
+    void parserScalingChanged();
+    void parseErrorsChanged();
+    void recordingChanged();
+    void recordingStatisticsChanged();
+
+protected:
+    /**
+     * @brief Forget the link and sequencing state, e.g. when a new session starts
+     *
+     * Frames of datagrams dispatched before the call are discarded when they come back from the
+     * parsers, so a session cannot inherit stragglers of the previous one. The producer must not
+     * dispatch old datagrams concurrently with this call.
+     */
+    void resetSession();
+
+    ParserStage &parserStage() { return m_parserStage; }
+    const ParserStage &parserStage() const { return m_parserStage; }
+
+private slots:
+    void acceptParsedFrame(TelemetryFrame *frame); // Runs on the parser thread that produced the frame
+
+    /**
+     * @brief Notify the channels changed by the newest accepted frame and publish the history and track
+     *
+     * All changed values are stored before the first signal is emitted, so handlers always read
+     * a consistent frame. Runs once per window frame in FramePublishing mode.
+     */
+    void drainAcceptedFrames();
+
+private:
+    bool acceptFrame(const TelemetryFrame &frame); // Parser side; m_acceptLock must be held
+    void requestDrain();                           // Posted by the parsers, at most one at a time
+    void feedTrack();
+    void notifyChanges(const TelemetryFrame &frame);
+    void emitStatisticsSignals();
+    bool framePaced() const { return m_publishMode == FramePublishing && m_frameWindow; }
+
+    TelemetryFramePool m_framePool; // Declared before the stage: parsers hold frames until they stop
+    SessionRecorder m_recorder;     // Likewise: the stage's producer tees into it
+    ParserStage m_parserStage;
+
+    TelemetryFrame m_values;                                       // Latest value of every channel
+    std::array<QMetaMethod, TelemetryChannelCount> m_notifySignals; // Indexed like TelemetryChannels
+
+    // Parser side: taken by one parser at a time per frame; this thread only takes it for resets and reads
+    mutable QMutex m_acceptLock;
+    LinkStatistics m_linkStatistics;            // Guarded by m_acceptLock
+    FrameSequencer m_sequencer;                 // Guarded by m_acceptLock
+    std::atomic<quint64> m_sessionArrival;      // Written under m_acceptLock; first arrival stamp of the session
+    SeqLockSnapshot<TelemetryFrame> m_snapshot; // Stored under m_acceptLock, read from any thread
+    std::atomic<bool> m_linkStatisticsDue;      // linkStatisticsChanged is due with the next publish
+    std::atomic<qint64> m_staleFramesDropped;
+    std::atomic<qint64> m_staleFramesSkipped;
+    TelemetryHistory m_history; // Appended under m_acceptLock
+    GpsTrack m_track;
+
+    // GPS fixes for the track: pushed under m_acceptLock, popped by the drain. About an hour of
+    // fixes from a 20 Hz receiver, so the track survives a window that does not render for long.
+    struct QueuedFix
+    {
+        double latitude = 0.0;
+        double longitude = 0.0;
+        qint64 skippedBefore = 0; // Fixes lost to a full queue just before this one
+    };
+    static constexpr int GpsFixQueueCapacity = 64 * 1024;
+    SpscRingBuffer<QueuedFix> m_gpsFixes;
+    QPointF m_lastQueuedFix;   // (longitude, latitude); guarded by m_acceptLock
+    qint64 m_gpsFixesSkipped;  // Since the last queued fix; guarded by m_acceptLock
+
+    // Draining
+    std::atomic<bool> m_drainPending; // A drain request is posted and has not run yet
+    quint64 m_drainedVersion;         // m_snapshot's version at the last drain
+
+    // Frame-synchronous publishing
+    PublishMode m_publishMode;
+    QPointer<QQuickWindow> m_frameWindow;
+    qint64 m_coalescedUpdates;
+    bool m_coalescedSincePublish; // coalescedUpdatesChanged is due with the next publish
+
+    // Sequencing
+    bool m_latestOnly;
+    qint64 m_reportedStaleDropped; // Counts last announced with sequencingStatisticsChanged
+    qint64 m_reportedStaleSkipped;
+};
+
+#endif // TELEMETRYSOURCE_H
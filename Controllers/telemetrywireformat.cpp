@@ -0,0 +1,139 @@
+#include "telemetrywireformat.h"
+#include <bit>
+#include <limits>
+
+/*Byte-level codec for the binary telemetry frame. Fields are assembled byte by byte, which is
+ * endian-independent and alignment-safe, and floats are moved through std::bit_cast.
+ */
+
+namespace
+{
+template <typename T>
+T readLE(const char *data)
+{
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data);
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        value |= T(bytes[i]) << (8 * i);
+    }
+    return value;
+}
+
+template <typename T>
+void writeLE(char *out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        out[i] = char((value >> (8 * i)) & 0xFF);
+    }
+}
+
+inline float readFloat(const char *data) { return std::bit_cast<float>(readLE<quint32>(data)); }
+inline double readDouble(const char *data) { return std::bit_cast<double>(readLE<quint64>(data)); }
+inline void writeFloat(char *out, float value) { writeLE<quint32>(out, std::bit_cast<quint32>(value)); }
+inline void writeDouble(char *out, double value) { writeLE<quint64>(out, std::bit_cast<quint64>(value)); }
+
+template <typename Wire>
+Wire clampTo(int value)
+{
+    return Wire(qBound<int>(std::numeric_limits<Wire>::min(), value, std::numeric_limits<Wire>::max()));
+}
+
+// Version 1 field offsets, see the table in telemetrywireformat.h
+enum Offset
+{
+    MagicOffset = 0,
+    VersionOffset = 1,
+    SequenceOffset = 2,
+    TimestampOffset = 6,
+    SpeedOffset = 14,
+    RpmOffset = 18,
+    AccPedalOffset = 20,
+    BrakePedalOffset = 21,
+    EncoderAngleOffset = 22,
+    TemperatureOffset = 26,
+    BatteryLevelOffset = 30,
+    GpsLongitudeOffset = 31,
+    GpsLatitudeOffset = 39,
+    SpeedFLOffset = 47,
+    SpeedFROffset = 49,
+    SpeedBLOffset = 51,
+    SpeedBROffset = 53,
+    LateralGOffset = 55,
+    LongitudinalGOffset = 59,
+    EndOffset = 63
+};
+static_assert(EndOffset == TelemetryWireFormat::FrameSize, "Offset table and FrameSize disagree");
+} // namespace
+
+TelemetryWireFormat::Status TelemetryWireFormat::decode(const char *data, qsizetype size, TelemetryFrame &frame)
+{
+    if (size < 2)
+    {
+        return TooShort;
+    }
+
+    if (quint8(data[VersionOffset]) != Version)
+    {
+        return UnsupportedVersion;
+    }
+
+    if (size < FrameSize)
+    {
+        return TooShort;
+    }
+
+    frame.sequenced = true;
+    frame.sequence = readLE<quint32>(data + SequenceOffset);
+    frame.senderTimestampUs = readLE<quint64>(data + TimestampOffset);
+
+    frame.speed = readFloat(data + SpeedOffset);
+    frame.rpm = readLE<quint16>(data + RpmOffset);
+    frame.accPedal = readLE<quint8>(data + AccPedalOffset);
+    frame.brakePedal = readLE<quint8>(data + BrakePedalOffset);
+    frame.encoderAngle = readFloat(data + EncoderAngleOffset);
+    frame.temperature = readFloat(data + TemperatureOffset);
+    frame.batteryLevel = readLE<quint8>(data + BatteryLevelOffset);
+    frame.gpsLongitude = readDouble(data + GpsLongitudeOffset);
+    frame.gpsLatitude = readDouble(data + GpsLatitudeOffset);
+    frame.speedFL = qint16(readLE<quint16>(data + SpeedFLOffset));
+    frame.speedFR = qint16(readLE<quint16>(data + SpeedFROffset));
+    frame.speedBL = qint16(readLE<quint16>(data + SpeedBLOffset));
+    frame.speedBR = qint16(readLE<quint16>(data + SpeedBROffset));
+    frame.lateralG = readFloat(data + LateralGOffset);
+    frame.longitudinalG = readFloat(data + LongitudinalGOffset);
+
+    return Ok;
+}
+
+void TelemetryWireFormat::encode(const TelemetryFrame &frame, quint32 sequence, quint64 senderTimestampUs, char *out)
+{
+    out[MagicOffset] = char(Magic);
+    out[VersionOffset] = char(Version);
+    writeLE<quint32>(out + SequenceOffset, sequence);
+    writeLE<quint64>(out + TimestampOffset, senderTimestampUs);
+
+    writeFloat(out + SpeedOffset, frame.speed);
+    writeLE<quint16>(out + RpmOffset, clampTo<quint16>(frame.rpm));
+    writeLE<quint8>(out + AccPedalOffset, clampTo<quint8>(frame.accPedal));
+    writeLE<quint8>(out + BrakePedalOffset, clampTo<quint8>(frame.brakePedal));
+    writeFloat(out + EncoderAngleOffset, float(frame.encoderAngle));
+    writeFloat(out + TemperatureOffset, frame.temperature);
+    writeLE<quint8>(out + BatteryLevelOffset, clampTo<quint8>(frame.batteryLevel));
+    writeDouble(out + GpsLongitudeOffset, frame.gpsLongitude);
+    writeDouble(out + GpsLatitudeOffset, frame.gpsLatitude);
+    writeLE<quint16>(out + SpeedFLOffset, quint16(clampTo<qint16>(frame.speedFL)));
+    writeLE<quint16>(out + SpeedFROffset, quint16(clampTo<qint16>(frame.speedFR)));
+    writeLE<quint16>(out + SpeedBLOffset, quint16(clampTo<qint16>(frame.speedBL)));
+    writeLE<quint16>(out + SpeedBROffset, quint16(clampTo<qint16>(frame.speedBR)));
+    writeFloat(out + LateralGOffset, float(frame.lateralG));
+    writeFloat(out + LongitudinalGOffset, float(frame.longitudinalG));
+}
+
+QByteArray TelemetryWireFormat::encode(const TelemetryFrame &frame, quint32 sequence, quint64 senderTimestampUs)
+{
+    QByteArray packet(FrameSize, Qt::Uninitialized);
+    encode(frame, sequence, senderTimestampUs, packet.data());
+    return packet;
+}
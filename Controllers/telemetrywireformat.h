@@ -0,0 +1,88 @@
+#ifndef TELEMETRYWIREFORMAT_H
+#define TELEMETRYWIREFORMAT_H
+
+#include <QByteArray>
+#include "telemetryframe.h"
+
+/**
+ * @brief The TelemetryWireFormat class encodes and decodes the fixed-layout binary telemetry frame
+ *
+ * All multi-byte fields are little-endian and unaligned. Version 1 layout (63 bytes):
+ *
+ * | Offset | Type | Field             |
+ * |--------|------|-------------------|
+ * | 0      | u8   | magic (0xA5)      |
+ * | 1      | u8   | schema version    |
+ * | 2      | u32  | sequence number   |
+ * | 6      | u64  | sender time (µs)  |
+ * | 14     | f32  | speed             |
+ * | 18     | u16  | rpm               |
+ * | 20     | u8   | accPedal          |
+ * | 21     | u8   | brakePedal        |
+ * | 22     | f32  | encoderAngle      |
+ * | 26     | f32  | temperature       |
+ * | 30     | u8   | batteryLevel      |
+ * | 31     | f64  | gpsLongitude      |
+ * | 39     | f64  | gpsLatitude       |
+ * | 47     | i16  | speedFL           |
+ * | 49     | i16  | speedFR           |
+ * | 51     | i16  | speedBL           |
+ * | 53     | i16  | speedBR           |
+ * | 55     | f32  | lateralG          |
+ * | 59     | f32  | longitudinalG     |
+ *
+ * The magic byte can never start a CSV packet (digits, sign or whitespace), so every packet
+ * can be routed to the right decoder by its first byte.
+ */
+class TelemetryWireFormat
+{
+public:
+    static constexpr quint8 Magic = 0xA5;
+    static constexpr quint8 Version = 1;
+    static constexpr int FrameSize = 63;
+
+    // A sequence number more than this far behind the highest one seen means the sender restarted
+    // its counter; FrameSequencer and LinkStatistics must agree on it
+    static constexpr qint64 SequenceRestartThreshold = 10000;
+
+    enum Status
+    {
+        Ok,
+        TooShort,          // Fewer than FrameSize bytes
+        UnsupportedVersion // Schema version this build does not know
+    };
+
+    /**
+     * @brief Whether a packet uses the binary format rather than CSV
+     */
+    static bool isBinary(const char *data, qsizetype size)
+    {
+        return size > 0 && quint8(data[0]) == Magic;
+    }
+
+    static bool isBinary(const QByteArray &data) { return isBinary(data.constData(), data.size()); }
+
+    /**
+     * @brief Decode a binary packet into a frame
+     * @param data First byte of the packet (the magic byte)
+     * @param size Packet length in bytes
+     * @param frame Receives the values and link metadata; only fully valid on Ok
+     */
+    static Status decode(const char *data, qsizetype size, TelemetryFrame &frame);
+
+    static Status decode(const QByteArray &data, TelemetryFrame &frame)
+    {
+        return decode(data.constData(), data.size(), frame);
+    }
+
+    /**
+     * @brief Encode a frame into FrameSize bytes at @p out
+     *
+     * Integer channels are clamped to their wire type. Used by simulators and replay tools.
+     */
+    static void encode(const TelemetryFrame &frame, quint32 sequence, quint64 senderTimestampUs, char *out);
+
+    static QByteArray encode(const TelemetryFrame &frame, quint32 sequence, quint64 senderTimestampUs);
+};
+
+#endif // TELEMETRYWIREFORMAT_H
@@ -1,37 +1,26 @@
 #include "udpclient.h"
+#include "allocationcounter.h"
 #include "udpreceiverworker.h"
-#include "udpparserworker.h"
 #include <QDebug>
 #include <QThread>
+#include <QtGlobal>
 
 /*UdpClient
  * The central class managing the overall UDP client.
- * It configures workers, maintains application-wide configuration (debug mode, thread count, performance counters, atomic property storage),
+ * It configures workers, maintains application-wide configuration (debug mode, thread count, performance counters),
  * and exposes a public API (start/stop, property signals) for external use or QML integration.
  */
 
 UdpClient::UdpClient(QObject *parent)
-    : QObject(parent),
-      m_nextParserIndex(0),
-      m_parserThreadCount(QThread::idealThreadCount()),
+    : TelemetrySource(parent),
       m_debugMode(true),
-      m_datagramsProcessed(0),
-      m_datagramsDropped(0),
-      m_speed(0.0f),
-      m_rpm(0),
-      m_accPedal(0),
-      m_brakePedal(0),
-      m_encoderAngle(0.0),
-      m_temperature(0.0f),
-      m_batteryLevel(0),
-      m_gpsLongitude(0.0),
-      m_gpsLatitude(0.0),
-      m_speedFL(0),
-      m_speedFR(0),
-      m_speedBL(0),
-      m_speedBR(0),
-      m_lateralG(0.0),
-      m_longitudinalG(0.0)
+      m_directDispatch(true),
+      m_receiveRate(0.0),
+      m_averageBatchSize(0.0),
+      m_maxBatchSize(0),
+      m_datagramsReceived(0),
+      m_datagramsTruncated(0),
+      m_receiveAllocations(0)
 {
     // Create and configure the receiver worker
     m_receiverWorker = new UdpReceiverWorker();
@@ -42,14 +31,21 @@ UdpClient::UdpClient(QObject *parent)
     connect(this, &UdpClient::stopReceiving, m_receiverWorker, &UdpReceiverWorker::stopReceiving, Qt::QueuedConnection);
     connect(m_receiverWorker, &UdpReceiverWorker::datagramReceived, this, &UdpClient::handleDatagramReceived, Qt::QueuedConnection);
     connect(m_receiverWorker, &UdpReceiverWorker::errorOccurred, this, &UdpClient::handleError, Qt::QueuedConnection);
+    connect(m_receiverWorker, &UdpReceiverWorker::statisticsUpdated, this, &UdpClient::handleReceiverStatistics, Qt::QueuedConnection);
+    connect(&parserStage(), &ParserStage::errorOccurred, this, &UdpClient::handleError, Qt::QueuedConnection);
+    parserStage().setDebugMode(m_debugMode);
+
+    // Pick the initial receive backend, e.g. CAR_DASHBOARD_UDP_BACKEND=recvmmsg
+    const QString backend = qEnvironmentVariable("CAR_DASHBOARD_UDP_BACKEND");
+    if (!backend.isEmpty() && !setReceiveBackend(backend))
+    {
+        qWarning() << "Unsupported UDP receive backend" << backend << "- using" << receiveBackend();
+    }
 
     // Connect thread start/stop signals
     connect(&m_receiverThread, &QThread::started, m_receiverWorker, &UdpReceiverWorker::initialize);
     connect(&m_receiverThread, &QThread::finished, m_receiverWorker, &QObject::deleteLater);
 
-    // Configure the parser thread pool
-    m_parserPool.setMaxThreadCount(m_parserThreadCount);
-
     // Set thread priority
     m_receiverThread.setPriority(QThread::HighPriority);
 }
@@ -79,6 +75,8 @@ bool UdpClient::start(quint16 port)
 
     // Initialize parser threads
     initializeParsers();
+    resetSession();
+    m_receiveAllocations = 0;
 
     // Start the receiver thread
     m_receiverThread.start();
@@ -89,7 +87,7 @@ bool UdpClient::start(quint16 port)
     if (m_debugMode)
     {
         qDebug() << "UDP Client started on port" << port << "running on the " << QThread::currentThread()
-                 << "with" << m_parserThreadCount << "parser threads";
+                 << "with" << parserStage().threadCount() << "parser threads";
     }
 
     return true;
@@ -103,6 +101,9 @@ bool UdpClient::stop()
     // Clean up parser threads
     cleanupParsers();
 
+    // The receiver is detached, so the log is complete
+    stopRecording();
+
     if (m_debugMode)
     {
         qDebug() << "UDP Client stopped";
@@ -115,10 +116,8 @@ void UdpClient::setParserThreadCount(int count)
 {
     if (count > 0 && count <= QThread::idealThreadCount() * 2)
     {
-        m_parserThreadCount = count;
-
-        // Update thread pool configuration
-        m_parserPool.setMaxThreadCount(m_parserThreadCount);
+        // Pins the parser pool to this size; takes effect on the next start()
+        setParserThreadBounds(count, count);
 
         if (m_debugMode)
         {
@@ -127,160 +126,86 @@ void UdpClient::setParserThreadCount(int count)
     }
 }
 
-void UdpClient::setDebugMode(bool enabled)
+void UdpClient::setDirectDispatch(bool enabled)
 {
-    m_debugMode = enabled;
-
-    if (m_debugMode)
+    if (m_directDispatch == enabled)
     {
-        qDebug() << "Debug mode enabled";
+        return;
     }
-}
 
-void UdpClient::handleDatagramReceived(const QByteArray &data)
-{
-    // Distribute datagrams among parsers in a round-robin fashion
-    if (!m_parsers.isEmpty())
-    {
-        // Get the next parser
-        UdpParserWorker *parser = m_parsers[m_nextParserIndex];
-
-        // Queue the datagram for parsing
-        parser->queueDatagram(data);
-
-        // Update the next parser index
-        m_nextParserIndex = (m_nextParserIndex + 1) % m_parsers.size();
-    }
+    m_directDispatch = enabled;
+    emit directDispatchChanged();
 }
 
-void UdpClient::handleParsedData(float speed, int rpm, int accPedal, int brakePedal,
-                                 double encoderAngle, float temperature, int batteryLevel,
-                                 double gpsLongitude, double gpsLatitude,
-                                 int speedFL, int speedFR, int speedBL, int speedBR,
-                                 double lateralG, double longitudinalG)
+void UdpClient::setDebugMode(bool enabled)
 {
-    // Increment processed count
-    m_datagramsProcessed.fetch_add(1);
-
-    // Update speed if changed
-    float oldSpeed = m_speed.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldSpeed, speed))
-    {
-        m_speed.store(speed, std::memory_order_relaxed);
-        emit speedChanged(speed);
-    }
+    m_debugMode = enabled;
+    parserStage().setDebugMode(enabled);
 
-    // Update rpm if changed
-    int oldRpm = m_rpm.load(std::memory_order_relaxed);
-    if (oldRpm != rpm)
+    if (m_debugMode)
     {
-        m_rpm.store(rpm, std::memory_order_relaxed);
-        emit rpmChanged(rpm);
+        qDebug() << "Debug mode enabled";
     }
+}
 
-    // Update accPedal if changed
-    int oldAccPedal = m_accPedal.load(std::memory_order_relaxed);
-    if (oldAccPedal != accPedal)
-    {
-        m_accPedal.store(accPedal, std::memory_order_relaxed);
-        emit accPedalChanged(accPedal);
-    }
+bool UdpClient::setReceiveBackend(const QString &backend)
+{
+    UdpReceiverWorker::ReceiveBackend requested;
 
-    // Update brakePedal if changed
-    int oldBrakePedal = m_brakePedal.load(std::memory_order_relaxed);
-    if (oldBrakePedal != brakePedal)
+    if (backend.compare(QLatin1String("qt"), Qt::CaseInsensitive) == 0)
     {
-        m_brakePedal.store(brakePedal, std::memory_order_relaxed);
-        emit brakePedalChanged(brakePedal);
+        requested = UdpReceiverWorker::QtSocketBackend;
     }
-
-    // Update encoderAngle if changed
-    double oldEncoderAngle = m_encoderAngle.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldEncoderAngle, encoderAngle))
+    else if (backend.compare(QLatin1String("recvmmsg"), Qt::CaseInsensitive) == 0)
     {
-        m_encoderAngle.store(encoderAngle, std::memory_order_relaxed);
-        emit encoderAngleChanged(encoderAngle);
+        requested = UdpReceiverWorker::BatchedBackend;
     }
-
-    // Update temperature if changed
-    float oldTemperature = m_temperature.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldTemperature, temperature))
+    else
     {
-        m_temperature.store(temperature, std::memory_order_relaxed);
-        emit temperatureChanged(temperature);
+        return false;
     }
 
-    // Update batteryLevel if changed
-    int oldBatteryLevel = m_batteryLevel.load(std::memory_order_relaxed);
-    if (oldBatteryLevel != batteryLevel)
-    {
-        m_batteryLevel.store(batteryLevel, std::memory_order_relaxed);
-        emit batteryLevelChanged(batteryLevel);
-    }
+    // The worker only reads the backend when it (re)binds, so setting it from this thread is safe
+    const bool supported = m_receiverWorker->setReceiveBackend(requested) == requested;
+    emit receiveBackendChanged();
 
-    // Update gpsLongitude if changed
-    double oldGpsLongitude = m_gpsLongitude.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldGpsLongitude, gpsLongitude))
-    {
-        m_gpsLongitude.store(gpsLongitude, std::memory_order_relaxed);
-        emit gpsLongitudeChanged(gpsLongitude);
-    }
-
-    // Update gpsLatitude if changed
-    double oldGpsLatitude = m_gpsLatitude.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldGpsLatitude, gpsLatitude))
+    if (m_debugMode)
     {
-        m_gpsLatitude.store(gpsLatitude, std::memory_order_relaxed);
-        emit gpsLatitudeChanged(gpsLatitude);
+        qDebug() << "UDP receive backend set to" << receiveBackend();
     }
 
-    // Update speedFL if changed
-    int oldSpeedFL = m_speedFL.load(std::memory_order_relaxed);
-    if (oldSpeedFL != speedFL)
-    {
-        m_speedFL.store(speedFL, std::memory_order_relaxed);
-        emit speedFLChanged(speedFL);
-    }
+    return supported;
+}
 
-    // Update speedFR if changed
-    int oldSpeedFR = m_speedFR.load(std::memory_order_relaxed);
-    if (oldSpeedFR != speedFR)
-    {
-        m_speedFR.store(speedFR, std::memory_order_relaxed);
-        emit speedFRChanged(speedFR);
-    }
+QString UdpClient::receiveBackend() const
+{
+    return m_receiverWorker->receiveBackend() == UdpReceiverWorker::BatchedBackend
+               ? QStringLiteral("recvmmsg")
+               : QStringLiteral("qt");
+}
 
-    // Update speedBL if changed
-    int oldSpeedBL = m_speedBL.load(std::memory_order_relaxed);
-    if (oldSpeedBL != speedBL)
-    {
-        m_speedBL.store(speedBL, std::memory_order_relaxed);
-        emit speedBLChanged(speedBL);
-    }
+void UdpClient::handleReceiverStatistics(const UdpReceiverStats &stats)
+{
+    m_datagramsReceived += stats.datagrams;
+    m_datagramsTruncated += stats.truncated;
+    m_receiveRate = stats.intervalMs > 0 ? stats.datagrams * 1000.0 / stats.intervalMs : 0.0;
+    m_averageBatchSize = stats.batches > 0 ? double(stats.datagrams) / stats.batches : 0.0;
+    m_maxBatchSize = stats.maxBatchSize;
+    m_receiveAllocations += qint64(stats.allocations);
 
-    // Update speedBR if changed
-    int oldSpeedBR = m_speedBR.load(std::memory_order_relaxed);
-    if (oldSpeedBR != speedBR)
+    if (m_debugMode && AllocationCounter::Enabled)
     {
-        m_speedBR.store(speedBR, std::memory_order_relaxed);
-        emit speedBRChanged(speedBR);
+        qDebug() << "Ingest allocations: receiver" << stats.allocations << "this interval, total"
+                 << ingestAllocations() << "- pooled buffer overflows" << parserStage().bufferOverflows();
     }
 
-    // Update lateralG if changed
-    double oldLateralG = m_lateralG.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldLateralG, lateralG))
-    {
-        m_lateralG.store(lateralG, std::memory_order_relaxed);
-        emit lateralGChanged(lateralG);
-    }
+    emit receiverStatisticsChanged();
+}
 
-    // Update longitudinalG if changed
-    double oldLongitudinalG = m_longitudinalG.load(std::memory_order_relaxed);
-    if (!qFuzzyCompare(oldLongitudinalG, longitudinalG))
-    {
-        m_longitudinalG.store(longitudinalG, std::memory_order_relaxed);
-        emit longitudinalGChanged(longitudinalG);
-    }
+void UdpClient::handleDatagramReceived(const QByteArray &data)
+{
+    // The stage stamps the arrival order and picks the parser; full queues are counted there
+    parserStage().dispatch(data);
 }
 
 void UdpClient::handleError(const QString &error)
@@ -295,49 +220,34 @@ void UdpClient::handleError(const QString &error)
 
 void UdpClient::initializeParsers()
 {
-    // Create parser instances
-    for (int i = 0; i < m_parserThreadCount; ++i)
-    {
-        UdpParserWorker *parser = new UdpParserWorker(m_debugMode);
-
-        // Connect signals for results
-        connect(parser, &UdpParserWorker::datagramParsed, this, &UdpClient::handleParsedData, Qt::QueuedConnection);
-        connect(parser, &UdpParserWorker::errorOccurred, this, &UdpClient::handleError, Qt::QueuedConnection);
-
-        // Add to list
-        m_parsers.append(parser);
+    parserStage().start();
 
-        // Start the parser in the thread pool
-        m_parserPool.start(parser);
-
-        // if (m_debugMode) {
-        //     qDebug() << "Started parser" << i;
-        // }
+    // Let the receiver thread publish batches straight into the parser inboxes
+    if (m_directDispatch)
+    {
+        attachStageToReceiver(&parserStage());
     }
-
-    // Reset the next parser index
-    m_nextParserIndex = 0;
 }
 
-void UdpClient::cleanupParsers()
+void UdpClient::attachStageToReceiver(ParserStage *stage)
 {
-    // Stop all parsers
-    for (UdpParserWorker *parser : m_parsers)
+    UdpReceiverWorker *worker = m_receiverWorker;
+
+    if (m_receiverThread.isRunning())
     {
-        parser->stop();
+        // Blocking, so that after a detach the receiver can no longer touch parsers we are about to delete
+        QMetaObject::invokeMethod(worker, [worker, stage]() { worker->setParserStage(stage); }, Qt::BlockingQueuedConnection);
     }
-
-    // Wait for all tasks to complete
-    m_parserPool.waitForDone();
-
-    // Disconnect all signals
-    for (UdpParserWorker *parser : m_parsers)
+    else
     {
-        disconnect(parser, &UdpParserWorker::datagramParsed, this, &UdpClient::handleParsedData);
-        disconnect(parser, &UdpParserWorker::errorOccurred, this, &UdpClient::handleError);
+        worker->setParserStage(stage);
     }
+}
+
+void UdpClient::cleanupParsers()
+{
+    // Detach the parsers from the receiver thread before they go away
+    attachStageToReceiver(nullptr);
 
-    // Delete all parsers
-    qDeleteAll(m_parsers);
-    m_parsers.clear();
+    parserStage().stop();
 }
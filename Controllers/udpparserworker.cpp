@@ -1,29 +1,67 @@
 #include "udpparserworker.h"
+#include "allocationcounter.h"
+#include "telemetrycsvparser.h"
+#include "telemetryframepool.h"
+#include "telemetrywireformat.h"
 #include <QDebug>
-#include <QStringList>
 #include <QThread>
+#include <chrono>
+#include <cstring>
 
 /*A worker class responsible for parsing raw datagram data. It is designed to run in a thread pool,
- *  using a thread-safe queue (internally) to receive datagrams, parse them into numeric values,
- *   and then emit a signal with the parsed values or an error if parsing fails.
+ *  using a lock-free queue (internally) to receive datagrams, parse them into numeric values,
+ *   and then emit a signal with the parsed values, or count the failure by reason if parsing fails.
+ *  Each packet is routed by its first byte to the binary wire-format decoder or the CSV decoder.
+ *  An idle worker in a steal group pops from its siblings' queues, which are multi-consumer already.
+ *  Payloads arrive in pooled DatagramBuffers and go back to the pool once parsed or dropped.
  */
 
-UdpParserWorker::UdpParserWorker(bool debugMode, QObject *parent)
+UdpParserWorker::UdpParserWorker(TelemetryFramePool *framePool, DatagramBufferPool *bufferPool, bool debugMode,
+                                 int queueCapacity, QObject *parent)
     : QObject(parent),
+      m_framePool(framePool),
+      m_bufferPool(bufferPool),
       m_debugMode(debugMode),
       m_running(true),
-      m_datagramsParsed(0)
+      m_latestOnly(false),
+      m_retiring(false),
+      m_scheduled(false),
+      m_busyNanoseconds(0),
+      m_datagramsHandled(0),
+      m_overflowPolicy(DropNewest),
+      m_datagramsDropped(0),
+      m_datagramsParsed(0),
+      m_datagramsStolen(0),
+      m_ingestAllocations(0),
+      m_debugLogAllocations(0),
+      m_sampleReady(false),
+      m_sampleReason(BadValue),
+      m_sampleSize(0),
+      m_sampleLength(0),
+      m_queue(size_t(qMax(1, queueCapacity))),
+      m_wakeups(&m_queueEvents),
+      m_group(nullptr),
+      m_groupIndex(0),
+      m_nextVictim(0)
 {
     setAutoDelete(false);
+
+    for (std::atomic<quint64> &count : m_parseErrors)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
 }
 
 UdpParserWorker::~UdpParserWorker()
 {
     stop();
 
-    // Clear the queue
-    QMutexLocker locker(&m_queueMutex);
-    m_queue.clear();
+    // Whatever is still queued goes back to the pool
+    QueuedDatagram leftover;
+    while (m_queue.tryPop(leftover))
+    {
+        m_bufferPool->release(leftover.buffer);
+    }
 }
 
 void UdpParserWorker::run()
@@ -33,70 +71,265 @@ void UdpParserWorker::run()
         qDebug() << "Parser worker started in thread" << QThread::currentThreadId();
     }
 
-    QByteArray datagram;
+    QueuedDatagram datagram;
+    quint32 skipped = 0;
 
     while (m_running.load())
     { // The flag is accessed using load() to ensure that changes made to it in other threads are observed safely.
-        // Get a datagram from the queue
+        // Get a datagram from our lock-free queue, or from a sibling's
+        const quint64 allocationsBefore = AllocationCounter::threadAllocations();
+        if (takeWork(datagram, skipped))
         {
-            QMutexLocker locker(&m_queueMutex); // Acquires m_queueMutex to protect concurrent access to the internal datagram queue (m_queue).
+            // Parse the datagram, timing it for the autoscaler
+            const auto parseStart = std::chrono::steady_clock::now();
+            m_debugLogAllocations = 0;
+            parseDatagram(datagram, skipped);
+            m_bufferPool->release(datagram.buffer);
+            datagram.buffer = nullptr;
+            const auto parseTime = std::chrono::steady_clock::now() - parseStart;
 
-            // Wait for data if queue is empty
-            while (m_queue.isEmpty() && m_running.load())
+            if (AllocationCounter::Enabled)
             {
-                // checks if the queue is empty. If it is, it waits (up to 100 milliseconds) for new data to arrive.
-                m_queueCondition.wait(&m_queueMutex, 100);
+                m_ingestAllocations.fetch_add(AllocationCounter::threadAllocations() - allocationsBefore - m_debugLogAllocations,
+                                              std::memory_order_relaxed);
+            }
 
-                /* If another thread enqueues data during the waiting period,
-                the waiting thread will observe the new state after the wait and process the queued data accordingly.*/
+            m_busyNanoseconds.fetch_add(quint64(std::chrono::duration_cast<std::chrono::nanoseconds>(parseTime).count()),
+                                        std::memory_order_relaxed);
+            m_datagramsHandled.fetch_add(1 + skipped, std::memory_order_relaxed);
+            continue;
+        }
 
-                /* If Thread B is still working and holding the mutex when the timeout in Thread A expires,
-                 *  Thread A will be blocked at the point of re-locking until Thread B unlocks the mutex.
-                 *  Once Thread B finishes and unlocks, Thread A will acquire the lock.
-                 */
+        // Retired and drained: hand the pool thread back instead of sleeping on it
+        if (m_retiring.load())
+        {
+            break;
+        }
 
-                /*After reacquiring the lock, Thread A resumes execution and checks the condition (e.g., whether there is data in the queue).
-                 *  Any modifications made by Thread B while Thread A was waiting will be visible
-                 *  because the mutex ensures that shared memory access is serialized and consistent.
-                 */
-            }
+        /* The queues looked empty: announce that we are about to sleep, then check again.
+         * A producer that pushes after our check sees us as a waiter and bumps the epoch,
+         * so commitWait() either returns immediately or is woken by it. No periodic
+         * time-out is needed because stop() also notifies.
+         */
+        const quint32 key = m_wakeups->prepareWait();
+        if (hasWork() || !m_running.load() || m_retiring.load())
+        {
+            m_wakeups->cancelWait();
+        }
+        else
+        {
+            m_wakeups->commitWait(key);
+        }
+    }
 
-            // Check if we should exit
-            if (!m_running.load())
-            {
-                break;
-            }
+    if (m_debugMode)
+    {
+        qDebug() << "Parser worker stopped in thread" << QThread::currentThreadId();
+    }
+
+    m_scheduled.store(false);
+
+    // An activate() that raced with retiring found us still scheduled and did not restart us
+    if (m_running.load() && !m_retiring.load() && !m_scheduled.exchange(true))
+    {
+        run();
+    }
+}
+
+bool UdpParserWorker::startOn(QThreadPool &pool)
+{
+    if (m_scheduled.exchange(true))
+    {
+        return false;
+    }
+
+    pool.start(this);
+    return true;
+}
+
+void UdpParserWorker::retire()
+{
+    m_retiring.store(true);
+
+    // A sleeping worker has to wake up to notice
+    m_wakeups->notifyAll();
+}
+
+void UdpParserWorker::activate()
+{
+    m_retiring.store(false);
+}
+
+void UdpParserWorker::joinStealGroup(const QList<UdpParserWorker *> *group, EventCount *wakeups)
+{
+    m_group = group;
+    m_groupIndex = group ? int(group->indexOf(this)) : 0;
+    m_nextVictim = m_groupIndex + 1;
+    m_wakeups = wakeups ? wakeups : &m_queueEvents;
+}
+
+bool UdpParserWorker::takeWork(QueuedDatagram &datagram, quint32 &skipped)
+{
+    if (popFrom(m_queue, datagram, skipped))
+    {
+        return true;
+    }
+
+    // A retiring worker only drains its own queue; its siblings keep theirs
+    if (!m_group || m_retiring.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
+
+    // Visit the siblings round-robin from where the last steal left off, so thieves spread out
+    const int count = int(m_group->size());
+    for (int attempt = 0; attempt < count; ++attempt)
+    {
+        const int index = (m_nextVictim + attempt) % count;
+        if (index == m_groupIndex)
+        {
+            continue;
+        }
+
+        if (popFrom(m_group->at(index)->m_queue, datagram, skipped))
+        {
+            m_nextVictim = index;
+            m_datagramsStolen.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UdpParserWorker::popFrom(BoundedMpmcQueue<QueuedDatagram> &queue, QueuedDatagram &datagram, quint32 &skipped)
+{
+    if (!queue.tryPop(datagram))
+    {
+        return false;
+    }
+
+    // Behind in latest-only mode: anything still queued makes this datagram stale
+    skipped = 0;
+    if (m_latestOnly.load(std::memory_order_relaxed))
+    {
+        QueuedDatagram newer;
+        while (queue.tryPop(newer))
+        {
+            m_bufferPool->release(datagram.buffer);
+            datagram = newer;
+            skipped++;
+        }
+    }
+    return true;
+}
+
+bool UdpParserWorker::hasWork() const
+{
+    if (!m_queue.isEmpty())
+    {
+        return true;
+    }
+    if (!m_group || m_retiring.load(std::memory_order_relaxed))
+    {
+        return false;
+    }
 
-            // Get the next datagram
-            if (!m_queue.isEmpty())
+    for (const UdpParserWorker *sibling : *m_group)
+    {
+        if (!sibling->m_queue.isEmpty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool UdpParserWorker::queueDatagram(const QByteArray &data, quint64 arrival)
+{
+    if (!enqueue(QueuedDatagram{m_bufferPool->acquireCopy(data.constData(), int(data.size())), arrival}))
+    {
+        return false;
+    }
+
+    // Wake up the worker thread, or an idle sibling that will steal the datagram
+    m_wakeups->notifyOne();
+    return true;
+}
+
+int UdpParserWorker::publishBatch(QueuedDatagram *datagrams, int count)
+{
+    int accepted = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        if (enqueue(std::move(datagrams[i])))
+        {
+            accepted++;
+        }
+    }
+
+    // One wake-up per batch
+    if (accepted > 0)
+    {
+        m_wakeups->notifyOne();
+    }
+
+    return accepted;
+}
+
+bool UdpParserWorker::enqueue(QueuedDatagram &&datagram)
+{
+    if (m_queue.tryPush(std::move(datagram)))
+    {
+        return true;
+    }
+
+    switch (m_overflowPolicy.load(std::memory_order_relaxed))
+    {
+    case DropOldest:
+        // Make room by discarding from the head; the parser may be popping concurrently, so retry
+        while (!m_queue.tryPush(std::move(datagram)))
+        {
+            QueuedDatagram stale;
+            if (m_queue.tryPop(stale))
             {
-                datagram = m_queue.dequeue();
+                m_bufferPool->release(stale.buffer);
+                m_datagramsDropped.fetch_add(1, std::memory_order_relaxed);
             }
-            else
+        }
+        return true;
+
+    case BlockProducer:
+        // Wait for the parser to make room; the caller's thread stalls and the socket buffer absorbs the burst
+        while (!m_queue.tryPush(std::move(datagram)))
+        {
+            if (!m_running.load())
             {
-                continue;
+                m_bufferPool->release(datagram.buffer);
+                m_datagramsDropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
             }
+            m_wakeups->notifyOne();
+            QThread::yieldCurrentThread();
         }
+        return true;
 
-        // Parse the datagram
-        parseDatagram(datagram);
+    case DropNewest:
+        break;
     }
 
-    if (m_debugMode)
-    {
-        qDebug() << "Parser worker stopped in thread" << QThread::currentThreadId();
-    }
+    m_bufferPool->release(datagram.buffer);
+    m_datagramsDropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
 }
 
-void UdpParserWorker::queueDatagram(const QByteArray &data)
+void UdpParserWorker::setLatestOnly(bool enabled)
 {
-    QMutexLocker locker(&m_queueMutex);
-
-    // Add datagram to queue
-    m_queue.enqueue(data);
+    m_latestOnly.store(enabled, std::memory_order_relaxed);
+}
 
-    // Wake up the worker thread
-    m_queueCondition.wakeOne();
+void UdpParserWorker::setOverflowPolicy(OverflowPolicy policy)
+{
+    m_overflowPolicy.store(policy, std::memory_order_relaxed);
 }
 
 void UdpParserWorker::stop()
@@ -104,85 +337,126 @@ void UdpParserWorker::stop()
     m_running.store(false);
 
     // Wake up the worker thread
-    QMutexLocker locker(&m_queueMutex);
-    m_queueCondition.wakeAll(); // wake up any thread that might be blocked waiting on the condition variable
+    m_wakeups->notifyAll();
 }
 
-void UdpParserWorker::parseDatagram(const QByteArray &data)
+void UdpParserWorker::parseDatagram(const QueuedDatagram &datagram, quint32 skipped)
 {
+    const char *data = datagram.buffer->data;
+    const int size = datagram.buffer->size;
+
+    // Recycled frame; goes back to the pool on every path that does not emit it
+    TelemetryFrame *frame = m_framePool->acquire();
+    bool handedOver = false;
+
     try
     {
-        // Convert datagram data to string and split by comma
-        QString dataStr = QString::fromUtf8(data).trimmed();
-        QStringList parts = dataStr.split(",");
-
-        // Check if we have enough parts (now 15 parts with lateral and longitudinal G)
-        if (parts.size() >= 15)
+        // The first byte tells the binary wire format apart from CSV
+        if (TelemetryWireFormat::isBinary(data, size))
         {
-            bool okSpeed = false, okRpm = false, okAcc = false, okBrake = false;
-            bool okAngle = false, okTemp = false, okBattery = false;
-            bool okGpsLon = false, okGpsLat = false;
-            bool okWSFL = false, okWSFR = false, okWSBL = false, okWSBR = false;
-            bool okLateralG = false, okLongitudinalG = false;
-
-            // Parse values
-            float speed = parts[0].toFloat(&okSpeed);
-            int rpm = parts[1].toInt(&okRpm);
-            int accPedal = parts[2].toInt(&okAcc);
-            int brakePedal = parts[3].toInt(&okBrake);
-            double encoderAngle = parts[4].toDouble(&okAngle);
-            float temperature = parts[5].toFloat(&okTemp);
-            int batteryLevel = parts[6].toInt(&okBattery);
-            double gpsLongitude = parts[7].toDouble(&okGpsLon);
-            double gpsLatitude = parts[8].toDouble(&okGpsLat);
-            int speedFL = parts[9].toInt(&okWSFL);
-            int speedFR = parts[10].toInt(&okWSFR);
-            int speedBL = parts[11].toInt(&okWSBL);
-            int speedBR = parts[12].toInt(&okWSBR);
-            double lateralG = parts[13].toDouble(&okLateralG);
-            double longitudinalG = parts[14].toDouble(&okLongitudinalG);
-
-            // Check if all values were parsed successfully
-            if (okSpeed && okRpm && okAcc && okBrake && okAngle && okTemp &&
-                okBattery && okGpsLon && okGpsLat &&
-                okWSFL && okWSFR && okWSBL && okWSBR &&
-                okLateralG && okLongitudinalG)
-            {
+            const TelemetryWireFormat::Status status = TelemetryWireFormat::decode(data, size, *frame);
 
-                // Increment counter
-                m_datagramsParsed++;
-
-                // Emit signal with parsed data
-                emit datagramParsed(
-                    speed, rpm, accPedal, brakePedal,
-                    encoderAngle, temperature, batteryLevel,
-                    gpsLongitude, gpsLatitude,
-                    speedFL, speedFR, speedBL, speedBR,
-                    lateralG, longitudinalG);
-
-                // Log debug info occasionally
-                if (m_debugMode && m_datagramsParsed % 1000 == 0)
-                {
-                    qDebug() << "Parser" << QThread::currentThreadId()
-                             << "has processed" << m_datagramsParsed << "datagrams";
-                }
+            if (status == TelemetryWireFormat::TooShort)
+            {
+                m_framePool->release(frame);
+                recordError(BinaryTooShort, data, size);
+                return;
             }
-            else
+            if (status == TelemetryWireFormat::UnsupportedVersion)
             {
-                emit errorOccurred("Failed to parse some values in datagram");
+                m_framePool->release(frame);
+                recordError(UnsupportedVersion, data, size);
+                return;
             }
         }
         else
         {
-            emit errorOccurred(QString("Datagram has incorrect format (expected 15+ parts, got %1)").arg(parts.size()));
+            // Walk the raw bytes once; no QString conversion and no per-field allocations
+            const TelemetryCsvParser::Result result = TelemetryCsvParser::parse(data, data + size, *frame);
+
+            // Check if we have enough parts (15 parts with lateral and longitudinal G)
+            if (result.status == TelemetryCsvParser::WrongFieldCount)
+            {
+                m_framePool->release(frame);
+                recordError(WrongFieldCount, data, size);
+                return;
+            }
+            if (result.status == TelemetryCsvParser::BadValue)
+            {
+                m_framePool->release(frame);
+                recordError(BadValue, data, size);
+                return;
+            }
+        }
+
+        frame->hostTimestampUs = monotonicMicroseconds();
+        frame->arrival = datagram.arrival;
+        frame->skippedBefore = skipped;
+
+        // Increment counter
+        m_datagramsParsed++;
+
+        // Hand the whole frame over in one shot; ownership passes to the receiving slot. The
+        // receiver accepts it on this thread, so its work counts as ingest like the parse itself.
+        handedOver = true;
+        emit frameParsed(frame);
+
+        // Log debug info occasionally; the log line is the only part left out of the ingest count
+        if (m_debugMode && m_datagramsParsed % 1000 == 0)
+        {
+            const quint64 logStart = AllocationCounter::threadAllocations();
+            qDebug() << "Parser" << QThread::currentThreadId()
+                     << "has processed" << m_datagramsParsed << "datagrams";
+            m_debugLogAllocations = AllocationCounter::threadAllocations() - logStart;
         }
     }
-    catch (const std::exception &e)
+    catch (...)
     {
-        emit errorOccurred(QString("Exception during parsing: %1").arg(e.what()));
+        if (!handedOver)
+        {
+            m_framePool->release(frame);
+        }
+        recordError(ParserException, data, size);
     }
-    catch (...)
+}
+
+void UdpParserWorker::recordError(ParseError reason, const char *data, int size)
+{
+    // Counting is all a rejected datagram costs; the stage summarizes the counters periodically
+    m_parseErrors[reason].fetch_add(1, std::memory_order_relaxed);
+
+    // The sample slot is ours while it is not marked ready
+    if (m_sampleReady.load(std::memory_order_acquire))
     {
-        emit errorOccurred("Unknown exception during parsing");
+        return;
     }
+
+    m_sampleReason = reason;
+    m_sampleSize = size;
+    m_sampleLength = qMin(size, int(ErrorSampleSize));
+    std::memcpy(m_sampleData, data, size_t(m_sampleLength));
+    m_sampleReady.store(true, std::memory_order_release);
+}
+
+bool UdpParserWorker::takeErrorSample(ErrorSample &sample)
+{
+    if (!m_sampleReady.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    sample.reason = m_sampleReason;
+    sample.size = m_sampleSize;
+    sample.payload = QByteArray(m_sampleData, m_sampleLength);
+
+    // Hand the slot back to the parser
+    m_sampleReady.store(false, std::memory_order_release);
+    return true;
+}
+
+qint64 UdpParserWorker::monotonicMicroseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
 }
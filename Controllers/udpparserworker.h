@@ -4,23 +4,89 @@
 #include <QObject>
 #include <QRunnable>
 #include <QByteArray>
-#include <QMutex>
-#include <QQueue>
-#include <QWaitCondition>
+#include <QList>
+#include <QThreadPool>
 #include <atomic>
+#include "datagrambufferpool.h"
+#include "eventcount.h"
+#include "mpmcqueue.h"
+#include "telemetryframe.h"
+
+class TelemetryFramePool;
+
+/**
+ * @brief A raw datagram waiting in a parser queue, stamped with its dispatch order
+ *
+ * The payload lives in a buffer of the stage's DatagramBufferPool; whoever consumes or drops
+ * the datagram releases it.
+ */
+struct QueuedDatagram
+{
+    DatagramBuffer *buffer = nullptr;
+    quint64 arrival = 0; // Increases with every datagram dispatched by the client; 0 if unknown
+};
 
 /**
  * @brief The UdpParserWorker class parses UDP datagrams in a thread pool
  *
  * This class is designed to run in a thread pool and efficiently parse UDP datagrams
  * without blocking the main thread or the receiver thread.
+ *
+ * Workers that share a steal group take datagrams from their siblings' queues when their
+ * own is empty, so one parser stuck on a slow datagram or descheduled by the OS does not
+ * hold back the frames queued behind it while the others sit idle.
  */
 class UdpParserWorker : public QObject, public QRunnable
 {
     Q_OBJECT
 
 public:
-    explicit UdpParserWorker(bool debugMode = false, QObject *parent = nullptr);
+    /**
+     * @brief What happens to a datagram that arrives while the queue is full
+     */
+    enum OverflowPolicy
+    {
+        DropNewest,   // Reject the incoming datagram
+        DropOldest,   // Discard the oldest queued datagram to make room
+        BlockProducer // Make the dispatching thread wait until the parser catches up
+    };
+    Q_ENUM(OverflowPolicy)
+
+    /**
+     * @brief Why a datagram could not be parsed
+     */
+    enum ParseError
+    {
+        BinaryTooShort,     // Binary frame shorter than TelemetryWireFormat::FrameSize
+        UnsupportedVersion, // Binary frame of an unknown wire-format version
+        WrongFieldCount,    // CSV line with too few fields
+        BadValue,           // CSV field that is not a number
+        ParserException,    // The decoder threw
+        ParseErrorCount
+    };
+    Q_ENUM(ParseError)
+
+    /**
+     * @brief One rejected datagram, kept for diagnosis
+     */
+    struct ErrorSample
+    {
+        ParseError reason = BadValue;
+        int size = 0;       // Size of the whole datagram
+        QByteArray payload; // At most ErrorSampleSize leading bytes
+    };
+
+    static constexpr int DefaultQueueCapacity = 8192;
+    static constexpr int ErrorSampleSize = 128;
+
+    /**
+     * @param framePool Pool the parsed frames are taken from; must outlive the worker
+     * @param bufferPool Pool the queued payloads come from and are returned to; must outlive the worker
+     * @param debugMode Whether to log progress
+     * @param queueCapacity Maximum number of queued datagrams (rounded up to a power of two)
+     */
+    explicit UdpParserWorker(TelemetryFramePool *framePool, DatagramBufferPool *bufferPool, bool debugMode = false,
+                             int queueCapacity = DefaultQueueCapacity, QObject *parent = nullptr);
     ~UdpParserWorker();
 
     /**
@@ -29,12 +95,97 @@ public:
      */
     void run() override;
 
+    /**
+     * @brief Start run() on @p pool unless it is already scheduled or running
+     * @return True if the worker was started
+     */
+    bool startOn(QThreadPool &pool);
+
+    /**
+     * @brief Let run() return once the queue is empty instead of sleeping, freeing the pool thread
+     *
+     * A retired worker parses what is already queued; activate() undoes it before the next startOn().
+     */
+    void retire();
+    void activate();
+
+    /**
+     * @brief Let this worker steal from the other workers in @p group when its own queue is empty
+     *
+     * All workers of a group sleep on the shared @p wakeups, so a datagram queued for a busy
+     * worker wakes an idle one. Call before startOn(); @p group and @p wakeups must outlive
+     * every run() of the worker.
+     */
+    void joinStealGroup(const QList<UdpParserWorker *> *group, EventCount *wakeups);
+
+    /**
+     * @brief Datagrams rejected for @p reason. Safe to call from any thread.
+     */
+    quint64 parseErrors(ParseError reason) const { return m_parseErrors[reason].load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Move out the sample of a rejected datagram, if one was captured since the last call
+     *
+     * The worker captures a new sample only after the previous one was taken, so this is the
+     * oldest unseen rejection. Call from one thread at a time.
+     */
+    bool takeErrorSample(ErrorSample &sample);
+
+    /**
+     * @brief Datagrams this worker took from a sibling's queue
+     */
+    quint64 datagramsStolen() const { return m_datagramsStolen.load(std::memory_order_relaxed); }
+
+    // Load figures for the parser stage's autoscaler; safe to read from any thread
+    quint64 busyNanoseconds() const { return m_busyNanoseconds.load(std::memory_order_relaxed); }
+    quint64 datagramsHandled() const { return m_datagramsHandled.load(std::memory_order_relaxed); }
+    int queueDepth() const { return int(m_queue.sizeApprox()); }
+
+    /**
+     * @brief Heap allocations made while taking, decoding and accepting datagrams, excluding debug logging
+     *
+     * Only counted in builds with CAR_DASHBOARD_COUNT_ALLOCATIONS; see AllocationCounter.
+     */
+    quint64 ingestAllocations() const { return m_ingestAllocations.load(std::memory_order_relaxed); }
+
 public slots:
     /**
-     * @brief Queue a datagram for parsing
-     * @param data The datagram data to parse
+     * @brief Queue a copy of a datagram for parsing. Safe to call from any thread.
+     * @param data The datagram data to parse; copied into a pooled buffer
+     * @param arrival Dispatch order of the datagram, copied to the parsed frame
+     * @return False if the datagram was dropped under the DropNewest policy
+     */
+    bool queueDatagram(const QByteArray &data, quint64 arrival = 0);
+
+    /**
+     * @brief Hand a batch of datagrams to this parser. Safe to call from any thread.
+     *
+     * The datagrams are moved into the lock-free queue and the parser is woken at most
+     * once per batch. A full queue is handled according to the overflow policy.
+     * @param datagrams The datagrams to parse; the worker takes over every buffer and releases dropped ones
+     * @param count Number of datagrams in the batch
+     * @return Number of datagrams accepted
+     */
+    int publishBatch(QueuedDatagram *datagrams, int count);
+
+    /**
+     * @brief In latest-only mode a parser that falls behind parses only the newest queued datagram
+     *
+     * The skipped datagrams are reported through TelemetryFrame::skippedBefore. Safe to call from any thread.
      */
-    void queueDatagram(const QByteArray &data);
+    void setLatestOnly(bool enabled);
+
+    /**
+     * @brief Select how a full queue is handled. Safe to call from any thread.
+     */
+    void setOverflowPolicy(OverflowPolicy policy);
+
+    /**
+     * @brief Datagrams discarded because the queue was full, under any policy
+     */
+    quint64 datagramsDropped() const { return m_datagramsDropped.load(std::memory_order_relaxed); }
+
+    int queueCapacity() const { return int(m_queue.capacity()); }
 
     /**
      * @brief Stop the parser worker
@@ -44,34 +195,84 @@ public slots:
 signals:
     /**
      * @brief Signal emitted when a datagram is successfully parsed
+     * @param frame The decoded frame, taken from the pool; the receiving slot must release it
+     *
+     * Rejected datagrams do not emit anything; they are counted by reason, see parseErrors().
      */
-    void datagramParsed(float speed, int rpm, int accPedal, int brakePedal,
-                        double encoderAngle, float temperature, int batteryLevel,
-                        double gpsLongitude, double gpsLatitude,
-                        int speedFL, int speedFR, int speedBL, int speedBR,
-                        double lateralG, double longitudinalG);
-
-    /**
-     * @brief Signal emitted when an error occurs during parsing
-     * @param error The error message
-     */
-    void errorOccurred(const QString &error);
+    void frameParsed(TelemetryFrame *frame);
 
 private:
     /**
      * @brief Parse a single datagram
      * @param data The datagram data to parse
      */
-    void parseDatagram(const QByteArray &data);
+    void parseDatagram(const QueuedDatagram &datagram, quint32 skipped);
+
+    /**
+     * @brief Push one datagram, applying the overflow policy; does not wake the parser
+     *
+     * Takes over the buffer: a dropped datagram's buffer goes straight back to the pool.
+     */
+    bool enqueue(QueuedDatagram &&datagram);
+
+    /**
+     * @brief Pop the next datagram from our own queue, or else steal one from a sibling
+     *
+     * In latest-only mode the queue the datagram came from is drained down to its newest entry.
+     * @param skipped Receives the number of datagrams skipped that way
+     */
+    bool takeWork(QueuedDatagram &datagram, quint32 &skipped);
+
+    /**
+     * @brief Pop from @p queue, applying latest-only draining
+     */
+    bool popFrom(BoundedMpmcQueue<QueuedDatagram> &queue, QueuedDatagram &datagram, quint32 &skipped);
 
+    /**
+     * @brief Whether our queue, or a sibling's one we may steal from, holds work
+     */
+    bool hasWork() const;
+
+    /**
+     * @brief Count a rejected datagram and capture it if the sample slot is free
+     */
+    void recordError(ParseError reason, const char *data, int size);
+
+    static qint64 monotonicMicroseconds();
+
+    TelemetryFramePool *m_framePool;
+    DatagramBufferPool *m_bufferPool;
     bool m_debugMode;
     std::atomic<bool> m_running;
+    std::atomic<bool> m_latestOnly;
+    std::atomic<bool> m_retiring;
+    std::atomic<bool> m_scheduled; // Between startOn() and the end of run()
+    std::atomic<quint64> m_busyNanoseconds;
+    std::atomic<quint64> m_datagramsHandled;
+    std::atomic<OverflowPolicy> m_overflowPolicy;
+    std::atomic<quint64> m_datagramsDropped;
     std::atomic<quint64> m_datagramsParsed;
+    std::atomic<quint64> m_datagramsStolen;
+    std::atomic<quint64> m_ingestAllocations;
+    quint64 m_debugLogAllocations; // Allocations of the last frame's debug log line (parser thread only)
+    std::atomic<quint64> m_parseErrors[ParseErrorCount];
+
+    // Error sample, written by the parser while m_sampleReady is false and read by takeErrorSample() while it is true
+    std::atomic<bool> m_sampleReady;
+    ParseError m_sampleReason;
+    int m_sampleSize;
+    int m_sampleLength;
+    char m_sampleData[ErrorSampleSize];
+
+    // Bounded lock-free queue for datagrams; the parser sleeps on m_wakeups while there is no work
+    BoundedMpmcQueue<QueuedDatagram> m_queue;
+    EventCount m_queueEvents;
+    EventCount *m_wakeups; // m_queueEvents, or the steal group's shared one
 
-    // Thread-safe queue for datagrams
-    QQueue<QByteArray> m_queue;
-    QMutex m_queueMutex;
-    QWaitCondition m_queueCondition;
+    // Steal group; fixed between joinStealGroup() and the end of the stage's session
+    const QList<UdpParserWorker *> *m_group;
+    int m_groupIndex;
+    int m_nextVictim;
 };
 
 #endif // UDPPARSERWORKER_H
@@ -1,4 +1,7 @@
 #include "udpreceiverworker.h"
+#include "allocationcounter.h"
+#include "batchdatagramreader.h"
+#include "parserstage.h"
 #include <QDebug>
 #include <QNetworkDatagram>
 #include <QThread>
@@ -6,13 +9,20 @@
 /*A dedicated worker class that runs in its own thread. It owns the QUdpSocket and listens for incoming datagrams.
  *  When data is available, it processes the datagrams, updates throughput statistics,
  *   and emits signals to pass the raw data to parser workers.
+ *  On Linux the batched backend replaces the QUdpSocket with a recvmmsg() reader that drains
+ *   up to BatchDatagramReader::DefaultBatchSize datagrams per system call.
+ *  When a parser stage is attached with setParserStage(), each drained batch is handed to it directly
+ *   instead of travelling through the GUI thread's event loop, in buffers recycled by the stage's pool.
  */
 
 UdpReceiverWorker::UdpReceiverWorker(QObject *parent)
     : QObject(parent),
+      m_batchReader(nullptr),
+      m_batchNotifier(nullptr),
+      m_backend(QtSocketBackend),
       m_running(false),
-      m_datagramsReceived(0),
-      m_bytesReceived(0)
+      m_parserStage(nullptr),
+      m_bufferPool(nullptr)
 {
     m_socket = new QUdpSocket(this);
 
@@ -24,6 +34,18 @@ UdpReceiverWorker::~UdpReceiverWorker()
 {
     stopReceiving();
     m_socket->deleteLater();
+    delete m_batchReader;
+}
+
+UdpReceiverWorker::ReceiveBackend UdpReceiverWorker::setReceiveBackend(ReceiveBackend backend)
+{
+    if (backend == BatchedBackend && !BatchDatagramReader::isSupported())
+    {
+        backend = QtSocketBackend;
+    }
+
+    m_backend.store(backend);
+    return backend;
 }
 
 void UdpReceiverWorker::initialize()
@@ -34,57 +56,221 @@ void UdpReceiverWorker::initialize()
 void UdpReceiverWorker::startReceiving(quint16 port)
 {
     qDebug() << "UdpReceiver receives on" << QThread::currentThread();
-    // Close socket if it's already open
-    if (m_socket->state() != QAbstractSocket::UnconnectedState)
+    // Close whichever socket is currently open
+    stopReceiving();
+
+    if (m_backend.load() == BatchedBackend)
     {
-        m_socket->close();
-    }
+        if (!m_batchReader)
+        {
+            m_batchReader = new BatchDatagramReader();
+        }
+
+        QString error;
+        if (!m_batchReader->open(port, &error))
+        {
+            emit errorOccurred(QString("Failed to bind UDP socket to port %1: %2").arg(port).arg(error));
+            return;
+        }
 
-    // Bind socket to the specified port
-    if (!m_socket->bind(QHostAddress::Any, port))
+        // The notifier is level-triggered, so a partially drained queue fires again
+        m_batchNotifier = new QSocketNotifier(m_batchReader->socketDescriptor(), QSocketNotifier::Read, this);
+        connect(m_batchNotifier, &QSocketNotifier::activated, this, &UdpReceiverWorker::processPendingBatches);
+    }
+    else
     {
-        emit errorOccurred(QString("Failed to bind UDP socket to port %1: %2")
-                               .arg(port)
-                               .arg(m_socket->errorString()));
-        return;
+        // Bind socket to the specified port
+        if (!m_socket->bind(QHostAddress::Any, port))
+        {
+            emit errorOccurred(QString("Failed to bind UDP socket to port %1: %2")
+                                   .arg(port)
+                                   .arg(m_socket->errorString()));
+            return;
+        }
     }
 
     m_running = true;
-    m_datagramsReceived = 0;
-    m_bytesReceived = 0;
+    m_stats = UdpReceiverStats();
     m_statsTimer.restart();
 }
 
 void UdpReceiverWorker::stopReceiving()
 {
     m_running = false;
-    m_socket->close();
+
+    if (m_socket->state() != QAbstractSocket::UnconnectedState)
+    {
+        m_socket->close();
+    }
+
+    if (m_batchNotifier)
+    {
+        m_batchNotifier->setEnabled(false);
+        delete m_batchNotifier;
+        m_batchNotifier = nullptr;
+    }
+
+    if (m_batchReader)
+    {
+        m_batchReader->close();
+    }
+}
+
+void UdpReceiverWorker::setParserStage(ParserStage *stage)
+{
+    // Nothing may be left pending in the old stage's buffers
+    flushDispatch();
+
+    m_parserStage = stage;
+    m_bufferPool = stage ? stage->bufferPool() : nullptr;
+    m_pending.reserve(BatchDatagramReader::DefaultBatchSize);
+}
+
+void UdpReceiverWorker::dispatch(const char *data, int size)
+{
+    if (!m_parserStage)
+    {
+        emit datagramReceived(QByteArray(data, size));
+        return;
+    }
+
+    m_pending.push_back(m_bufferPool->acquireCopy(data, size));
+}
+
+void UdpReceiverWorker::flushDispatch()
+{
+    if (!m_parserStage || m_pending.empty())
+    {
+        return;
+    }
+
+    // The stage spreads the batch over the parsers and counts anything their queues reject
+    m_parserStage->dispatchBatch(m_pending.data(), int(m_pending.size()));
+    m_pending.clear();
 }
 
 void UdpReceiverWorker::processPendingDatagrams()
 {
+    const quint64 allocationsBefore = AllocationCounter::threadAllocations();
+    int datagrams = 0;
+    int truncated = 0;
+    quint64 bytes = 0;
+
     // Process all pending datagrams
     while (m_socket->hasPendingDatagrams() && m_running)
     {
-        QNetworkDatagram datagram = m_socket->receiveDatagram();
-        QByteArray data = datagram.data();
+        if (!m_parserStage)
+        {
+            // Emit it when no parsers are attached
+            QNetworkDatagram datagram = m_socket->receiveDatagram();
+            QByteArray data = datagram.data();
+
+            datagrams++;
+            bytes += data.size();
+            emit datagramReceived(data);
+            continue;
+        }
+
+        // Read straight into a pooled buffer; like the batched backend, oversized datagrams are truncated
+        DatagramBuffer *buffer = m_bufferPool->acquire();
+        const qint64 pendingSize = m_socket->pendingDatagramSize();
+        const qint64 size = m_socket->readDatagram(buffer->data, buffer->capacity);
+        if (size < 0)
+        {
+            m_bufferPool->release(buffer);
+            break;
+        }
 
-        // Update statistics
-        m_datagramsReceived++;
-        m_bytesReceived += data.size();
+        buffer->size = int(size);
+        datagrams++;
+        bytes += quint64(size);
+        if (pendingSize > size)
+        {
+            truncated++;
+        }
 
-        // Emit signal with datagram data
-        emit datagramReceived(data);
+        m_pending.push_back(buffer);
 
-        // Log statistics every 10 seconds
-        if (m_statsTimer.elapsed() > 10000)
+        // Hand over in batches the size of the batched backend's, so a burst neither outgrows
+        // m_pending's reserve nor drains the buffer pool before the parsers see any of it
+        if (int(m_pending.size()) == BatchDatagramReader::DefaultBatchSize)
         {
-            qDebug() << "UDP Receiver: Received" << m_datagramsReceived
-                     << "datagrams (" << m_bytesReceived << "bytes) in the last"
-                     << m_statsTimer.elapsed() / 1000.0 << "seconds";
-            m_datagramsReceived = 0;
-            m_bytesReceived = 0;
-            m_statsTimer.restart();
+            flushDispatch();
         }
     }
+
+    flushDispatch();
+
+    // One readyRead drain pass counts as a batch for this backend
+    if (datagrams > 0)
+    {
+        recordBatch(datagrams, bytes, truncated);
+    }
+    m_stats.allocations += AllocationCounter::threadAllocations() - allocationsBefore;
+
+    publishStatisticsIfDue();
+}
+
+void UdpReceiverWorker::processPendingBatches()
+{
+    const quint64 allocationsBefore = AllocationCounter::threadAllocations();
+
+    while (m_running)
+    {
+        const int count = m_batchReader->readBatch();
+
+        if (count < 0)
+        {
+            emit errorOccurred(QString("UDP batch receive failed: %1").arg(m_batchReader->errorString()));
+            break;
+        }
+
+        if (count == 0)
+        {
+            break;
+        }
+
+        quint64 bytes = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            const int size = m_batchReader->size(i);
+            bytes += size;
+
+            dispatch(m_batchReader->data(i), size);
+        }
+
+        flushDispatch();
+        recordBatch(count, bytes, m_batchReader->truncatedCount());
+
+        // A short batch means the kernel queue is empty; let the notifier call us again
+        if (count < m_batchReader->batchSize())
+        {
+            break;
+        }
+    }
+
+    m_stats.allocations += AllocationCounter::threadAllocations() - allocationsBefore;
+
+    publishStatisticsIfDue();
+}
+
+void UdpReceiverWorker::recordBatch(int datagrams, quint64 bytes, int truncated)
+{
+    m_stats.datagrams += datagrams;
+    m_stats.bytes += bytes;
+    m_stats.batches++;
+    m_stats.truncated += truncated;
+    m_stats.maxBatchSize = qMax(m_stats.maxBatchSize, datagrams);
+}
+
+void UdpReceiverWorker::publishStatisticsIfDue()
+{
+    if (m_statsTimer.elapsed() < StatsIntervalMs)
+    {
+        return;
+    }
+
+    m_stats.intervalMs = m_statsTimer.restart();
+    emit statisticsUpdated(m_stats);
+    m_stats = UdpReceiverStats();
 }
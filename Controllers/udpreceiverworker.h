@@ -4,7 +4,32 @@
 #include <QObject>
 #include <QUdpSocket>
 #include <QElapsedTimer>
+#include <QSocketNotifier>
 #include <atomic>
+#include <vector>
+
+class BatchDatagramReader;
+class DatagramBufferPool;
+class ParserStage;
+struct DatagramBuffer;
+
+/**
+ * @brief Receive statistics for one reporting interval of the UdpReceiverWorker
+ *
+ * A batch is one recvmmsg() call for the batched backend, or one readyRead drain
+ * pass for the QUdpSocket backend.
+ */
+struct UdpReceiverStats
+{
+    quint64 datagrams = 0;
+    quint64 bytes = 0;
+    quint64 batches = 0;
+    quint64 truncated = 0;
+    int maxBatchSize = 0;
+    quint64 allocations = 0; // Heap allocations while receiving and dispatching; debug builds only
+    qint64 intervalMs = 0;
+};
+Q_DECLARE_METATYPE(UdpReceiverStats)
 
 /**
  * @brief The UdpReceiverWorker class handles UDP datagram reception in a dedicated thread
@@ -17,9 +42,26 @@ class UdpReceiverWorker : public QObject
     Q_OBJECT
 
 public:
+    enum ReceiveBackend
+    {
+        QtSocketBackend, // QUdpSocket::receiveDatagram(), one datagram per call
+        BatchedBackend   // recvmmsg() into preallocated slots (Linux only)
+    };
+    Q_ENUM(ReceiveBackend)
+
+    static constexpr int StatsIntervalMs = 1000;
+
     explicit UdpReceiverWorker(QObject *parent = nullptr);
     ~UdpReceiverWorker();
 
+    /**
+     * @brief Select the receive backend used by the next startReceiving() call
+     * Thread-safe. Falls back to QtSocketBackend where batching is unsupported.
+     * @return The backend that will actually be used
+     */
+    ReceiveBackend setReceiveBackend(ReceiveBackend backend);
+    ReceiveBackend receiveBackend() const { return m_backend.load(); }
+
 public slots:
     /**
      * @brief Initialize the worker
@@ -38,6 +80,17 @@ public slots:
      */
     void stopReceiving();
 
+    /**
+     * @brief Dispatch datagrams straight to this parser stage instead of emitting datagramReceived()
+     *
+     * Each drained batch is handed to the stage in one call and lands in the parsers' lock-free
+     * inboxes, so the GUI thread is not on the per-packet path. Datagrams are read into buffers
+     * of the stage's pool, so this path does not allocate per packet. Pass nullptr to return to
+     * signal-based delivery; the caller must do so before stopping the stage.
+     * @param stage The parser stage to feed
+     */
+    void setParserStage(ParserStage *stage);
+
 signals:
     /**
      * @brief Signal emitted when a datagram is received
@@ -51,6 +104,12 @@ signals:
      */
     void errorOccurred(const QString &error);
 
+    /**
+     * @brief Signal emitted every StatsIntervalMs while datagrams are arriving
+     * @param stats Counters for the interval that just ended
+     */
+    void statisticsUpdated(const UdpReceiverStats &stats);
+
 private slots:
     /**
      * @brief Process pending datagrams
@@ -58,12 +117,30 @@ private slots:
      */
     void processPendingDatagrams();
 
+    /**
+     * @brief Drain the batched socket
+     * Called by the socket notifier when the batched backend is active
+     */
+    void processPendingBatches();
+
 private:
+    void recordBatch(int datagrams, quint64 bytes, int truncated);
+    void publishStatisticsIfDue();
+    void dispatch(const char *data, int size);
+    void flushDispatch();
+
     QUdpSocket *m_socket;
+    BatchDatagramReader *m_batchReader;
+    QSocketNotifier *m_batchNotifier;
+    std::atomic<ReceiveBackend> m_backend;
     std::atomic<bool> m_running;
     QElapsedTimer m_statsTimer;
-    quint64 m_datagramsReceived;
-    quint64 m_bytesReceived;
+    UdpReceiverStats m_stats;
+
+    // Direct dispatch state (receiver thread only)
+    ParserStage *m_parserStage;
+    DatagramBufferPool *m_bufferPool;        // The stage's pool
+    std::vector<DatagramBuffer *> m_pending; // Datagrams of the current batch
 };
 
 #endif // UDPRECEIVERWORKER_H
@@ -1,4 +1,5 @@
 import QtQuick 2.15
+import Car_Dashboard.Telemetry 1.0
 
 Item {
     id : root
@@ -17,62 +18,40 @@ Item {
             width: 90 * root.scaleFactor
             height: 90 * root.scaleFactor
 
-            // Draw gauge dashes and labels
-            Canvas {
-                id: gaugeCanvas
-                anchors.centerIn: parent
-                width: 90 * root.scaleFactor
-                height: 90 * root.scaleFactor
-
-                onPaint: {
-                    var ctx = getContext("2d")
-                    var centerX = width / 2
-                    var centerY = height
-                    var radius = 40 * root.scaleFactor
-
-                    // Clear canvas
-                    ctx.clearRect(0, 0, width, height)
-
-                    // Draw gauge lines
-                    ctx.save()
-                    ctx.translate(centerX, centerY)
-                    ctx.rotate(2 * Math.PI) // Rotate to make it a half-circle
-
-                    // From -90° (left) to 90° (right)
-                    for (var i = -90; i <= 90; i += 10) {
-                        //var angle = (i * Math.PI / 180) // Convert to radians
-                        var angle = (i / 360 * 360 - 90) * Math.PI / 180 // Adjusted for full circle
-                        var isMajor = i % 30 === 0
-                        var lineLength = (isMajor ? 15 : 10) * root.scaleFactor
-                        var startX = radius * Math.cos(angle)
-                        var startY = radius * Math.sin(angle)
-                        var endX = (radius - lineLength) * Math.cos(angle)
-                        var endY = (radius - lineLength) * Math.sin(angle)
-
-                        // Check if dash should be colored turquoise (if needle has passed)
-                        var dashColor = (i < 0) ? ((i > root.eulerAngle) ? "turquoise" : "black") : ((i <= root.eulerAngle) ? "turquoise" : "black")
+            // Half dial from -90° (left) to 90° (right); ticks light up from 0 towards the angle
+            DialGauge {
+                id: dial
+                anchors.fill: parent
+                value: root.eulerAngle
+                minimumValue: -90
+                maximumValue: 90
+                baseline: 0
+                startAngle: -180
+                sweepAngle: 180
+                pivot: Qt.point(width / 2, height)
+                radius: 40 * root.scaleFactor
+                minorTickInterval: 10
+                majorTickInterval: 30
+                minorTickLength: 10 * root.scaleFactor
+                majorTickLength: 15 * root.scaleFactor
+                minorTickWidth: 2 * root.scaleFactor
+                majorTickWidth: 2 * root.scaleFactor
+                inactiveColor: "black"
+                zones: [{ "limit": 90, "color": "turquoise" }]
+            }
 
-                        // Draw the dash
-                        ctx.strokeStyle = dashColor
-                        ctx.lineWidth = 2 * root.scaleFactor
-                        ctx.beginPath()
-                        ctx.moveTo(startX, startY)
-                        ctx.lineTo(endX, endY)
-                        ctx.stroke()
+            // Label for the 0 position
+            Text {
+                readonly property point position: dial.pointAt(0, dial.radius - 15 * root.scaleFactor)
 
-                        // Draw label for 0 position
-                        if (i === 0) {
-                            var labelRadius = radius - 15 * root.scaleFactor
-                            var labelX = labelRadius * Math.cos(angle)
-                            var labelY = labelRadius * Math.sin(angle) + 3
-                            ctx.font = "bold " + 8 * root.scaleFactor + "px " + "DS-Digital"
-                            ctx.fillStyle = "turquoise"
-                            ctx.textAlign = "center"
-                            ctx.textBaseline = "middle"
-                            ctx.fillText(i.toString(), labelX, labelY)
-                        }
-                    }
-                    ctx.restore()
+                x: position.x - width / 2
+                y: position.y + 3 - height / 2
+                text: "0"
+                color: "turquoise"
+                font {
+                    pixelSize: 8 * root.scaleFactor
+                    bold: true
+                    family: "DS-Digital"
                 }
             }
 
@@ -110,7 +89,7 @@ Item {
             topMargin: 10 * root.scaleFactor
         }
     }
+    // The dial follows eulerAngle by itself; kept for callers written for the Canvas gauge
     function rePaint() {
-        gaugeCanvas.requestPaint()
     }
 }
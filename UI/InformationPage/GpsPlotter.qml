@@ -8,40 +8,38 @@ Rectangle {
     width: parent.width - 30
     height: parent.height - 50
 
-    // These properties hold the raw GPS values from udpClient
-    property real gpsLongitude: 0.0
-    property real gpsLatitude: 0.0
-    property real currentLongitude: gpsLongitude
-    property real currentLatitude: gpsLatitude
+    // Client whose GPS track is drawn; its track pairs latitude and longitude per frame
+    property var dataClient: null
+    readonly property var track: dataClient ? dataClient.track : null
+    property real currentLongitude: track ? track.longitude : 0.0
+    property real currentLatitude: track ? track.latitude : 0.0
 
-    // Add a property list to store path coordinates
-    property var pathCoordinates: []
-    property bool firstCoordinateReceived: false
+    function toCoordinate(point) {
+        // Track vertices are (longitude, latitude) points
+        return QtPositioning.coordinate(point.y, point.x);
+    }
 
-    // Add error handling for invalid coordinates
-    function isValidCoordinate(lat, lon) {
-        return !isNaN(lat) && !isNaN(lon) &&
-               lat >= -90 && lat <= 90 &&
-               lon >= -180 && lon <= 180;
+    // Reload the whole path, after a clear or when the track thinned itself
+    function reloadPath() {
+        var coordinates = [];
+        var vertices = track ? track.vertices(0) : [];
+        for (var i = 0; i < vertices.length; ++i)
+            coordinates.push(toCoordinate(vertices[i]));
+        pathLine.path = coordinates;
     }
 
-    // Modified function to update path
-    function updatePath(lat, lon) {
-        var newCoord = QtPositioning.coordinate(lat, lon);
+    // Replace the moved tail and append the new vertices; the rest of the polyline is untouched
+    function extendPath(from) {
+        while (pathLine.pathLength() > from)
+            pathLine.removeCoordinate(pathLine.pathLength() - 1);
 
-        if (!firstCoordinateReceived) {
-            firstCoordinateReceived = true;
-            pathCoordinates = [newCoord];
-        } else {
-            // Create a new array with all existing coordinates plus the new one
-            var newPath = pathCoordinates.slice(); // Create a copy of the existing array
-            newPath.push(newCoord);
-            pathCoordinates = newPath; // Assign the new array to trigger update
-        }
-        // Force update of the polyline
-        pathLine.path = pathCoordinates;
+        var vertices = track.vertices(from);
+        for (var i = 0; i < vertices.length; ++i)
+            pathLine.addCoordinate(toCoordinate(vertices[i]));
     }
 
+    onTrackChanged: reloadPath()
+
     Map {
         id: map
         anchors.fill: parent
@@ -66,7 +64,6 @@ Rectangle {
             id: pathLine
             line.width: 4
             line.color: "blue"
-            path: gpsDisplay.pathCoordinates
         }
 
         MapQuickItem {
@@ -107,9 +104,8 @@ Rectangle {
             width: 50
             height: 20
             onClicked: {
-                gpsDisplay.pathCoordinates = [];
-                gpsDisplay.firstCoordinateReceived = false;
-                pathLine.path = [];
+                if (gpsDisplay.track)
+                    gpsDisplay.track.clear();
             }
         }
     }
@@ -122,28 +118,16 @@ Rectangle {
     }
 
     Connections {
-        target: udpClient
-        function onGpsLongitudeChanged() {
-            if (isValidCoordinate(udpClient.gpsLatitude, udpClient.gpsLongitude)) {
-                gpsDisplay.gpsLongitude = udpClient.gpsLongitude;
-                currentLongitude = udpClient.gpsLongitude;
-                currentLatitude = udpClient.gpsLatitude;
-                var newCoord = QtPositioning.coordinate(udpClient.gpsLatitude, udpClient.gpsLongitude);
-                map.center = newCoord;
-                // Only update path when both coordinates have changed
-                updatePath(udpClient.gpsLatitude, udpClient.gpsLongitude);
-            }
+        target: gpsDisplay.track
+        function onPositionChanged() {
+            if (gpsDisplay.track.hasFix)
+                map.center = QtPositioning.coordinate(gpsDisplay.track.latitude, gpsDisplay.track.longitude);
         }
-        function onGpsLatitudeChanged() {
-            if (isValidCoordinate(udpClient.gpsLatitude, udpClient.gpsLongitude)) {
-                gpsDisplay.gpsLatitude = udpClient.gpsLatitude;
-                currentLongitude = udpClient.gpsLongitude;
-                currentLatitude = udpClient.gpsLatitude;
-                var newCoord = QtPositioning.coordinate(udpClient.gpsLatitude, udpClient.gpsLongitude);
-                map.center = newCoord;
-                // Only update path when both coordinates have changed
-                updatePath(udpClient.gpsLatitude, udpClient.gpsLongitude);
-            }
+        function onPathExtended(from) {
+            gpsDisplay.extendPath(from);
+        }
+        function onPathReset() {
+            gpsDisplay.reloadPath();
         }
     }
 }
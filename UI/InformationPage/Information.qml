@@ -1,5 +1,5 @@
 import QtQuick 2.15
-import QtQuick.Shapes
+import Car_Dashboard.Telemetry 1.0
 import "../StatusBar"
 
 Rectangle {
@@ -318,28 +318,18 @@ Rectangle {
 
 
 
-            Shape {
-                id: pathShape
+            // Trail of the real G values, drawn in the scene graph from the client's history.
+            // Counter-rotated so lateral G runs across and acceleration points up on screen.
+            GgDiagram {
+                id: ggTrail
                 anchors.fill: parent
-                smooth: true
-                antialiasing: true
-
-                ShapePath {
-                    id: movementPath
-                    strokeWidth: 2
-                    strokeColor: "white"
-                    strokeStyle: ShapePath.SolidLine
-                    fillColor: "transparent"
-
-                    // Start at the center point
-                    startX: ggImage.centerX
-                    startY: ggImage.centerY
-
-                    // Create path segments using a dynamic PathPolyline
-                    PathPolyline {
-                        id: polyline
-                    }
-                }
+                rotation: 90
+                history: root.dataClient ? root.dataClient.history : null
+                maxLateralG: root.maxLateralG
+                maxLongitudinalG: root.maxLongitudinalG
+                trailLength: 2000
+                color: "white"
+                z: 1
             }
 
             // Add the point marker
@@ -375,28 +365,6 @@ Rectangle {
             }
         }
 
-        // Point tracking for line drawing
-        Timer {
-            id: pathTracker
-            interval: 100  // Update every 100ms
-            running: true
-            repeat: true
-
-            property var pathPoints: []
-
-            onTriggered: {
-                // Calculate the center point of the marker with limits
-                const pointX = Math.max(0, Math.min(ggImage.width, pointImage.x + pointImage.width/2));
-                const pointY = Math.max(0, Math.min(ggImage.height, pointImage.y + pointImage.height/2));
-
-                // Add point to the path
-                pathPoints.push(Qt.point(pointX, pointY));
-
-                // Update the polyline path
-                polyline.path = pathPoints;
-            }
-        }
-
         // Add acceleration text displays
         Row {
             anchors {
@@ -433,11 +401,36 @@ Rectangle {
                     hoverEnabled: true
                     onEntered: parent.color = "#808080"
                     onExited: parent.color = "#636363"
-                    onClicked: {
-                        pathTracker.pathPoints = []
-                        polyline.path = []
+                    onClicked: ggTrail.clear()
+                }
+            }
+
+            // Switch between the trail and the density of the whole session
+            Rectangle {
+                id: heatmapButton
+                width: 70
+                height: 20
+                color: ggTrail.mode === GgDiagram.Heatmap ? "#808080" : "#636363"
+                radius: 15
+                border.color: "white"
+                border.width: 1
+                z: 3
+
+                Text {
+                    text: ggTrail.mode === GgDiagram.Heatmap ? "Trail" : "Heatmap"
+                    color: "white"
+                    anchors.centerIn: parent
+                    font {
+                        family: "Arial"
+                        pixelSize: 14
+                        bold: true
                     }
                 }
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: ggTrail.mode = ggTrail.mode === GgDiagram.Heatmap ? GgDiagram.Trail : GgDiagram.Heatmap
+                }
             }
 
             Text {
@@ -502,16 +495,30 @@ Rectangle {
 
         GpsPlotter {
             id : gps
+            dataClient : root.dataClient
             anchors {
                 horizontalCenter : parent.horizontalCenter
                 top : parent.top
-                bottom : parent.bottom
+                bottom : replayControls.visible ? replayControls.top : parent.bottom
                 topMargin : 30
                 bottomMargin : 10
 
             }
         }
 
+        // Only a replay has a duration
+        ReplayControls {
+            id : replayControls
+            replayClient : root.dataClient
+            visible : root.dataClient !== null && root.dataClient.duration !== undefined
+            anchors {
+                left : parent.left
+                right : parent.right
+                bottom : parent.bottom
+                bottomMargin : 10
+            }
+        }
+
     }
     /********************************************************/
 
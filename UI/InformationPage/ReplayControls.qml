@@ -0,0 +1,114 @@
+import QtQuick
+import QtQuick.Controls
+
+// Playback controls for a ReplayClient: pause, speed and a seek bar
+Rectangle {
+    id: root
+    property var replayClient: null
+    readonly property var speeds: [1, 2, 5, 10, 0] // 0 replays as fast as possible
+
+    height: 60
+    color: "transparent"
+
+    function formatTime(seconds) {
+        var minutes = Math.floor(seconds / 60)
+        var rest = Math.floor(seconds % 60)
+        return minutes + ":" + (rest < 10 ? "0" : "") + rest
+    }
+
+    Row {
+        id: buttons
+        spacing: 8
+        anchors {
+            top: parent.top
+            horizontalCenter: parent.horizontalCenter
+        }
+
+        Rectangle {
+            width: 60
+            height: 20
+            color: "#636363"
+            radius: 15
+            border.color: "white"
+            border.width: 1
+
+            Text {
+                text: root.replayClient && root.replayClient.paused ? "Play" : "Pause"
+                color: "white"
+                anchors.centerIn: parent
+                font {
+                    family: "Arial"
+                    pixelSize: 14
+                    bold: true
+                }
+            }
+
+            MouseArea {
+                anchors.fill: parent
+                onClicked: root.replayClient.paused = !root.replayClient.paused
+            }
+        }
+
+        // Cycles through the speeds
+        Rectangle {
+            width: 50
+            height: 20
+            color: "#636363"
+            radius: 15
+            border.color: "white"
+            border.width: 1
+
+            Text {
+                text: !root.replayClient ? "" : root.replayClient.speed === 0 ? "Max" : root.replayClient.speed + "x"
+                color: "white"
+                anchors.centerIn: parent
+                font {
+                    family: "Arial"
+                    pixelSize: 14
+                    bold: true
+                }
+            }
+
+            MouseArea {
+                anchors.fill: parent
+                onClicked: {
+                    var next = (root.speeds.indexOf(root.replayClient.speed) + 1) % root.speeds.length
+                    root.replayClient.speed = root.speeds[next]
+                }
+            }
+        }
+
+        Text {
+            text: root.replayClient ? root.formatTime(root.replayClient.position) + " / " + root.formatTime(root.replayClient.duration) : ""
+            color: root.replayClient && root.replayClient.finished ? "turquoise" : "white"
+            font {
+                family: "DS-Digital"
+                pixelSize: 16
+            }
+        }
+    }
+
+    Slider {
+        id: seekBar
+        from: 0
+        to: root.replayClient ? Math.max(root.replayClient.duration, 0.001) : 1
+        anchors {
+            top: buttons.bottom
+            left: parent.left
+            right: parent.right
+            leftMargin: 10
+            rightMargin: 10
+        }
+
+        // Follow the replay except while the handle is held; seek once it is released
+        Binding on value {
+            value: root.replayClient ? root.replayClient.position : 0
+            when: !seekBar.pressed
+        }
+
+        onPressedChanged: {
+            if (!pressed && root.replayClient)
+                root.replayClient.seek(value)
+        }
+    }
+}
@@ -1,5 +1,6 @@
 import QtQuick
 import QtQuick.Controls
+import Car_Dashboard.Telemetry 1.0
 
 
 Item {
@@ -16,19 +17,12 @@ Item {
         }
     }
 
-    onRpmChanged: {
-        gaugeCanvas.requestPaint()
-        needleCanvas.requestPaint()
-    }
-
     function gaugeValue() {
         return rpm / 1000.0;
     }
 
     function getRpmColor(value) {
-        if (value <= 4) return "#4CAF50";
-        if (value <= 6) return "#FFC107";
-        return "#F44336";
+        return dial.colorAt(value * 1000);
     }
 
     property real maxGauge: 8;
@@ -44,99 +38,46 @@ Item {
             width: 270
             height: 250  // Reduced height to bring text closer to gauge
 
-            Canvas {
-                id: gaugeCanvas
+            // Dial and needle are scene-graph geometry; an rpm change only turns the needle
+            DialGauge {
+                id: dial
                 anchors.fill: parent
-
-                onPaint: {
-                    var ctx = getContext("2d");
-                    var centerX = width / 2;
-                    var centerY = height / 2;
-                    var radius = 108;
-
-                    ctx.clearRect(0, 0, width, height);
-                    ctx.save();
-                    ctx.translate(centerX, centerY);
-
-                    var step = 0.2;
-                    var numSteps = rpmMeter.maxGauge / step;
-                    for (var i = 0; i <= numSteps; i++) {
-                        var tickValue = i * step;
-                        var intVal = Math.round(tickValue);
-                        if (Math.abs(tickValue - intVal) < 0.001)
-                            tickValue = intVal;
-                        var t = tickValue / rpmMeter.maxGauge;
-                        var angle = rpmMeter.startAngle + t * rpmMeter.arcAngle;
-                        angle = angle * Math.PI / 180;
-
-                        var isMajor = (Math.abs(tickValue - Math.round(tickValue)) < 0.001);
-                        var lineWidth = isMajor ? 4 : 2;
-                        var lineLength = isMajor ? 18 : 9;
-
-                        var startX = radius * Math.cos(angle);
-                        var startY = radius * Math.sin(angle);
-                        var endX = (radius - lineLength) * Math.cos(angle);
-                        var endY = (radius - lineLength) * Math.sin(angle);
-
-                        var currentGauge = rpmMeter.gaugeValue();
-                        var dashColor = (tickValue <= currentGauge) ? rpmMeter.getRpmColor(tickValue) : "#808080";
-
-                        ctx.strokeStyle = dashColor;
-                        ctx.lineWidth = lineWidth;
-                        ctx.beginPath();
-                        ctx.moveTo(startX, startY);
-                        ctx.lineTo(endX, endY);
-                        ctx.stroke();
-
-                        if (isMajor) {
-                            var labelRadius = radius - 31.5;
-                            var labelX = labelRadius * Math.cos(angle);
-                            var labelY = labelRadius * Math.sin(angle) + 4.5;
-                            ctx.font = "bold 12.6px sans-serif";
-                            ctx.fillStyle = rpmMeter.getRpmColor(tickValue);
-                            ctx.textAlign = "center";
-                            ctx.textBaseline = "middle";
-                            ctx.fillText(tickValue.toString(), labelX, labelY);
-                        }
-                    }
-                    ctx.restore();
-                }
+                value: rpmMeter.rpm
+                minimumValue: 0
+                maximumValue: rpmMeter.maxGauge * 1000
+                startAngle: rpmMeter.startAngle
+                sweepAngle: rpmMeter.arcAngle
+                radius: 108
+                minorTickInterval: 200
+                majorTickInterval: 1000
+                minorTickLength: 9
+                majorTickLength: 18
+                minorTickWidth: 2
+                majorTickWidth: 4
+                inactiveColor: "#808080"
+                zones: [
+                    { "limit": 4000, "color": "#4CAF50" },
+                    { "limit": 6000, "color": "#FFC107" },
+                    { "limit": rpmMeter.maxGauge * 1000, "color": "#F44336" }
+                ]
+                needleLength: 90
+                needleWidth: 4
+                hubRadius: 7.2
             }
 
-            Canvas {
-                id: needleCanvas
-                anchors.fill: parent
-
-                onPaint: {
-                    var ctx = getContext("2d");
-                    var centerX = width / 2;
-                    var centerY = height / 2;
-                    var radius = 90;
-
-                    ctx.clearRect(0, 0, width, height);
-                    var currentGauge = rpmMeter.gaugeValue();
-                    var t = currentGauge / rpmMeter.maxGauge;
-                    var angle = rpmMeter.startAngle + t * rpmMeter.arcAngle;
-                    angle = angle * Math.PI / 180;
-                    var needleX = radius * Math.cos(angle);
-                    var needleY = radius * Math.sin(angle);
-
-                    ctx.shadowColor = 'rgba(0, 0, 0, 0.3)';
-                    ctx.shadowBlur = 5;
-                    ctx.shadowOffsetX = 2;
-                    ctx.shadowOffsetY = 2;
+            Repeater {
+                model: rpmMeter.maxGauge + 1
 
-                    ctx.strokeStyle = rpmMeter.getRpmColor(currentGauge);
-                    ctx.lineWidth = 4;
-                    ctx.beginPath();
-                    ctx.moveTo(centerX, centerY);
-                    ctx.lineTo(centerX + needleX, centerY + needleY);
-                    ctx.stroke();
+                Text {
+                    required property int index
+                    readonly property point position: dial.pointAt(index * 1000, dial.radius - 31.5)
 
-                    ctx.beginPath();
-                    ctx.arc(centerX, centerY, 7.2, 0, 2 * Math.PI);
-                    ctx.fillStyle = rpmMeter.getRpmColor(currentGauge);
-                    ctx.fill();
+                    x: position.x - width / 2
+                    y: position.y + 4.5 - height / 2
+                    text: index
+                    color: rpmMeter.getRpmColor(index)
+                    font.pixelSize: 13
+                    font.bold: true
                 }
             }
 
@@ -1,4 +1,5 @@
 import QtQuick 2.15
+import Car_Dashboard.Telemetry 1.0
 
 Item {
     id: speedometer
@@ -15,16 +16,8 @@ Item {
         }
     }
 
-    onSpeedChanged: {
-        gaugeCanvas.requestPaint()
-        needleCanvas.requestPaint()
-    }
-
     function getSpeedColor(value) {
-        if (value <= 60) return "#4CAF50"
-        if (value <= 120) return "#FFC107"
-        if (value <= 180) return "#FF9800"
-        return "#F44336"
+        return dial.colorAt(value)
     }
 
     Column {
@@ -36,84 +29,47 @@ Item {
             width: 270
             height: 270
 
-            Canvas {
-                id: gaugeCanvas
+            // Dial and needle are scene-graph geometry; a speed change only turns the needle
+            DialGauge {
+                id: dial
                 anchors.fill: parent
-
-                onPaint: {
-                    var ctx = getContext("2d")
-                    var centerX = width / 2
-                    var centerY = height / 2
-                    var radius = 126
-
-                    ctx.clearRect(0, 0, width, height)
-                    ctx.save()
-                    ctx.translate(centerX, centerY)
-
-                    for (var i = 0; i <= 240; i += 2) {
-                        var angle = (i / 240 * 240 - 210) * Math.PI / 180
-                        var isMajor = (i % 10 === 0)
-                        var lineWidth = isMajor ? 4 : 3
-                        var lineLength = isMajor ? 18 : 9
-                        var startX = radius * Math.cos(angle)
-                        var startY = radius * Math.sin(angle)
-                        var endX = (radius - lineLength) * Math.cos(angle)
-                        var endY = (radius - lineLength) * Math.sin(angle)
-                        var dashColor = (i <= speedometer.speed) ? speedometer.getSpeedColor(i) : "#808080"
-
-                        ctx.strokeStyle = dashColor
-                        ctx.lineWidth = lineWidth
-                        ctx.beginPath()
-                        ctx.moveTo(startX, startY)
-                        ctx.lineTo(endX, endY)
-                        ctx.stroke()
-
-                        if (i === 0 || i === 60 || i === 120 || i === 180 || i === 240) {
-                            var labelRadius = radius - 31.5
-                            var labelX = labelRadius * Math.cos(angle)
-                            var labelY = labelRadius * Math.sin(angle) + 4.5
-                            ctx.font = "bold 12.6px sans-serif"
-                            ctx.fillStyle = speedometer.getSpeedColor(i)
-                            ctx.textAlign = "center"
-                            ctx.textBaseline = "middle"
-                            ctx.fillText(i.toString(), labelX, labelY)
-                        }
-                    }
-                    ctx.restore()
-                }
+                value: speedometer.speed
+                minimumValue: 0
+                maximumValue: 240
+                startAngle: -210
+                sweepAngle: 240
+                radius: 126
+                minorTickInterval: 2
+                majorTickInterval: 10
+                minorTickLength: 9
+                majorTickLength: 18
+                minorTickWidth: 3
+                majorTickWidth: 4
+                inactiveColor: "#808080"
+                zones: [
+                    { "limit": 60, "color": "#4CAF50" },
+                    { "limit": 120, "color": "#FFC107" },
+                    { "limit": 180, "color": "#FF9800" },
+                    { "limit": 240, "color": "#F44336" }
+                ]
+                needleLength: 108
+                needleWidth: 4
+                hubRadius: 7.2
             }
 
-            Canvas {
-                id: needleCanvas
-                anchors.fill: parent
-
-                onPaint: {
-                    var ctx = getContext("2d")
-                    var centerX = width / 2
-                    var centerY = height / 2
-                    var radius = 108
-
-                    ctx.clearRect(0, 0, width, height)
-                    var angle = (speedometer.speed / 240 * 240 - 210) * Math.PI / 180
-                    var needleX = radius * Math.cos(angle)
-                    var needleY = radius * Math.sin(angle)
-
-                    ctx.shadowColor = 'rgba(0, 0, 0, 0.3)'
-                    ctx.shadowBlur = 5
-                    ctx.shadowOffsetX = 2
-                    ctx.shadowOffsetY = 2
+            Repeater {
+                model: [0, 60, 120, 180, 240]
 
-                    ctx.strokeStyle = speedometer.getSpeedColor(speedometer.speed)
-                    ctx.lineWidth = 4
-                    ctx.beginPath()
-                    ctx.moveTo(centerX, centerY)
-                    ctx.lineTo(centerX + needleX, centerY + needleY)
-                    ctx.stroke()
+                Text {
+                    required property int modelData
+                    readonly property point position: dial.pointAt(modelData, dial.radius - 31.5)
 
-                    ctx.beginPath()
-                    ctx.arc(centerX, centerY, 7.2, 0, 2 * Math.PI)
-                    ctx.fillStyle = speedometer.getSpeedColor(speedometer.speed)
-                    ctx.fill()
+                    x: position.x - width / 2
+                    y: position.y + 4.5 - height / 2
+                    text: modelData
+                    color: dial.colorAt(modelData)
+                    font.pixelSize: 13
+                    font.bold: true
                 }
             }
 
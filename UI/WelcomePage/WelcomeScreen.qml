@@ -134,7 +134,7 @@ Rectangle {
 
 
                 Text {
-                    text: "Choose Port:"
+                    text: protocolCombo.currentIndex === 2 ? "Session Log:" : "Choose Port:"
                     font {
                         bold: true
                         pixelSize: 14 * root.scaleFactor
@@ -147,7 +147,8 @@ Rectangle {
 
                 TextField {
                     id : portField
-                    placeholderText: startButton.inValid_Port ? "Don't Leave This Empty!" : "Enter Port (e.g. , 8080)"
+                    placeholderText: startButton.inValid_Port ? "Don't Leave This Empty!"
+                                     : protocolCombo.currentIndex === 2 ? "Path to a .cdlog file" : "Enter Port (e.g. , 8080)"
                     placeholderTextColor: startButton.inValid_Port ? "darkRed" : "turquoise"
 
                     width: 300 * root.scaleFactor
@@ -172,7 +173,7 @@ Rectangle {
                     anchors.horizontalCenter: parent.horizontalCenter
                     ComboBox {
                         id: protocolCombo
-                        model: ["UDP", "MQTT"]
+                        model: ["UDP", "MQTT", "Replay"]
                         width: 100
                     }
                     Text { text: "Protocol"; color: "white"; verticalAlignment: Text.AlignVCenter }
@@ -203,19 +204,32 @@ Rectangle {
 
                 onClicked : {
                     var useMqtt = protocolCombo.currentIndex === 1
-                    inValid_Name = (sessionNameField.text === "")
+                    var useReplay = protocolCombo.currentIndex === 2
+                    inValid_Name = (!useReplay && sessionNameField.text === "")
                     inValid_Port = (!useMqtt && portField.text === "")
 
                     if(!inValid_Name && (useMqtt || !inValid_Port)) {
                         var portNumber = parseInt(portField.text.trim())
 
-                        if(!useMqtt) {
+                        if(useReplay) {
+                            // Replays are not recorded again; the log names the session
+                            if (replayClient.start(portField.text.trim())) {
+                                stackView.push("WaitingScreen.qml", {
+                                    "sessionName": sessionNameField.text !== "" ? sessionNameField.text : replayClient.sessionName,
+                                    "portNumber": "Replay",
+                                    "client": replayClient
+                                })
+                            } else {
+                                inValid_Port = true
+                            }
+                        } else if(!useMqtt) {
                             if (isNaN(portNumber) || portNumber < 1 || portNumber > 65535) {
                                 inValid_Port = true
                                 return
                             }
                             var success = udpClient.start(portNumber)
                             if (success) {
+                                udpClient.startRecording(sessionNameField.text)
                                 stackView.push("WaitingScreen.qml", {
                                     "sessionName": sessionNameField.text,
                                     "portNumber": portField.text,
@@ -225,6 +239,7 @@ Rectangle {
                         } else {
                             var ok = mqttClient.start()
                             if (ok) {
+                                mqttClient.startRecording(sessionNameField.text)
                                 stackView.push("WaitingScreen.qml", {
                                     "sessionName": sessionNameField.text,
                                     "portNumber": "",
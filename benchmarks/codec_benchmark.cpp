@@ -0,0 +1,193 @@
+#include <Controllers/columncodec.h>
+#include <Controllers/telemetrychannels.h>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+/*Compression ratio and speed of the column codecs on a synthetic session.
+ * The session is a 1 kHz recording whose channels move like a car's: values quantized to their
+ *  sensor resolution, slow trends, a little noise, and channels that hardly ever change. Each
+ *   column is cut into export-sized chunks, encoded, decoded and compared with the original, and
+ *    the sizes are set against the packed columns and the CSV and binary session logs.
+ *
+ * Usage: codec_benchmark [frames] [chunk-rows]
+ */
+
+namespace
+{
+struct Column
+{
+    const char *name;
+    ColumnarSessionFormat::ColumnType type;
+    std::vector<char> data;
+    qint64 encodedBytes = 0;
+};
+
+template <typename T>
+constexpr ColumnarSessionFormat::ColumnType columnTypeOf()
+{
+    if constexpr (std::is_same_v<T, float>)
+    {
+        return ColumnarSessionFormat::Float32;
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        return ColumnarSessionFormat::Float64;
+    }
+    else
+    {
+        return ColumnarSessionFormat::Int32;
+    }
+}
+
+template <typename T>
+void appendValue(std::vector<char> &data, T value)
+{
+    char bytes[sizeof(T)];
+    if constexpr (std::is_same_v<T, float>)
+    {
+        qToLittleEndian<quint32>(std::bit_cast<quint32>(value), bytes);
+    }
+    else if constexpr (std::is_same_v<T, double>)
+    {
+        qToLittleEndian<quint64>(std::bit_cast<quint64>(value), bytes);
+    }
+    else
+    {
+        qToLittleEndian<T>(value, bytes);
+    }
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+double quantize(double value, double step)
+{
+    return std::round(value / step) * step;
+}
+
+TelemetryFrame syntheticFrame(int i, std::mt19937 &random)
+{
+    std::normal_distribution<double> noise(0.0, 1.0);
+    const double t = i / 1000.0;
+    const double speed = 120 + 100 * std::sin(t * 0.05);
+
+    TelemetryFrame frame;
+    frame.speed = float(quantize(speed, 0.1));
+    frame.rpm = int(4000 + 3000 * std::sin(t * 0.1) + 5 * noise(random));
+    frame.accPedal = int(50 + 50 * std::sin(t * 0.2));
+    frame.brakePedal = int(std::max(0.0, -60 * std::sin(t * 0.2)));
+    frame.encoderAngle = quantize(90 * std::sin(t * 0.15), 0.1);
+    frame.temperature = float(quantize(60 + 30 * t / 3600.0, 0.5));
+    frame.batteryLevel = 100 - int(t / 36.0) % 100;
+    frame.gpsLongitude = quantize(31.2 + 0.01 * std::cos(t * 0.01), 1e-7);
+    frame.gpsLatitude = quantize(30.0 + 0.01 * std::sin(t * 0.01), 1e-7);
+    frame.speedFL = int(speed + noise(random));
+    frame.speedFR = int(speed + noise(random));
+    frame.speedBL = int(speed + noise(random));
+    frame.speedBR = int(speed + noise(random));
+    frame.lateralG = quantize(1.5 * std::sin(t * 0.7) + 0.02 * noise(random), 0.01);
+    frame.longitudinalG = quantize(1.0 * std::cos(t * 0.4) + 0.02 * noise(random), 0.01);
+    return frame;
+}
+
+// Size of the datagram the car would send for this frame in CSV
+int csvSize(const TelemetryFrame &f)
+{
+    char line[256];
+    return std::snprintf(line, sizeof(line), "%.1f,%d,%d,%d,%.1f,%.1f,%d,%.7f,%.7f,%d,%d,%d,%d,%.2f,%.2f", f.speed, f.rpm,
+                         f.accPedal, f.brakePedal, f.encoderAngle, f.temperature, f.batteryLevel, f.gpsLongitude,
+                         f.gpsLatitude, f.speedFL, f.speedFR, f.speedBL, f.speedBR, f.lateralG, f.longitudinalG);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int frames = argc > 1 ? std::max(1, std::atoi(argv[1])) : 2000000;
+    const int chunkRows = argc > 2 ? std::max(1, std::atoi(argv[2])) : 65536;
+
+    std::vector<Column> columns;
+    columns.push_back({"hostTimestampUs", ColumnarSessionFormat::Int64, {}});
+    columns.push_back({"arrival", ColumnarSessionFormat::UInt64, {}});
+    forEachTelemetryChannel([&](const auto &channel, int) {
+        using Type = typename std::decay_t<decltype(channel)>::Type;
+        columns.push_back({channel.name, columnTypeOf<Type>(), {}});
+    });
+
+    // Receive times jitter around the 1 ms send period
+    std::mt19937 random(42);
+    std::uniform_int_distribution<int> jitter(-30, 30);
+    qint64 csvLogBytes = 0;
+    for (int i = 0; i < frames; ++i)
+    {
+        const TelemetryFrame frame = syntheticFrame(i, random);
+        appendValue<qint64>(columns[0].data, qint64(i) * 1000 + jitter(random));
+        appendValue<quint64>(columns[1].data, quint64(i) + 1);
+        forEachTelemetryChannel([&](const auto &channel, int index) {
+            appendValue(columns[2 + index].data, frame.*channel.member);
+        });
+        csvLogBytes += 20 + csvSize(frame);
+    }
+    const qint64 binaryLogBytes = qint64(frames) * (20 + 63);
+
+    QByteArray encoded;
+    std::vector<char> decoded;
+    qint64 plainBytes = 0;
+    qint64 encodedBytes = 0;
+    qint64 encodeNs = 0;
+    qint64 decodeNs = 0;
+    int mismatches = 0;
+    QElapsedTimer timer;
+
+    for (Column &column : columns)
+    {
+        const int width = ColumnarSessionFormat::typeSize(column.type);
+        const ColumnarSessionFormat::Encoding encoding = ColumnCodec::encodingFor(column.type);
+        for (int first = 0; first < frames; first += chunkRows)
+        {
+            const int rows = std::min(chunkRows, frames - first);
+            const char *values = column.data.data() + qsizetype(first) * width;
+
+            timer.start();
+            ColumnCodec::encode(column.type, values, rows, encoded);
+            encodeNs += timer.nsecsElapsed();
+
+            decoded.resize(size_t(rows) * size_t(width));
+            timer.start();
+            const bool ok = ColumnCodec::decode(column.type, encoding, encoded.constData(), encoded.size(), rows, decoded.data());
+            decodeNs += timer.nsecsElapsed();
+
+            if (!ok || std::memcmp(decoded.data(), values, decoded.size()) != 0)
+            {
+                mismatches++;
+            }
+            column.encodedBytes += encoded.size();
+        }
+
+        plainBytes += qint64(column.data.size());
+        encodedBytes += column.encodedBytes;
+    }
+
+    std::printf("Qt %s, %d frames, %d rows per chunk, round trip: %s\n", qVersion(), frames, chunkRows, mismatches == 0 ? "identical" : "MISMATCHES FOUND");
+    std::printf("%-16s %12s %12s %10s %12s\n", "column", "plain", "encoded", "ratio", "bytes/value");
+    for (const Column &column : columns)
+    {
+        std::printf("%-16s %12zu %12lld %9.1fx %12.2f\n", column.name, column.data.size(), column.encodedBytes,
+                    double(column.data.size()) / double(column.encodedBytes), double(column.encodedBytes) / frames);
+    }
+
+    std::printf("\n%-24s %12s %10s\n", "", "bytes", "vs codec");
+    std::printf("%-24s %12lld %9.1fx\n", "CSV session log", csvLogBytes, double(csvLogBytes) / encodedBytes);
+    std::printf("%-24s %12lld %9.1fx\n", "binary session log", binaryLogBytes, double(binaryLogBytes) / encodedBytes);
+    std::printf("%-24s %12lld %9.1fx\n", "plain columns", plainBytes, double(plainBytes) / encodedBytes);
+    std::printf("%-24s %12lld\n", "compressed columns", encodedBytes);
+
+    // Throughput in uncompressed column bytes
+    std::printf("\nencode %.0f MB/s, decode %.0f MB/s\n", plainBytes * 1e3 / double(encodeNs), plainBytes * 1e3 / double(decodeNs));
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <Controllers/telemetrycsvparser.h>
+#include <cstdio>
+#include <cstdlib>
+
+/*Frames per second of the telemetry CSV decoder before and after the zero-allocation rewrite.
+ * The "before" path is the original UdpParserWorker code: QString::fromUtf8().trimmed().split(",")
+ *  followed by toFloat()/toInt()/toDouble() per part. Both decoders are first run over a set of
+ *   valid and malformed packets to check that they accept, reject and decode identically.
+ *
+ * Usage: csvparser_benchmark [iterations]
+ */
+
+namespace
+{
+// The pre-rewrite decoder, kept verbatim apart from returning instead of emitting
+TelemetryCsvParser::Result parseWithQString(const QByteArray &data, TelemetryFrame &frame)
+{
+    TelemetryCsvParser::Result result;
+
+    QString dataStr = QString::fromUtf8(data).trimmed();
+    QStringList parts = dataStr.split(",");
+    result.fieldCount = int(parts.size());
+
+    if (parts.size() < 15)
+    {
+        result.status = TelemetryCsvParser::WrongFieldCount;
+        return result;
+    }
+
+    bool ok[15];
+    frame.speed = parts[0].toFloat(&ok[0]);
+    frame.rpm = parts[1].toInt(&ok[1]);
+    frame.accPedal = parts[2].toInt(&ok[2]);
+    frame.brakePedal = parts[3].toInt(&ok[3]);
+    frame.encoderAngle = parts[4].toDouble(&ok[4]);
+    frame.temperature = parts[5].toFloat(&ok[5]);
+    frame.batteryLevel = parts[6].toInt(&ok[6]);
+    frame.gpsLongitude = parts[7].toDouble(&ok[7]);
+    frame.gpsLatitude = parts[8].toDouble(&ok[8]);
+    frame.speedFL = parts[9].toInt(&ok[9]);
+    frame.speedFR = parts[10].toInt(&ok[10]);
+    frame.speedBL = parts[11].toInt(&ok[11]);
+    frame.speedBR = parts[12].toInt(&ok[12]);
+    frame.lateralG = parts[13].toDouble(&ok[13]);
+    frame.longitudinalG = parts[14].toDouble(&ok[14]);
+
+    result.status = TelemetryCsvParser::Ok;
+    for (bool fieldOk : ok)
+    {
+        if (!fieldOk)
+        {
+            result.status = TelemetryCsvParser::BadValue;
+        }
+    }
+    return result;
+}
+
+bool sameFrame(const TelemetryFrame &a, const TelemetryFrame &b)
+{
+    return a.speed == b.speed && a.rpm == b.rpm && a.accPedal == b.accPedal && a.brakePedal == b.brakePedal
+           && a.encoderAngle == b.encoderAngle && a.temperature == b.temperature && a.batteryLevel == b.batteryLevel
+           && a.gpsLongitude == b.gpsLongitude && a.gpsLatitude == b.gpsLatitude
+           && a.speedFL == b.speedFL && a.speedFR == b.speedFR && a.speedBL == b.speedBL && a.speedBR == b.speedBR
+           && a.lateralG == b.lateralG && a.longitudinalG == b.longitudinalG;
+}
+
+int checkEquivalence()
+{
+    const QList<QByteArray> samples = {
+        "45.2,3500,30,0,12.5,65.3,87,31.2345678,30.0123456,45,45,44,44,0.35,-0.12",
+        "  45.2, 3500 ,30,0,12.5,65.3,87,31.2345678,30.0123456,45,45,44,44,0.35,-0.12\r\n",
+        "+1,+2,3,4,5,6,7,8,9,10,11,12,13,1e-3,-2.5E2",
+        "0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,extra,fields",
+        "45.2,3500,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35",
+        "45.2,3500.5,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35,-0.12",
+        "45.2,,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35,-0.12",
+        "1e39,3500,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35,-0.12",
+        "45.2,99999999999,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35,-0.12",
+        "45.2,0x10,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35,-0.12",
+        "45.2,+-1,30,0,12.5,65.3,87,31.2,30.0,45,45,44,44,0.35,-0.12",
+        "",
+        "   ",
+        "garbage",
+    };
+
+    int mismatches = 0;
+    for (const QByteArray &sample : samples)
+    {
+        TelemetryFrame before;
+        TelemetryFrame after;
+        const TelemetryCsvParser::Result expected = parseWithQString(sample, before);
+        const TelemetryCsvParser::Result actual = TelemetryCsvParser::parse(sample, after);
+
+        const bool match = expected.status == actual.status
+                           && expected.fieldCount == actual.fieldCount
+                           && (expected.status != TelemetryCsvParser::Ok || sameFrame(before, after));
+        if (!match)
+        {
+            mismatches++;
+            std::printf("MISMATCH for \"%s\": status %d/%d, parts %d/%d\n", sample.constData(),
+                        int(expected.status), int(actual.status), expected.fieldCount, actual.fieldCount);
+        }
+    }
+    return mismatches;
+}
+
+template <typename Parser>
+double framesPerSecond(const QList<QByteArray> &packets, int iterations, Parser parser)
+{
+    TelemetryFrame frame;
+    qint64 accepted = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < iterations; ++i)
+    {
+        if (parser(packets[i % packets.size()], frame).status == TelemetryCsvParser::Ok)
+        {
+            accepted++;
+        }
+    }
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    if (accepted != iterations)
+    {
+        std::printf("warning: %lld of %d frames rejected\n", static_cast<long long>(iterations - accepted), iterations);
+    }
+    return iterations * 1e9 / double(elapsedNs);
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 1000000;
+
+    const int mismatches = checkEquivalence();
+    std::printf("equivalence check: %s\n", mismatches == 0 ? "identical" : "MISMATCHES FOUND");
+
+    // A small rotating set so branch predictors and caches do not see a single constant packet
+    QList<QByteArray> packets;
+    for (int i = 0; i < 64; ++i)
+    {
+        packets.append(QString("%1,%2,%3,%4,%5,%6,%7,%8,%9,%10,%11,%12,%13,%14,%15")
+                           .arg(40.0 + i * 0.37, 0, 'f', 2).arg(3000 + i * 17).arg(i % 100).arg((i * 7) % 100)
+                           .arg(-90.0 + i * 2.9, 0, 'f', 3).arg(60.0 + i * 0.1, 0, 'f', 1).arg(100 - i)
+                           .arg(31.2345678 + i * 1e-6, 0, 'f', 7).arg(30.0123456 + i * 1e-6, 0, 'f', 7)
+                           .arg(40 + i).arg(41 + i).arg(39 + i).arg(40 + i)
+                           .arg(-1.5 + i * 0.05, 0, 'f', 3).arg(1.2 - i * 0.04, 0, 'f', 3)
+                           .toUtf8());
+    }
+
+    const double before = framesPerSecond(packets, iterations, parseWithQString);
+    const double after = framesPerSecond(packets, iterations, [](const QByteArray &data, TelemetryFrame &frame) {
+        return TelemetryCsvParser::parse(data, frame);
+    });
+
+    std::printf("%-28s %14.0f frames/s\n", "QString split + toX()", before);
+    std::printf("%-28s %14.0f frames/s\n", "TelemetryCsvParser", after);
+    std::printf("%-28s %14.2fx\n", "speed-up", after / before);
+
+    return mismatches == 0 ? 0 : 1;
+}
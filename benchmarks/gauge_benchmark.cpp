@@ -0,0 +1,189 @@
+#include <Controllers/dialgauge.h>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQuickWindow>
+#include <QTimer>
+#include <QUrl>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <vector>
+
+/*Frame-time comparison of the Canvas gauges the dashboard used to draw with and the scene-graph
+ * DialGauge versions, at a 1 kHz value update rate.
+ * gauges/GaugeBenchmark.qml shows the speedometer, the rpm meter and three Euler gauges. A 1 ms
+ *  precise timer advances the driving time, so every gauge value changes about once per
+ *  millisecond, far more often than frames are rendered. Each set is warmed up and then
+ *  measured for the same time. Per set it reports:
+ *   - value updates per second that actually ran; below 1000 the GUI thread is saturated
+ *   - frames per second and the frame interval (frameSwapped to frameSwapped)
+ *   - GUI frame time: afterAnimating to afterSynchronizing, i.e. polish (where Canvas paints)
+ *     plus the scene-graph sync
+ *   - render time: beforeRendering to afterRendering
+ *
+ * Usage: gauge_benchmark [seconds-per-set]
+ */
+
+namespace
+{
+constexpr int WarmUpMs = 1000;
+
+struct Distribution
+{
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+    double maxMs = 0.0;
+};
+
+Distribution distribution(std::vector<qint64> samples)
+{
+    Distribution result;
+    if (samples.empty())
+    {
+        return result;
+    }
+
+    std::sort(samples.begin(), samples.end());
+    const auto at = [&](double fraction) {
+        return samples[std::min(samples.size() - 1, size_t(fraction * double(samples.size())))] / 1e6;
+    };
+    result.p50Ms = at(0.50);
+    result.p99Ms = at(0.99);
+    result.maxMs = samples.back() / 1e6;
+    return result;
+}
+
+// Frame signals arrive on the GUI thread and, with the threaded render loop, the render thread
+class FrameRecorder
+{
+public:
+    explicit FrameRecorder(QQuickWindow *window)
+    {
+        m_clock.start();
+
+        QObject::connect(window, &QQuickWindow::afterAnimating, window, [this]() { mark(m_animated); }, Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::afterSynchronizing, window, [this]() { measureFrom(m_animated, m_guiFrame); }, Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::beforeRendering, window, [this]() { mark(m_renderStart); }, Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::afterRendering, window, [this]() { measureFrom(m_renderStart, m_render); }, Qt::DirectConnection);
+        QObject::connect(window, &QQuickWindow::frameSwapped, window, [this]() {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            const qint64 now = m_clock.nsecsElapsed();
+            if (m_lastSwap > 0)
+            {
+                m_interval.push_back(now - m_lastSwap);
+            }
+            m_lastSwap = now;
+        }, Qt::DirectConnection);
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_guiFrame.clear();
+        m_render.clear();
+        m_interval.clear();
+        m_lastSwap = 0;
+    }
+
+    void take(std::vector<qint64> &guiFrame, std::vector<qint64> &render, std::vector<qint64> &interval)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        guiFrame.swap(m_guiFrame);
+        render.swap(m_render);
+        interval.swap(m_interval);
+    }
+
+private:
+    void mark(qint64 &start)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        start = m_clock.nsecsElapsed();
+    }
+
+    void measureFrom(qint64 start, std::vector<qint64> &samples)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (start > 0)
+        {
+            samples.push_back(m_clock.nsecsElapsed() - start);
+        }
+    }
+
+    std::mutex m_mutex;
+    QElapsedTimer m_clock;
+    qint64 m_animated = 0;
+    qint64 m_renderStart = 0;
+    qint64 m_lastSwap = 0;
+    std::vector<qint64> m_guiFrame;
+    std::vector<qint64> m_render;
+    std::vector<qint64> m_interval;
+};
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+    const int measureMs = (argc > 1 ? std::max(1, std::atoi(argv[1])) : 5) * 1000;
+
+    qmlRegisterType<DialGauge>("Car_Dashboard.Telemetry", 1, 0, "DialGauge");
+
+    QQmlApplicationEngine engine;
+    engine.load(QUrl::fromLocalFile(QStringLiteral(GAUGE_BENCHMARK_QML)));
+    QQuickWindow *window = engine.rootObjects().isEmpty() ? nullptr : qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst());
+    if (!window)
+    {
+        std::fprintf(stderr, "failed to load %s\n", GAUGE_BENCHMARK_QML);
+        return 1;
+    }
+
+    FrameRecorder recorder(window);
+    QElapsedTimer driveClock;
+    driveClock.start();
+    qint64 updates = 0;
+
+    QTimer drive;
+    drive.setTimerType(Qt::PreciseTimer);
+    drive.setInterval(1);
+    QObject::connect(&drive, &QTimer::timeout, window, [&]() {
+        window->setProperty("t", driveClock.nsecsElapsed() / 1e9);
+        updates++;
+    });
+    drive.start();
+
+    std::printf("1 kHz value updates, %d s per gauge set\n", measureMs / 1000);
+    std::printf("%-12s %9s %7s %22s %22s %22s\n", "gauges", "updates/s", "fps",
+                "interval p50/p99/max", "gui frame p50/p99/max", "render p50/p99/max");
+
+    const auto runSet = [&](bool canvas, auto next) {
+        window->setProperty("canvas", canvas);
+        QTimer::singleShot(WarmUpMs, window, [&, canvas, next]() {
+            recorder.reset();
+            updates = 0;
+
+            QTimer::singleShot(measureMs, window, [&, canvas, next]() {
+                std::vector<qint64> guiFrame, render, interval;
+                recorder.take(guiFrame, render, interval);
+                const double seconds = measureMs / 1000.0;
+                const Distribution intervalMs = distribution(interval);
+                const Distribution guiMs = distribution(guiFrame);
+                const Distribution renderMs = distribution(render);
+
+                std::printf("%-12s %9.0f %7.1f %8.2f/%6.2f/%6.2f %8.2f/%6.2f/%6.2f %8.2f/%6.2f/%6.2f\n",
+                            canvas ? "canvas" : "scene-graph", updates / seconds, interval.size() / seconds,
+                            intervalMs.p50Ms, intervalMs.p99Ms, intervalMs.maxMs,
+                            guiMs.p50Ms, guiMs.p99Ms, guiMs.maxMs,
+                            renderMs.p50Ms, renderMs.p99Ms, renderMs.maxMs);
+                std::fflush(stdout);
+                next();
+            });
+        });
+    };
+
+    runSet(true, [&]() {
+        runSet(false, [&]() { QCoreApplication::quit(); });
+    });
+
+    return app.exec();
+}
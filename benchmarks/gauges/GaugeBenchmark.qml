@@ -0,0 +1,56 @@
+import QtQuick
+import QtQuick.Window
+import "../../UI/InformationPage" as Dashboard
+
+// Both gauge sets side by side in layout, only one of them loaded at a time. The driver sets
+// `canvas` to pick the set and advances `t` (seconds) from a 1 kHz timer.
+Window {
+    id: window
+    width: 1280
+    height: 600
+    visible: true
+    color: "#202020"
+    title: canvas ? "Canvas gauges" : "Scene-graph gauges"
+
+    property bool canvas: true
+    property real t: 0
+
+    readonly property real speed: 120 + 115 * Math.sin(t * 1.3)
+    readonly property int rpm: 4000 + 3900 * Math.sin(t * 2.1)
+    readonly property real yaw: 85 * Math.sin(t * 0.7)
+    readonly property real pitch: 60 * Math.sin(t * 1.1)
+    readonly property real roll: 45 * Math.sin(t * 1.7)
+
+    Loader {
+        anchors.fill: parent
+        sourceComponent: window.canvas ? canvasGauges : sceneGraphGauges
+    }
+
+    Component {
+        id: canvasGauges
+
+        Row {
+            CanvasSpeedometer { speed: window.speed }
+            CanvasRpmMeter { rpm: window.rpm }
+            Column {
+                CanvasEulerGauges { textVal: "Yaw"; scaleFactor: 1.8; width: 180; height: 200; eulerAngle: window.yaw; onEulerAngleChanged: rePaint() }
+                CanvasEulerGauges { textVal: "Pitch"; scaleFactor: 1.8; width: 180; height: 200; eulerAngle: window.pitch; onEulerAngleChanged: rePaint() }
+                CanvasEulerGauges { textVal: "Roll"; scaleFactor: 1.8; width: 180; height: 200; eulerAngle: window.roll; onEulerAngleChanged: rePaint() }
+            }
+        }
+    }
+
+    Component {
+        id: sceneGraphGauges
+
+        Row {
+            Dashboard.Speedometer { speed: window.speed }
+            Dashboard.RpmMeter { rpm: window.rpm }
+            Column {
+                Dashboard.EulerGauges { textVal: "Yaw"; scaleFactor: 1.8; width: 180; height: 200; eulerAngle: window.yaw }
+                Dashboard.EulerGauges { textVal: "Pitch"; scaleFactor: 1.8; width: 180; height: 200; eulerAngle: window.pitch }
+                Dashboard.EulerGauges { textVal: "Roll"; scaleFactor: 1.8; width: 180; height: 200; eulerAngle: window.roll }
+            }
+        }
+    }
+}
@@ -0,0 +1,253 @@
+#include <QByteArray>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QWaitCondition>
+#include <Controllers/eventcount.h>
+#include <Controllers/mpmcqueue.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*Compares the parser input queue before and after the lock-free rewrite.
+ * One producer thread plays the receiver and spreads datagrams round-robin over N consumer
+ *  threads, exactly like the receiver/parser pipeline does. Two runs per configuration:
+ *   - saturated: the producer pushes as fast as it can, reporting datagrams per second
+ *   - paced: the producer sends at a fixed telemetry rate, reporting enqueue-to-dequeue latency,
+ *     which is dominated by how quickly an idle consumer wakes up
+ *
+ * Usage: queue_benchmark [saturated-count] [paced-rate-hz]
+ */
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Item
+{
+    QByteArray data;
+    qint64 enqueuedNs = 0;
+};
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+// The original UdpParserWorker queue: QQueue guarded by a QMutex, consumers poll every 100 ms
+class MutexQueue
+{
+public:
+    bool push(Item &&item)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_queue.enqueue(std::move(item));
+        m_condition.wakeOne();
+        return true;
+    }
+
+    bool pop(Item &item, const std::atomic<bool> &running)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (m_queue.isEmpty() && running.load())
+        {
+            m_condition.wait(&m_mutex, 100);
+        }
+        if (m_queue.isEmpty())
+        {
+            return false;
+        }
+        item = m_queue.dequeue();
+        return true;
+    }
+
+    void wakeAll()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_condition.wakeAll();
+    }
+
+private:
+    QQueue<Item> m_queue;
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+};
+
+// The current UdpParserWorker queue: BoundedMpmcQueue plus an EventCount for idle consumers
+class LockFreeQueue
+{
+public:
+    LockFreeQueue() : m_queue(8192) {}
+
+    bool push(Item &&item)
+    {
+        if (!m_queue.tryPush(std::move(item)))
+        {
+            return false;
+        }
+        m_events.notifyOne();
+        return true;
+    }
+
+    bool pop(Item &item, const std::atomic<bool> &running)
+    {
+        for (;;)
+        {
+            if (m_queue.tryPop(item))
+            {
+                return true;
+            }
+            const quint32 key = m_events.prepareWait();
+            if (!m_queue.isEmpty() || !running.load())
+            {
+                m_events.cancelWait();
+                if (!running.load() && m_queue.isEmpty())
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                m_events.commitWait(key);
+            }
+        }
+    }
+
+    void wakeAll() { m_events.notifyAll(); }
+
+private:
+    BoundedMpmcQueue<Item> m_queue;
+    EventCount m_events;
+};
+
+struct Result
+{
+    double datagramsPerSecond = 0.0;
+    double meanLatencyUs = 0.0;
+    double maxLatencyUs = 0.0;
+};
+
+template <typename Queue>
+Result runPipeline(int consumers, int count, int rateHz)
+{
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (int i = 0; i < consumers; ++i)
+    {
+        queues.push_back(std::make_unique<Queue>());
+    }
+
+    std::atomic<bool> running(true);
+    std::atomic<int> consumed(0);
+    std::vector<qint64> latencySum(consumers, 0);
+    std::vector<qint64> latencyMax(consumers, 0);
+    std::vector<std::thread> threads;
+
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c]() {
+            Item item;
+            quint32 checksum = 0;
+            while (queues[c]->pop(item, running))
+            {
+                const qint64 latency = nowNs() - item.enqueuedNs;
+                latencySum[c] += latency;
+                latencyMax[c] = std::max(latencyMax[c], latency);
+
+                // Stand-in for parsing: touch every byte
+                for (char ch : item.data)
+                {
+                    checksum = checksum * 31 + quint8(ch);
+                }
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (checksum == 0xFFFFFFFFu)
+            {
+                std::printf(" ");
+            }
+        });
+    }
+
+    const QByteArray payload("45.2,3500,30,0,12.5,65.3,87,31.2345678,30.0123456,45,45,44,44,0.35,-0.12");
+    const auto period = rateHz > 0 ? std::chrono::nanoseconds(1000000000LL / rateHz) : std::chrono::nanoseconds(0);
+    const auto start = Clock::now();
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (rateHz > 0)
+        {
+            const auto due = start + period * i;
+            while (Clock::now() < due)
+            {
+                std::this_thread::yield();
+            }
+        }
+
+        // A full bounded queue applies backpressure instead of dropping, so both queues do the same work
+        Item item;
+        item.data = payload;
+        item.enqueuedNs = nowNs();
+        while (!queues[i % consumers]->push(std::move(item)))
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    while (consumed.load() < count)
+    {
+        std::this_thread::yield();
+    }
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    running.store(false);
+    for (auto &queue : queues)
+    {
+        queue->wakeAll();
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    Result result;
+    qint64 totalLatency = 0;
+    qint64 maxLatency = 0;
+    for (int c = 0; c < consumers; ++c)
+    {
+        totalLatency += latencySum[c];
+        maxLatency = std::max(maxLatency, latencyMax[c]);
+    }
+    result.datagramsPerSecond = count / seconds;
+    result.meanLatencyUs = count > 0 ? totalLatency / 1000.0 / count : 0.0;
+    result.maxLatencyUs = maxLatency / 1000.0;
+    return result;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const int saturatedCount = argc > 1 ? std::atoi(argv[1]) : 1000000;
+    const int pacedRate = argc > 2 ? std::atoi(argv[2]) : 5000;
+    const int pacedCount = pacedRate; // One second of paced traffic
+
+    std::printf("%-8s %-10s %16s %16s %16s\n", "threads", "queue", "saturated dg/s", "paced mean us", "paced max us");
+
+    for (int consumers : {1, 2, 4, 8})
+    {
+        const Result mutexSaturated = runPipeline<MutexQueue>(consumers, saturatedCount, 0);
+        const Result mutexPaced = runPipeline<MutexQueue>(consumers, pacedCount, pacedRate);
+        const Result lockFreeSaturated = runPipeline<LockFreeQueue>(consumers, saturatedCount, 0);
+        const Result lockFreePaced = runPipeline<LockFreeQueue>(consumers, pacedCount, pacedRate);
+
+        std::printf("%-8d %-10s %16.0f %16.1f %16.1f\n", consumers, "mutex",
+                    mutexSaturated.datagramsPerSecond, mutexPaced.meanLatencyUs, mutexPaced.maxLatencyUs);
+        std::printf("%-8d %-10s %16.0f %16.1f %16.1f\n", consumers, "lock-free",
+                    lockFreeSaturated.datagramsPerSecond, lockFreePaced.meanLatencyUs, lockFreePaced.maxLatencyUs);
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <Controllers/replayclient.h>
+#include <Controllers/sessionlogformat.h>
+#include <Controllers/telemetrywireformat.h>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTimer>
+#include <QtMath>
+#include <cstdio>
+#include <cstdlib>
+
+/*End-to-end throughput of the telemetry pipeline, driven by an unthrottled replay.
+ * A ReplayClient at speed 0 injects the datagrams of a session log into the parser stage as fast
+ *  as the parsers take them (the "block" overflow policy, so nothing is dropped), and every frame
+ *   runs through sequencing, the snapshot, the history and the GPS track as in the dashboard.
+ *    The clock stops when every datagram has come back as a published or discarded frame, so the
+ *     figure covers reading, dispatch, parsing and publishing, without a network or broker.
+ * Without a log argument a synthetic session of binary frames 1 ms apart is generated first.
+ *
+ * Usage: replay_benchmark [session.cdlog] [parser-threads] [synthetic-frames]
+ */
+
+namespace
+{
+QString writeSyntheticLog(int frames)
+{
+    const QString path = QDir::temp().filePath(QStringLiteral("replay_benchmark.cdlog"));
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return QString();
+    }
+
+    SessionLogFormat::Header header;
+    header.sessionName = QStringLiteral("replay benchmark");
+    file.write(SessionLogFormat::encodeHeader(header));
+
+    QByteArray chunk;
+    char record[SessionLogFormat::RecordHeaderSize + TelemetryWireFormat::FrameSize];
+    for (int i = 0; i < frames; ++i)
+    {
+        const double t = i / 1000.0;
+        TelemetryFrame frame;
+        frame.speed = float(120 + 100 * qSin(t * 0.3));
+        frame.rpm = int(4000 + 3000 * qSin(t * 0.5));
+        frame.accPedal = int(50 + 50 * qSin(t));
+        frame.brakePedal = int(50 - 50 * qSin(t));
+        frame.encoderAngle = 90 * qSin(t * 0.2);
+        frame.temperature = 60.0f;
+        frame.batteryLevel = 80;
+        frame.gpsLongitude = 31.2 + 0.001 * qCos(t * 0.05);
+        frame.gpsLatitude = 30.0 + 0.001 * qSin(t * 0.05);
+        frame.lateralG = 1.5 * qSin(t * 0.7);
+        frame.longitudinalG = 1.0 * qCos(t * 0.4);
+
+        SessionLogFormat::RecordHeader recordHeader;
+        recordHeader.hostTimestampUs = qint64(i) * 1000;
+        recordHeader.arrival = quint64(i) + 1;
+        recordHeader.size = TelemetryWireFormat::FrameSize;
+        SessionLogFormat::encodeRecordHeader(recordHeader, record);
+        TelemetryWireFormat::encode(frame, quint32(i), quint64(i) * 1000, record + SessionLogFormat::RecordHeaderSize);
+
+        chunk.append(record, sizeof(record));
+        if (chunk.size() >= 1 << 20)
+        {
+            file.write(chunk);
+            chunk.clear();
+        }
+    }
+    file.write(chunk);
+    return path;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const int parsers = argc > 2 ? std::max(1, std::atoi(argv[2])) : 0;
+    const int syntheticFrames = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2000000;
+
+    QString path = argc > 1 ? QString::fromLocal8Bit(argv[1]) : QString();
+    if (path.isEmpty())
+    {
+        path = writeSyntheticLog(syntheticFrames);
+        if (path.isEmpty())
+        {
+            std::fprintf(stderr, "cannot write a synthetic log\n");
+            return 1;
+        }
+    }
+
+    ReplayClient client;
+    if (parsers > 0)
+    {
+        client.setParserThreadCount(parsers);
+    }
+    client.setOverflowPolicy(QStringLiteral("block"));
+    client.setSpeed(0.0);
+
+    QElapsedTimer clock;
+    clock.start();
+    if (!client.start(path))
+    {
+        std::fprintf(stderr, "cannot replay %s\n", qPrintable(path));
+        return 1;
+    }
+
+    const qint64 records = client.recordCount();
+    const double megabytes = QFile(path).size() / 1e6;
+    qint64 lastProcessed = -1;
+    QElapsedTimer idle;
+    idle.start();
+
+    // Every datagram ends as a published frame, a stale frame, a rejected datagram or a queue drop
+    QTimer poll;
+    QObject::connect(&poll, &QTimer::timeout, &app, [&]() {
+        const qint64 processed = qint64(client.snapshotVersion()) + client.staleFramesDropped()
+                                 + client.parseErrorTotal() + client.datagramsDropped();
+        if (processed != lastProcessed)
+        {
+            lastProcessed = processed;
+            idle.restart();
+        }
+
+        if (processed < records && idle.elapsed() < 2000)
+        {
+            return;
+        }
+
+        const double seconds = clock.nsecsElapsed() / 1e9;
+        std::printf("%s: %lld datagrams, %.1f MB, %d-%d parsers\n", qPrintable(path), records, megabytes,
+                    client.minimumParsers(), client.maximumParsers());
+        std::printf("%-12s %12s %12s %10s %10s %10s\n", "seconds", "datagrams/s", "MB/s", "published", "stale", "dropped");
+        std::printf("%-12.3f %12.0f %12.1f %10llu %10lld %10lld\n", seconds, processed / seconds, megabytes / seconds,
+                    client.snapshotVersion(), client.staleFramesDropped(), client.datagramsDropped());
+        if (processed < records)
+        {
+            std::printf("stalled: %lld of %lld datagrams accounted for\n", processed, records);
+        }
+
+        client.stop();
+        QCoreApplication::quit();
+    });
+    poll.start(5);
+
+    return app.exec();
+}
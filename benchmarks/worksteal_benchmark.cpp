@@ -0,0 +1,241 @@
+#include <Controllers/eventcount.h>
+#include <Controllers/mpmcqueue.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/*Compares static round-robin assignment with work stealing when one parser is slow.
+ * One producer thread plays the receiver and spreads datagrams round-robin over N consumer
+ *  queues at a fixed telemetry rate. Every consumer spends a fixed time per datagram standing in
+ *  for parsing; consumer 0 additionally stalls every so often, like a thread that is descheduled
+ *  or hits a slow malformed frame. Reported is the dispatch-to-parsed latency distribution:
+ *   - static: each consumer only pops its own queue and sleeps on its own EventCount
+ *   - stealing: an empty consumer pops from its siblings' queues; all sleep on one EventCount
+ *
+ * Usage: worksteal_benchmark [rate-hz] [parse-us] [stall-us] [stall-every]
+ */
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+struct Item
+{
+    qint64 enqueuedNs = 0;
+};
+
+struct Config
+{
+    int consumers = 4;
+    int rateHz = 20000;
+    int count = 40000;
+    int parseUs = 20;
+    int stallUs = 5000;
+    int stallEvery = 50;
+};
+
+struct Consumer
+{
+    Consumer() : queue(8192) {}
+
+    BoundedMpmcQueue<Item> queue;
+    EventCount events;
+};
+
+struct Result
+{
+    double p50Us = 0.0;
+    double p99Us = 0.0;
+    double p999Us = 0.0;
+    double maxUs = 0.0;
+    qint64 steals = 0;
+};
+
+qint64 nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+void spinFor(qint64 ns)
+{
+    const qint64 until = nowNs() + ns;
+    while (nowNs() < until)
+    {
+    }
+}
+
+double percentileUs(const std::vector<qint64> &sorted, double fraction)
+{
+    if (sorted.empty())
+    {
+        return 0.0;
+    }
+    const size_t index = std::min(sorted.size() - 1, size_t(fraction * double(sorted.size())));
+    return sorted[index] / 1000.0;
+}
+
+Result runPipeline(const Config &config, bool stealing)
+{
+    std::vector<std::unique_ptr<Consumer>> consumers;
+    for (int i = 0; i < config.consumers; ++i)
+    {
+        consumers.push_back(std::make_unique<Consumer>());
+    }
+
+    EventCount shared;
+    std::atomic<bool> running(true);
+    std::atomic<int> consumed(0);
+    std::atomic<qint64> steals(0);
+    std::vector<std::vector<qint64>> latencies(size_t(config.consumers));
+    std::vector<std::thread> threads;
+
+    for (int c = 0; c < config.consumers; ++c)
+    {
+        latencies[size_t(c)].reserve(size_t(config.count));
+
+        threads.emplace_back([&, c]() {
+            Consumer &own = *consumers[size_t(c)];
+            EventCount &events = stealing ? shared : own.events;
+            int handled = 0;
+            int nextVictim = c + 1;
+
+            for (;;)
+            {
+                Item item;
+                bool found = own.queue.tryPop(item);
+
+                for (int attempt = 0; stealing && !found && attempt < config.consumers; ++attempt)
+                {
+                    const int victim = (nextVictim + attempt) % config.consumers;
+                    if (victim != c && consumers[size_t(victim)]->queue.tryPop(item))
+                    {
+                        nextVictim = victim;
+                        steals.fetch_add(1, std::memory_order_relaxed);
+                        found = true;
+                    }
+                }
+
+                if (found)
+                {
+                    // The slow consumer stalls before parsing, with the rest of its queue waiting
+                    if (c == 0 && config.stallEvery > 0 && ++handled % config.stallEvery == 0)
+                    {
+                        std::this_thread::sleep_for(std::chrono::microseconds(config.stallUs));
+                    }
+                    spinFor(qint64(config.parseUs) * 1000);
+
+                    latencies[size_t(c)].push_back(nowNs() - item.enqueuedNs);
+                    consumed.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+
+                const quint32 key = events.prepareWait();
+                bool work = !own.queue.isEmpty();
+                for (int i = 0; stealing && !work && i < config.consumers; ++i)
+                {
+                    work = !consumers[size_t(i)]->queue.isEmpty();
+                }
+
+                if (work || !running.load())
+                {
+                    events.cancelWait();
+                    if (!work)
+                    {
+                        return;
+                    }
+                }
+                else
+                {
+                    events.commitWait(key);
+                }
+            }
+        });
+    }
+
+    const auto period = std::chrono::nanoseconds(1000000000LL / config.rateHz);
+    const auto start = Clock::now();
+
+    for (int i = 0; i < config.count; ++i)
+    {
+        const auto due = start + period * i;
+        while (Clock::now() < due)
+        {
+            std::this_thread::yield();
+        }
+
+        Consumer &target = *consumers[size_t(i % config.consumers)];
+        Item item;
+        item.enqueuedNs = nowNs();
+        while (!target.queue.tryPush(item))
+        {
+            std::this_thread::yield();
+        }
+        (stealing ? shared : target.events).notifyOne();
+    }
+
+    while (consumed.load() < config.count)
+    {
+        std::this_thread::yield();
+    }
+
+    running.store(false);
+    shared.notifyAll();
+    for (auto &consumer : consumers)
+    {
+        consumer->events.notifyAll();
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::vector<qint64> all;
+    all.reserve(size_t(config.count));
+    for (const std::vector<qint64> &perConsumer : latencies)
+    {
+        all.insert(all.end(), perConsumer.begin(), perConsumer.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    Result result;
+    result.p50Us = percentileUs(all, 0.50);
+    result.p99Us = percentileUs(all, 0.99);
+    result.p999Us = percentileUs(all, 0.999);
+    result.maxUs = all.empty() ? 0.0 : all.back() / 1000.0;
+    result.steals = steals.load();
+    return result;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Config config;
+    config.rateHz = argc > 1 ? std::max(1, std::atoi(argv[1])) : config.rateHz;
+    config.parseUs = argc > 2 ? std::atoi(argv[2]) : config.parseUs;
+    config.stallUs = argc > 3 ? std::atoi(argv[3]) : config.stallUs;
+    config.stallEvery = argc > 4 ? std::atoi(argv[4]) : config.stallEvery;
+    config.count = config.rateHz * 2; // Two seconds of paced traffic
+
+    std::printf("rate %d Hz, parse %d us, consumer 0 stalls %d us every %d datagrams\n",
+                config.rateHz, config.parseUs, config.stallUs, config.stallEvery);
+    std::printf("%-8s %-10s %12s %12s %12s %12s %10s\n", "threads", "dispatch", "p50 us", "p99 us", "p99.9 us", "max us", "steals");
+
+    for (int consumers : {2, 4, 8})
+    {
+        config.consumers = consumers;
+        const Result roundRobin = runPipeline(config, false);
+        const Result stealing = runPipeline(config, true);
+
+        std::printf("%-8d %-10s %12.1f %12.1f %12.1f %12.1f %10s\n", consumers, "static",
+                    roundRobin.p50Us, roundRobin.p99Us, roundRobin.p999Us, roundRobin.maxUs, "-");
+        std::printf("%-8d %-10s %12.1f %12.1f %12.1f %12.1f %10lld\n", consumers, "stealing",
+                    stealing.p50Us, stealing.p99Us, stealing.p999Us, stealing.maxUs, (long long)stealing.steals);
+    }
+
+    return 0;
+}
@@ -2,18 +2,30 @@
 #include <QQmlApplicationEngine>
 #include <Controllers/udpclient.h>
 #include <Controllers/mqttclient.h>
+#include <Controllers/replayclient.h>
+#include <Controllers/dialgauge.h>
+#include <Controllers/ggdiagram.h>
+#include <Controllers/telemetryhistorymodel.h>
 #include <QQmlContext>
+#include <QQuickWindow>
 
 int main(int argc, char *argv[])
 {
     QGuiApplication app(argc, argv);
 
+    qmlRegisterType<DialGauge>("Car_Dashboard.Telemetry", 1, 0, "DialGauge");
+    qmlRegisterType<GgDiagram>("Car_Dashboard.Telemetry", 1, 0, "GgDiagram");
+    qmlRegisterAnonymousType<TelemetryHistory>("Car_Dashboard.Telemetry", 1);
+    qmlRegisterType<TelemetryHistoryModel>("Car_Dashboard.Telemetry", 1, 0, "TelemetryHistoryModel");
+
     QQmlApplicationEngine engine;
     UdpClient udpClient;
     MqttClient mqttClient;
+    ReplayClient replayClient;
 
     engine.rootContext()->setContextProperty("udpClient", &udpClient);
     engine.rootContext()->setContextProperty("mqttClient", &mqttClient);
+    engine.rootContext()->setContextProperty("replayClient", &replayClient);
 
 
     QObject::connect(
@@ -24,5 +36,16 @@ int main(int argc, char *argv[])
         Qt::QueuedConnection);
     engine.loadFromModule("Car_Dashboard", "Main");
 
+    // Pace property notifications to the display: at most one update per rendered frame
+    if (QQuickWindow *window = engine.rootObjects().isEmpty() ? nullptr : qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst()))
+    {
+        udpClient.setFrameWindow(window);
+        udpClient.setPublishMode(UdpClient::FramePublishing);
+        mqttClient.setFrameWindow(window);
+        mqttClient.setPublishMode(MqttClient::FramePublishing);
+        replayClient.setFrameWindow(window);
+        replayClient.setPublishMode(ReplayClient::FramePublishing);
+    }
+
     return app.exec();
 }
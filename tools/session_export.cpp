@@ -0,0 +1,95 @@
+#include <Controllers/columnarsessionformat.h>
+#include <Controllers/sessionexporter.h>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QDir>
+#include <QFileInfo>
+#include <cstdio>
+
+/*Command-line export of a recorded session to the columnar format.
+ * The conversion streams chunk by chunk, so multi-gigabyte logs export in constant memory;
+ *  progress goes to stderr after every chunk and a summary to stdout at the end.
+ *
+ * Usage: session_export [--from seconds] [--to seconds] [--chunk-rows rows] [--plain] session.cdlog [output.cdcol]
+ */
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("session_export"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Convert a session log into a chunked columnar file."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("log"), QStringLiteral("Session log (.cdlog) to export."));
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Output file; defaults to the log's path with a .cdcol suffix."),
+                                 QStringLiteral("[output]"));
+    const QCommandLineOption fromOption(QStringLiteral("from"), QStringLiteral("Start of the range, in seconds from the first record."),
+                                        QStringLiteral("seconds"));
+    const QCommandLineOption toOption(QStringLiteral("to"), QStringLiteral("End of the range, in seconds from the first record."),
+                                      QStringLiteral("seconds"));
+    const QCommandLineOption chunkOption(QStringLiteral("chunk-rows"), QStringLiteral("Rows per chunk (default %1).")
+                                                                           .arg(SessionExporter::DefaultChunkRows),
+                                         QStringLiteral("rows"));
+    const QCommandLineOption plainOption(QStringLiteral("plain"), QStringLiteral("Store the columns uncompressed."));
+    parser.addOptions({fromOption, toOption, chunkOption, plainOption});
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.isEmpty() || arguments.size() > 2)
+    {
+        parser.showHelp(1);
+    }
+
+    const QString logPath = arguments.at(0);
+    QString outputPath = arguments.value(1);
+    if (outputPath.isEmpty())
+    {
+        const QFileInfo log(logPath);
+        outputPath = log.dir().filePath(log.completeBaseName() + QLatin1String(ColumnarSessionFormat::FileSuffix));
+    }
+
+    SessionExporter::Options options;
+    if (parser.isSet(fromOption))
+    {
+        options.fromUs = qint64(parser.value(fromOption).toDouble() * 1e6);
+    }
+    if (parser.isSet(toOption))
+    {
+        options.toUs = qint64(parser.value(toOption).toDouble() * 1e6);
+    }
+    if (parser.isSet(chunkOption))
+    {
+        options.chunkRows = parser.value(chunkOption).toInt();
+    }
+    options.compress = !parser.isSet(plainOption);
+
+    QElapsedTimer clock;
+    clock.start();
+    SessionExporter exporter;
+    const bool exported = exporter.exportSession(logPath, outputPath, options, [](const SessionExporter::Statistics &statistics) {
+        std::fprintf(stderr, "\r%lld rows, %lld chunks, %.1f MB", statistics.rows, statistics.chunks,
+                     statistics.bytesWritten / 1e6);
+        std::fflush(stderr);
+    });
+    std::fprintf(stderr, "\n");
+
+    if (!exported)
+    {
+        std::fprintf(stderr, "%s\n", qPrintable(exporter.errorString()));
+        return 1;
+    }
+
+    const SessionExporter::Statistics &statistics = exporter.statistics();
+    const double seconds = clock.nsecsElapsed() / 1e9;
+    std::printf("%s: %lld datagrams, %lld rows, %lld rejected, %lld chunks, %.1f MB in %.2f s\n", qPrintable(outputPath),
+                statistics.records, statistics.rows, statistics.rejected, statistics.chunks, statistics.bytesWritten / 1e6,
+                seconds);
+    if (statistics.plainBytes > 0)
+    {
+        std::printf("%.1f MB of column data, %.1fx the file size\n", statistics.plainBytes / 1e6,
+                    double(statistics.plainBytes) / double(statistics.bytesWritten));
+    }
+    return 0;
+}